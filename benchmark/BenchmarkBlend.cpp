@@ -0,0 +1,67 @@
+#include"BenchmarkCommon.h"
+#include<hgl/2d/Blend.h>
+#include<hgl/2d/Blit.h>
+
+/**
+ * 整张位图混合与Blit的速度，象素数按目标位图计
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace bench
+        {
+            namespace
+            {
+                template<typename DT,uint DC,typename ST,uint SC,typename F>
+                void BM_Blend(benchmark::State &state,const F &func)
+                {
+                    const int size=int(state.range(0));
+
+                    Bitmap<ST,SC> src;
+                    Bitmap<DT,DC> dst;
+
+                    if(!src.CreateAligned(size,size)||!dst.CreateAligned(size,size))
+                    {
+                        state.SkipWithError("out of memory");
+                        return;
+                    }
+
+                    FillSynthetic(&src);
+                    FillSynthetic(&dst);
+
+                    for(auto _:state)
+                    {
+                        func(&dst,&src);
+                        benchmark::ClobberMemory();
+                    }
+
+                    SetPixelCounters(state,int64(state.iterations())*size*size,sizeof(DT)+sizeof(ST));
+                }
+
+                template<typename DT,uint DC,typename ST,uint SC,typename F>
+                void RegisterBlend(const char *op,const char *format,const char *mode,const F &func)
+                {
+                    ApplyBitmapSizes(benchmark::RegisterBenchmark(MakeName("Blend",op,format,mode).c_str(),
+                                                                  [func](benchmark::State &state){BM_Blend<DT,DC,ST,SC>(state,func);}));
+                }
+
+                const bool blend_registered=[]
+                {
+                    RegisterBlend<Vector4u8,4,Vector4u8,4>("BlendBitmap","RGBA8toRGBA8","Alpha",[](BitmapRGBA8 *d,const BitmapRGBA8 *s){BlendBitmapRGBA8toRGBA8()(s,d,1.0f);});
+                    RegisterBlend<Vector4u8,4,Vector4u8,4>("BlendBitmap","RGBA8toRGBA8","HalfAlpha",[](BitmapRGBA8 *d,const BitmapRGBA8 *s){BlendBitmapRGBA8toRGBA8()(s,d,0.5f);});
+                    RegisterBlend<Vector3u8,3,Vector4u8,4>("BlendBitmap","RGBA8toRGB8","Alpha",[](BitmapRGB8 *d,const BitmapRGBA8 *s){BlendBitmapRGBA8toRGB8()(s,d,1.0f);});
+                    RegisterBlend<Vector3u8,3,Vector4u8,4>("BlendBitmap","RGBA8toRGB8","HalfAlpha",[](BitmapRGB8 *d,const BitmapRGBA8 *s){BlendBitmapRGBA8toRGB8()(s,d,0.5f);});
+
+                    RegisterBlend<Vector4u8,4,Vector4u8,4>("Blit","RGBA8","Copy",[](BitmapRGBA8 *d,const BitmapRGBA8 *s){Blit(s,nullptr,d,0,0);});
+                    RegisterBlend<Vector4u8,4,Vector4u8,4>("Blit","RGBA8","Alpha",[](BitmapRGBA8 *d,const BitmapRGBA8 *s){Blit(s,nullptr,d,0,0,BlendPolicyAlphaRGBA8());});
+                    RegisterBlend<Vector3u8,3,Vector4u8,4>("Blit","RGBA8toRGB8","Alpha",[](BitmapRGB8 *d,const BitmapRGBA8 *s){Blit(s,nullptr,d,0,0,BlendPolicyAlphaRGBA8());});
+                    RegisterBlend<uint32,1,uint32,1>      ("Blit","U32","Additive",[](BitmapU32 *d,const BitmapU32 *s){Blit(s,nullptr,d,0,0,BlendPolicyAdditiveU32());});
+                    RegisterBlend<Vector4u8,4,Vector3u8,3>("Blit","RGB8toRGBA8","Convert",[](BitmapRGBA8 *d,const BitmapRGB8 *s){Blit(s,nullptr,d,0,0);});
+
+                    return(true);
+                }();
+            }//namespace
+        }//namespace bench
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,92 @@
+#pragma once
+
+#include<benchmark/benchmark.h>
+#include<hgl/2d/Bitmap.h>
+#include<string>
+
+/**
+ * CM2D基准测试公用定义
+ *
+ * 每个测试项都报告bytes_per_second(象素数据量)与pixels_per_second两个速率，名称格式为"类别/操作/象素格式/方式"，最后为尺寸参数。
+ * 以--benchmark_format=json或--benchmark_out=file.json --benchmark_out_format=json运行即可得到可供比较的JSON结果。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace bench
+        {
+            /**
+             * 为测试项加入标准的位图尺寸参数(正方形边长)
+             */
+            template<typename B>
+            inline B *ApplyBitmapSizes(B *b)
+            {
+                return b->ArgName("size")->Arg(256)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
+            }
+
+            /**
+             * 记录处理的象素总数
+             * @param pixels 全部迭代处理的象素总数
+             * @param pixel_bytes 每象素字节数
+             */
+            inline void SetPixelCounters(benchmark::State &state,const int64 pixels,const int64 pixel_bytes)
+            {
+                state.counters["pixels_per_second"]=benchmark::Counter(double(pixels),benchmark::Counter::kIsRate);
+                state.SetBytesProcessed(pixels*pixel_bytes);
+            }
+
+            template<typename T> struct PixelTraits;
+
+            template<> struct PixelTraits<uint8>
+            {
+                static constexpr uint CHANNELS=1;
+                static const char *GetName(){return "Grey8";}
+                static uint8 MakeColor(const uint8 v){return v;}
+            };
+
+            template<> struct PixelTraits<uint32>
+            {
+                static constexpr uint CHANNELS=1;
+                static const char *GetName(){return "U32";}
+                static uint32 MakeColor(const uint8 v){return uint32(v)*0x01010101u;}
+            };
+
+            template<> struct PixelTraits<Vector3u8>
+            {
+                static constexpr uint CHANNELS=3;
+                static const char *GetName(){return "RGB8";}
+                static Vector3u8 MakeColor(const uint8 v){return Vector3u8(v,uint8(v>>1),uint8(255-v));}
+            };
+
+            template<> struct PixelTraits<Vector4u8>
+            {
+                static constexpr uint CHANNELS=4;
+                static const char *GetName(){return "RGBA8";}
+                static Vector4u8 MakeColor(const uint8 v){return Vector4u8(v,uint8(v>>1),uint8(255-v),uint8(v|0x40));}
+            };
+
+            /**
+             * 以渐变与色块交替的内容填充位图，使RLE压缩与混合都有接近实际图片的数据
+             */
+            template<typename T,uint C>
+            inline void FillSynthetic(BitmapView<T,C> *bmp)
+            {
+                const T block=PixelTraits<T>::MakeColor(200);
+
+                for(int y=0;y<bmp->GetHeight();y++)
+                {
+                    T *p=bmp->GetLine(y);
+
+                    for(int x=0;x<bmp->GetWidth();x++)
+                        p[x]=(((x>>4)+(y>>4))&1)?block:PixelTraits<T>::MakeColor(uint8(x+y));
+                }
+            }
+
+            inline std::string MakeName(const char *category,const char *op,const char *format,const char *mode)
+            {
+                return std::string(category)+"/"+op+"/"+format+"/"+mode;
+            }
+        }//namespace bench
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,268 @@
+#include"BenchmarkCommon.h"
+#include<hgl/2d/DrawGeometry.h>
+#include<vector>
+
+/**
+ * DrawGeometry各图元的绘制速度
+ *
+ * 每次迭代在size x size的位图上绘制一组图元，返回的象素数为实际覆盖象素的估计值(圆周按4√2·r计)。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace bench
+        {
+            namespace
+            {
+                constexpr int LINE_COUNT=64;
+                constexpr int CIRCLE_COUNT=16;
+
+                constexpr double BENCH_PI=3.14159265358979323846;
+                constexpr double BENCH_SQRT2=1.41421356237309504880;
+
+                struct PrimHLine
+                {
+                    static const char *GetName(){return "HLine";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        for(int y=0;y<size;y++)
+                            dg.DrawHLine(0,y,size);
+
+                        return int64(size)*size;
+                    }
+                };
+
+                struct PrimVLine
+                {
+                    static const char *GetName(){return "VLine";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        for(int x=0;x<size;x++)
+                            dg.DrawVLine(x,0,size);
+
+                        return int64(size)*size;
+                    }
+                };
+
+                struct PrimBar
+                {
+                    static const char *GetName(){return "Bar";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        dg.DrawBar(0,0,size,size);
+
+                        return int64(size)*size;
+                    }
+                };
+
+                struct PrimLine
+                {
+                    static const char *GetName(){return "Line";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        //从左上角出发的扇形线束，每条线的主方向长度都是size
+                        for(int i=0;i<LINE_COUNT;i++)
+                        {
+                            const int d=(size-1)*i/(LINE_COUNT-1);
+
+                            dg.DrawLine(0,0,d,size-1);
+                            dg.DrawLine(0,0,size-1,d);
+                        }
+
+                        return int64(LINE_COUNT)*2*size;
+                    }
+                };
+
+                struct PrimWireCircle
+                {
+                    static const char *GetName(){return "WireCircle";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        const int c=size/2;
+                        int64 pixels=0;
+
+                        for(int i=0;i<CIRCLE_COUNT;i++)
+                        {
+                            const int r=(c-1)*(i+1)/CIRCLE_COUNT;
+
+                            dg.DrawWireCircle(c,c,r);
+                            pixels+=int64(r*4*BENCH_SQRT2);
+                        }
+
+                        return pixels;
+                    }
+                };
+
+                struct PrimSolidCircle
+                {
+                    static const char *GetName(){return "SolidCircle";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        const int r=size/2-1;
+
+                        dg.DrawSolidCircle(size/2,size/2,r);
+
+                        return int64(BENCH_PI*r*r);
+                    }
+                };
+
+                struct PrimSolidSector
+                {
+                    static const char *GetName(){return "SolidSector";}
+
+                    void Prepare(const int){}
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        const int r=size/2-1;
+
+                        dg.DrawSolidSector(size/2,size/2,r,30,300);
+
+                        return int64(BENCH_PI*r*r*270/360);
+                    }
+                };
+
+                struct PrimMonoBitmap
+                {
+                    std::vector<uint8> data;
+
+                    static const char *GetName(){return "MonoBitmap";}
+
+                    void Prepare(const int size)
+                    {
+                        //各行的位数据连续存放，0x5A与0xF0交替使一行中既有单个象素也有连续的象素
+                        data.resize((size_t(size)*size+7)/8);
+
+                        for(size_t i=0;i<data.size();i++)
+                            data[i]=(i&1)?0xF0:0x5A;
+                    }
+
+                    template<typename DG> int64 operator()(DG &dg,const int size)
+                    {
+                        dg.DrawMonoBitmap(0,0,data.data(),size,size);
+
+                        return int64(size)*size;
+                    }
+                };
+
+                template<typename T,uint C,typename BP> using BenchDG=DrawGeometry<T,Bitmap<T,C>,BP>;
+
+                template<typename T,uint C,typename BP,typename PRIM>
+                void BM_Draw(benchmark::State &state,void (*setup)(BenchDG<T,C,BP> &))
+                {
+                    const int size=int(state.range(0));
+
+                    Bitmap<T,C> bmp;
+
+                    if(!bmp.CreateAligned(size,size))
+                    {
+                        state.SkipWithError("out of memory");
+                        return;
+                    }
+
+                    bmp.ClearColor(PixelTraits<T>::MakeColor(0));
+
+                    BenchDG<T,C,BP> dg(&bmp);
+
+                    dg.SetDrawColor(PixelTraits<T>::MakeColor(128));
+
+                    if(setup)
+                        setup(dg);
+
+                    PRIM prim;
+
+                    prim.Prepare(size);
+
+                    int64 pixels=0;
+
+                    for(auto _:state)
+                    {
+                        pixels+=prim(dg,size);
+                        benchmark::ClobberMemory();
+                    }
+
+                    SetPixelCounters(state,pixels,sizeof(T));
+                }
+
+                template<typename T,uint C,typename BP,typename PRIM>
+                void RegisterDraw(const char *mode,void (*setup)(BenchDG<T,C,BP> &))
+                {
+                    ApplyBitmapSizes(benchmark::RegisterBenchmark(MakeName("Draw",PRIM::GetName(),PixelTraits<T>::GetName(),mode).c_str(),
+                                                                  BM_Draw<T,C,BP,PRIM>,setup));
+                }
+
+                /**
+                 * 注册一种象素格式与混合方式下的全部图元
+                 */
+                template<typename T,uint C,typename BP>
+                void RegisterDrawAll(const char *mode,void (*setup)(BenchDG<T,C,BP> &)=nullptr)
+                {
+                    RegisterDraw<T,C,BP,PrimHLine      >(mode,setup);
+                    RegisterDraw<T,C,BP,PrimVLine      >(mode,setup);
+                    RegisterDraw<T,C,BP,PrimBar        >(mode,setup);
+                    RegisterDraw<T,C,BP,PrimLine       >(mode,setup);
+                    RegisterDraw<T,C,BP,PrimWireCircle >(mode,setup);
+                    RegisterDraw<T,C,BP,PrimSolidCircle>(mode,setup);
+                    RegisterDraw<T,C,BP,PrimSolidSector>(mode,setup);
+                    RegisterDraw<T,C,BP,PrimMonoBitmap >(mode,setup);
+                }
+
+                void SetupAdditiveU32(BenchDG<uint32,1,BlendPolicyDynamic<uint32>> &dg)
+                {
+                    static BlendColorU32Additive bc;
+
+                    dg.SetBlend(&bc);
+                }
+
+                void SetupAlphaRGBA8(BenchDG<Vector4u8,4,BlendPolicyDynamic<Vector4u8>> &dg)
+                {
+                    static BlendColorRGBA8 bc;
+
+                    dg.SetBlend(&bc);
+                }
+
+                void SetupHalfAlphaRGBA8(BenchDG<Vector4u8,4,BlendPolicyAlphaRGBA8> &dg)
+                {
+                    dg.SetAlpha(0.5f);
+                }
+
+                const bool draw_registered=[]
+                {
+                    //"Opaque"与"Additive"/"Alpha"为静态策略(可内联)，"Dynamic"前缀为通过BlendColor虚函数混合
+                    RegisterDrawAll<uint32,1,BlendPolicyOpaque<uint32>>     ("Opaque");
+                    RegisterDrawAll<uint32,1,BlendPolicyAdditiveU32>        ("Additive");
+                    RegisterDrawAll<uint32,1,BlendPolicyDynamic<uint32>>    ("DynamicAdditive",SetupAdditiveU32);
+
+                    RegisterDrawAll<Vector3u8,3,BlendPolicyOpaque<Vector3u8>>  ("Opaque");
+                    RegisterDrawAll<Vector3u8,3,BlendPolicyDynamic<Vector3u8>> ("DynamicNone");
+
+                    RegisterDrawAll<Vector4u8,4,BlendPolicyOpaque<Vector4u8>>  ("Opaque");
+                    RegisterDrawAll<Vector4u8,4,BlendPolicyAlphaRGBA8>         ("Alpha");
+                    RegisterDrawAll<Vector4u8,4,BlendPolicyAlphaRGBA8>         ("HalfAlpha",SetupHalfAlphaRGBA8);
+                    RegisterDrawAll<Vector4u8,4,BlendPolicyDynamic<Vector4u8>> ("DynamicAlpha",SetupAlphaRGBA8);
+
+                    return(true);
+                }();
+            }//namespace
+        }//namespace bench
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,135 @@
+#include"BenchmarkCommon.h"
+#include<hgl/2d/BitmapLoad.h>
+#include<hgl/2d/BitmapSave.h>
+#include<filesystem>
+
+/**
+ * TGA载入与保存的速度
+ *
+ * 使用临时目录中的文件，通常会命中系统文件缓存，所以结果主要反映编解码与内存复制的开销。字节数按未压缩的象素数据计。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace bench
+        {
+            namespace
+            {
+                const std::filesystem::path GetTempFile(const std::string &name)
+                {
+                    std::string filename="cm2d_benchmark_"+name+".tga";
+
+                    for(char &ch:filename)
+                        if(ch=='/')ch='_';
+
+                    return std::filesystem::temp_directory_path()/filename;
+                }
+
+                template<typename T,uint C>
+                void BM_SaveTGA(benchmark::State &state,const bool rle,const std::string &name)
+                {
+                    const int size=int(state.range(0));
+                    const std::filesystem::path path=GetTempFile(name);
+
+                    Bitmap<T,C> bmp;
+
+                    if(!bmp.Create(size,size))
+                    {
+                        state.SkipWithError("out of memory");
+                        return;
+                    }
+
+                    FillSynthetic(&bmp);
+
+                    TGASaveOption option;
+
+                    option.rle=rle;
+
+                    for(auto _:state)
+                    {
+                        if(!SaveBitmapToTGA(OSString(path.c_str()),(const BitmapView<T,C> *)&bmp,option))
+                        {
+                            state.SkipWithError("save failed");
+                            break;
+                        }
+                    }
+
+                    std::filesystem::remove(path);
+
+                    SetPixelCounters(state,int64(state.iterations())*size*size,sizeof(T));
+                }
+
+                template<typename T,uint C>
+                void BM_LoadTGA(benchmark::State &state,const bool rle,const std::string &name)
+                {
+                    const int size=int(state.range(0));
+                    const std::filesystem::path path=GetTempFile(name);
+
+                    {
+                        Bitmap<T,C> src;
+
+                        if(!src.Create(size,size))
+                        {
+                            state.SkipWithError("out of memory");
+                            return;
+                        }
+
+                        FillSynthetic(&src);
+
+                        TGASaveOption option;
+
+                        option.rle=rle;
+
+                        if(!SaveBitmapToTGA(OSString(path.c_str()),(const BitmapView<T,C> *)&src,option))
+                        {
+                            state.SkipWithError("save failed");
+                            return;
+                        }
+                    }
+
+                    Bitmap<T,C> bmp;                                            //尺寸不变，各次载入复用同一块内存
+
+                    for(auto _:state)
+                    {
+                        if(!LoadBitmapFromTGA(OSString(path.c_str()),&bmp))
+                        {
+                            state.SkipWithError("load failed");
+                            break;
+                        }
+                    }
+
+                    std::filesystem::remove(path);
+
+                    SetPixelCounters(state,int64(state.iterations())*size*size,sizeof(T));
+                }
+
+                template<typename T,uint C>
+                void RegisterTGA()
+                {
+                    const char *format=PixelTraits<T>::GetName();
+
+                    for(const bool rle:{false,true})
+                    {
+                        const char *mode=rle?"RLE":"Raw";
+
+                        const std::string save_name=MakeName("TGA","Save",format,mode);
+                        const std::string load_name=MakeName("TGA","Load",format,mode);
+
+                        ApplyBitmapSizes(benchmark::RegisterBenchmark(save_name.c_str(),BM_SaveTGA<T,C>,rle,save_name));
+                        ApplyBitmapSizes(benchmark::RegisterBenchmark(load_name.c_str(),BM_LoadTGA<T,C>,rle,load_name));
+                    }
+                }
+
+                const bool tga_registered=[]
+                {
+                    RegisterTGA<uint8,1>();
+                    RegisterTGA<Vector3u8,3>();
+                    RegisterTGA<Vector4u8,4>();
+
+                    return(true);
+                }();
+            }//namespace
+        }//namespace bench
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,169 @@
+#pragma once
+
+#include<hgl/2d/BitmapLoad.h>
+#include<condition_variable>
+#include<functional>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 异步批量文件载入基类<br>
+         * 多个工作线程各自读取并解码一个文件，这样同时有多个读取在进行，读取与解码也互相重叠。<br>
+         * 通过AcquireBytes/ReleaseBytes限制同时处理中的数据量。
+         */
+        class AsyncBatchLoader
+        {
+            std::vector<std::thread> workers;
+
+            mutable std::mutex lock;
+            std::condition_variable job_cv;                                     ///<有新任务或退出
+            std::condition_variable done_cv;                                    ///<一批任务完成
+            std::condition_variable bytes_cv;                                   ///<有数据量释放
+
+            std::vector<OSString> filename_list;
+            uint next_job;
+            uint finished_count;
+            bool cancel;
+            bool quit;
+
+            uint64 max_bytes;
+            uint64 bytes_in_flight;
+
+        private:
+
+            void WorkerProc();
+
+        protected:
+
+            /**
+             * 申请数据量，超出限制时等待其它文件处理完成。没有其它文件在处理时总是立即成功。
+             * @return 批处理被取消时返回false
+             */
+            bool AcquireBytes(const uint64 bytes);
+            void ReleaseBytes(const uint64 bytes);
+
+            /**
+             * 在工作线程中载入一个文件
+             */
+            virtual void LoadFile(const uint index,const OSString &filename)=0;
+
+            void StopWorkers();                                                 ///<派生类析构时须先调用
+
+        public:
+
+            /**
+             * @param thread_count 工作线程数，为0时为CPU核心数
+             * @param max_bytes_in_flight 同时处理中的最大数据量
+             */
+            AsyncBatchLoader(uint thread_count=0,const uint64 max_bytes_in_flight=uint64(256)*1024*1024);
+            virtual ~AsyncBatchLoader();
+
+            /**
+             * 开始载入一批文件，立即返回
+             * @return 上一批尚未完成或列表为空时返回false
+             */
+            bool Start(const std::vector<OSString> &filenames);
+
+            void Wait();                                                        ///<等待当前批次完成
+            void Cancel();                                                      ///<放弃尚未开始的文件，并等待进行中的完成
+
+            const bool IsFinished()const;
+            const uint GetFinishedCount()const;
+            const uint GetThreadCount()const{return uint(workers.size());}
+        };//class AsyncBatchLoader
+
+        /**
+         * 异步批量TGA位图载入器
+         */
+        template<typename T> class AsyncBitmapLoader:public AsyncBatchLoader
+        {
+        public:
+
+            /**
+             * 载入完成回调，在工作线程中调用
+             * @param index 文件在列表中的序号
+             * @param filename 文件名
+             * @param bmp 载入的位图，由接收者负责删除。载入失败时为nullptr
+             */
+            using Callback=std::function<void(const uint index,const OSString &filename,T *bmp)>;
+
+        protected:
+
+            Callback callback;
+
+            /**
+             * 在得知图片尺寸后申请数据量
+             */
+            struct BudgetLoader:public BitmapLoaderImpl<T>
+            {
+                AsyncBitmapLoader<T> *owner;
+                uint64 reserved=0;
+
+            public:
+
+                BudgetLoader(AsyncBitmapLoader<T> *abl){owner=abl;}
+
+                bool OnRecvBitmap(uint w,uint h) override
+                {
+                    reserved=uint64(w)*h*sizeof(typename T::PixelType);
+
+                    if(!owner->AcquireBytes(reserved))
+                    {
+                        reserved=0;
+                        return(false);
+                    }
+
+                    return BitmapLoaderImpl<T>::OnRecvBitmap(w,h);
+                }
+            };//struct BudgetLoader
+
+            static bool LoadTGA(const OSString &filename,BudgetLoader &bl)
+            {
+                io::OpenFileInputStream fis(filename);
+
+                if(!fis)
+                    return(false);
+
+                return LoadBitmapFromTGAStream(&fis,&bl);
+            }
+
+            void LoadFile(const uint index,const OSString &filename) override
+            {
+                BudgetLoader bl(this);
+                T *bmp=nullptr;
+
+                if(LoadTGA(filename,bl))
+                    bmp=bl.Detach();
+
+                if(callback)
+                    callback(index,filename,bmp);
+                else
+                    delete bmp;
+
+                if(bl.reserved)
+                    ReleaseBytes(bl.reserved);
+            }
+
+        public:
+
+            AsyncBitmapLoader(const Callback &cb,uint thread_count=0,const uint64 max_bytes_in_flight=uint64(256)*1024*1024)
+                :AsyncBatchLoader(thread_count,max_bytes_in_flight)
+            {
+                callback=cb;
+            }
+
+            ~AsyncBitmapLoader() override
+            {
+                StopWorkers();
+            }
+        };//template<typename T> class AsyncBitmapLoader
+
+        using AsyncBitmapLoaderRGB8=AsyncBitmapLoader<BitmapRGB8>;
+        using AsyncBitmapLoaderRGBA8=AsyncBitmapLoader<BitmapRGBA8>;
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,158 @@
+#pragma once
+
+#include<hgl/2d/BitmapSave.h>
+#include<condition_variable>
+#include<deque>
+#include<functional>
+#include<mutex>
+#include<thread>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 后台TGA保存器<br>
+         * Save接管位图数据后立即返回，由后台线程完成压缩与写入，适合截图或逐帧输出。<br>
+         * 等待保存的图片达到max_pending张时Save会等待，以限制占用的内存。
+         */
+        class AsyncTGASaver
+        {
+        public:
+
+            /**
+             * 保存完成回调，在后台线程中调用
+             */
+            using Callback=std::function<void(const OSString &filename,const bool result)>;
+
+        private:
+
+            struct Job
+            {
+                OSString filename;
+
+                void *data;
+                size_t data_bytes;
+                BitmapAllocator *allocator;                                     ///<释放data所用的分配器
+
+                uint width,height;
+                uint channels,channel_bits;
+                uint line_bytes;
+                bool bottom_up;                                                 ///<data是否从下往上存放
+            };
+
+            TGASaveOption option;
+            Callback callback;
+
+            BitmapPool copy_pool;                                               ///<SaveCopy所用的缓冲区
+
+            std::thread worker;
+
+            mutable std::mutex lock;
+            std::condition_variable job_cv;                                     ///<有新任务或退出
+            std::condition_variable done_cv;                                    ///<有任务完成
+
+            std::deque<Job> job_list;
+            uint max_pending;
+            bool busy;                                                          ///<后台线程正在保存
+            bool quit;
+
+            uint saved_count;
+            uint failed_count;
+
+        private:
+
+            void WorkerProc();
+            bool SaveJob(const Job &job);
+            void Push(Job &&job);
+
+        public:
+
+            /**
+             * @param opt 保存选项，其中task_pool可为nullptr
+             * @param max_pending 最多等待保存的图片数量，为0时不限制
+             * @param cb 保存完成回调，可为nullptr
+             */
+            AsyncTGASaver(const TGASaveOption &opt=TGASaveOption(),const uint max_pending=4,const Callback &cb=nullptr);
+            ~AsyncTGASaver();                                                   ///<等待全部保存完成
+
+            /**
+             * 接管位图数据并在后台保存，bmp随后变为空<br>
+             * 从下往上存放的位图按左下角原点保存，不需要翻转。
+             */
+            template<typename T,uint C>
+            bool Save(const OSString &filename,Bitmap<T,C> *bmp)
+            {
+                if(filename.IsEmpty()||!bmp||bmp->IsEmpty())
+                    return(false);
+
+                Job job;
+
+                job.filename    =filename;
+                job.data_bytes  =bmp->GetDataBytes();
+                job.allocator   =bmp->GetAllocator();
+                job.width       =bmp->GetWidth();
+                job.height      =bmp->GetHeight();
+                job.channels    =C;
+                job.channel_bits=bmp->GetChannelBits();
+                job.line_bytes  =bmp->GetLineBytes();
+                job.bottom_up   =bmp->IsBottomUp();
+                job.data        =bmp->Release();
+
+                Push(std::move(job));
+                return(true);
+            }
+
+            /**
+             * 复制位图数据并在后台保存，返回后view即可被修改<br>
+             * 复制所用的缓冲区会被缓存复用，连续保存相同尺寸的图片时不会反复分配。
+             */
+            template<typename T,uint C>
+            bool SaveCopy(const OSString &filename,const BitmapView<T,C> *view)
+            {
+                if(filename.IsEmpty()||!view||view->IsEmpty())
+                    return(false);
+
+                const uint row_bytes=view->GetWidth()*sizeof(T);
+
+                Job job;
+
+                job.filename    =filename;
+                job.data_bytes  =size_t(row_bytes)*view->GetHeight();
+                job.allocator   =&copy_pool;
+                job.width       =view->GetWidth();
+                job.height      =view->GetHeight();
+                job.channels    =C;
+                job.channel_bits=view->GetChannelBits();
+                job.line_bytes  =row_bytes;
+                job.bottom_up   =false;
+                job.data        =copy_pool.Alloc(job.data_bytes);
+
+                if(!job.data)
+                    return(false);
+
+                if(view->IsContinuous())
+                    memcpy(job.data,view->GetData(),job.data_bytes);
+                else
+                {
+                    uint8 *p=(uint8 *)job.data;
+
+                    for(int y=0;y<view->GetHeight();y++)
+                    {
+                        memcpy(p,view->GetLine(y),row_bytes);
+                        p+=row_bytes;
+                    }
+                }
+
+                Push(std::move(job));
+                return(true);
+            }
+
+            void Flush();                                                       ///<等待全部保存完成
+
+            const uint GetPendingCount()const;                                  ///<取得尚未完成的图片数量(含正在保存的)
+            const uint GetSavedCount()const;
+            const uint GetFailedCount()const;
+        };//class AsyncTGASaver
+    }//namespace bitmap
+}//namespace hgl
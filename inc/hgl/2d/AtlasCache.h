@@ -0,0 +1,477 @@
+#pragma once
+
+#include<hgl/2d/Bitmap.h>
+#include<hgl/2d/AtlasPacker.h>
+#include<hgl/2d/DirtyRegion.h>
+#include<hgl/2d/GlyphBitmap.h>
+#include<unordered_map>
+#include<algorithm>
+#include<cstdint>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 图集中的一项
+         */
+        struct AtlasEntry
+        {
+            uint page;                                                          ///<所在页
+            int x,y;                                                            ///<在页中的位置(不含边距)
+            int width,height;
+
+            uint64 last_use;                                                    ///<最后一次使用的时间戳
+        };//struct AtlasEntry
+
+        /**
+         * 图集缓存<br>
+         * 把解码后的精灵图、光栅化后的字形等小图按64位ID存放在若干张固定尺寸的大位图(页)中，每页用天际线装箱器分配空间。<br>
+         * 内存上限为budget字节，页数达到上限而又放不下新项时，整页淘汰最久没有使用的一页(LRU)。
+         * 调用NewFrame后，此后被使用过的页在本帧内不会被淘汰，所以同一帧之内取得的视图都保持有效；
+         * 所有页都在本帧内使用过时Insert/Allocate失败。<br>
+         * 每页记录被写入的范围(GetPageDirty)，供上传到GPU纹理等用途。本类不能被多个线程同时使用。
+         */
+        template<typename T,uint C> class AtlasCache
+        {
+        public:
+
+            using View=BitmapView<T,C>;
+            using PageBitmap=Bitmap<T,C>;
+
+        protected:
+
+            struct Page
+            {
+                PageBitmap bitmap;
+                SkylinePacker packer;
+                DirtyRegion dirty;
+
+                std::vector<uint64> id_list;                                    ///<此页中各项的ID
+                uint live_count=0;
+                uint64 last_use=0;
+
+            public:
+
+                Page(BitmapAllocator *ba):bitmap(ba){}
+            };
+
+            std::vector<Page *> page_list;
+
+            std::unordered_map<uint64,AtlasEntry> entry_map;
+
+            int page_width,page_height;
+            int padding;                                                        ///<每项四周以clear_color填充的边距，避免采样时混入相邻项
+
+            size_t budget_bytes;
+            uint max_pages;
+
+            T clear_color;
+
+            uint64 use_clock;
+            uint64 frame_mark;                                                  ///<最后一次NewFrame时的时间戳
+
+            uint64 hit_count,miss_count,evict_count;
+
+            BitmapAllocator *allocator;
+
+        protected:
+
+            const size_t GetPageBytes()const{return size_t(page_width)*size_t(page_height)*sizeof(T);}
+
+            /**
+             * 清除一页中的所有项
+             */
+            void EvictPage(const uint index)
+            {
+                Page *page=page_list[index];
+
+                for(const uint64 id:page->id_list)
+                {
+                    auto it=entry_map.find(id);
+
+                    if(it!=entry_map.end()&&it->second.page==index)
+                        entry_map.erase(it);
+                }
+
+                page->id_list.clear();
+                page->live_count=0;
+                page->packer.Reset();
+
+                ++evict_count;
+            }
+
+            /**
+             * 删除一页，最后一页移到它的位置
+             */
+            void DeletePage(const uint index)
+            {
+                EvictPage(index);
+
+                delete page_list[index];
+
+                const uint last=uint(page_list.size()-1);
+
+                if(index!=last)
+                {
+                    page_list[index]=page_list[last];
+
+                    for(const uint64 id:page_list[index]->id_list)
+                    {
+                        auto it=entry_map.find(id);
+
+                        if(it!=entry_map.end()&&it->second.page==last)
+                            it->second.page=index;
+                    }
+                }
+
+                page_list.pop_back();
+            }
+
+            Page *CreatePage()
+            {
+                Page *page=new Page(allocator);
+
+                if(!page->bitmap.Create(page_width,page_height))
+                {
+                    delete page;
+                    return(nullptr);
+                }
+
+                page->packer.Init(page_width,page_height);
+                page->dirty.SetBounds(page_width,page_height);
+
+                page_list.push_back(page);
+                return page;
+            }
+
+            /**
+             * 找出可以淘汰的最久没有使用的一页
+             * @return 没有可以淘汰的页时返回-1
+             */
+            int FindVictim()const
+            {
+                int result=-1;
+                uint64 oldest=UINT64_MAX;
+
+                for(uint i=0;i<page_list.size();i++)
+                {
+                    const uint64 lu=page_list[i]->last_use;
+
+                    if(frame_mark!=UINT64_MAX&&lu>frame_mark)continue;          //本帧内使用过
+
+                    if(lu<oldest)
+                    {
+                        oldest=lu;
+                        result=int(i);
+                    }
+                }
+
+                return result;
+            }
+
+            /**
+             * 分配一块含边距的空间，并以clear_color填充<br>
+             * 找到空间后才移除同ID的旧项，放不下时旧项保持不变
+             */
+            AtlasEntry *AllocEntry(const uint64 id,const int w,const int h)
+            {
+                if(!page_width)return(nullptr);                                 //尚未Init
+                if(w<=0||h<=0)return(nullptr);
+
+                const int pw=w+padding*2;
+                const int ph=h+padding*2;
+
+                if(pw>page_width||ph>page_height)return(nullptr);
+
+                int px,py;
+                int index=-1;
+
+                for(uint i=0;i<page_list.size();i++)
+                    if(page_list[i]->packer.Insert(pw,ph,&px,&py))
+                    {
+                        index=int(i);
+                        break;
+                    }
+
+                if(index<0)
+                {
+                    if(page_list.size()<max_pages)
+                    {
+                        if(!CreatePage())return(nullptr);
+
+                        index=int(page_list.size()-1);
+                    }
+                    else
+                    {
+                        index=FindVictim();
+
+                        if(index<0)return(nullptr);
+
+                        EvictPage(index);
+                    }
+
+                    if(!page_list[index]->packer.Insert(pw,ph,&px,&py))
+                        return(nullptr);
+                }
+
+                Page *page=page_list[index];
+
+                ++page->live_count;                                             //先计入新项，旧项在同一页时移除它不会重置装箱器
+
+                Remove(id);
+
+                for(int row=0;row<ph;row++)
+                    FillPixels<T>(page->bitmap.GetData(px,py+row),clear_color,pw);
+
+                page->dirty.Add(px,py,px+pw,py+ph);
+                page->id_list.push_back(id);
+
+                AtlasEntry &entry=entry_map[id];
+
+                entry.page=uint(index);
+                entry.x=px+padding;
+                entry.y=py+padding;
+                entry.width=w;
+                entry.height=h;
+
+                Touch(entry);
+                return &entry;
+            }
+
+            void Touch(AtlasEntry &entry)
+            {
+                entry.last_use=++use_clock;
+                page_list[entry.page]->last_use=entry.last_use;
+            }
+
+        public:
+
+            AtlasCache(BitmapAllocator *ba=nullptr)
+            {
+                page_width=page_height=0;
+                padding=0;
+                budget_bytes=0;
+                max_pages=0;
+                hgl_zero(clear_color);
+                use_clock=0;
+                frame_mark=UINT64_MAX;
+                hit_count=miss_count=evict_count=0;
+                allocator=ba?ba:GetDefaultBitmapAllocator();
+            }
+
+            AtlasCache(const AtlasCache &)=delete;
+            AtlasCache &operator=(const AtlasCache &)=delete;
+
+            ~AtlasCache()
+            {
+                Clear();
+            }
+
+            /**
+             * 初始化图集，已有的内容会被清除
+             * @param pw 每页宽
+             * @param ph 每页高
+             * @param budget 内存上限(字节)，至少可以有一页
+             * @param pad 每项四周的边距
+             * @param cc 清除色，用于填充边距和新分配的空间
+             */
+            bool Init(const int pw,const int ph,const size_t budget,const int pad,const T &cc)
+            {
+                Clear();
+
+                if(pw<=0||ph<=0||pad<0)return(false);
+
+                page_width=pw;
+                page_height=ph;
+                padding=pad;
+                clear_color=cc;
+
+                SetBudget(budget);
+                return(true);
+            }
+
+            /**
+             * 修改内存上限，超出的部分按LRU整页释放
+             */
+            void SetBudget(const size_t budget)
+            {
+                budget_bytes=budget;
+
+                const size_t pb=GetPageBytes();
+
+                max_pages=pb?uint(budget/pb):0;
+
+                if(max_pages<1)max_pages=1;
+
+                while(page_list.size()>max_pages)
+                {
+                    int index=FindVictim();
+
+                    if(index<0)index=0;                                         //上限优先于本帧保护
+
+                    DeletePage(index);
+                }
+            }
+
+            /**
+             * 清除所有项并释放所有页
+             */
+            void Clear()
+            {
+                for(Page *page:page_list)
+                    delete page;
+
+                page_list.clear();
+                entry_map.clear();
+            }
+
+            /**
+             * 开始新的一帧，此后使用过的页在下一次NewFrame之前不会被淘汰
+             */
+            void NewFrame()
+            {
+                frame_mark=use_clock;
+            }
+
+            /**
+             * 查找一项并更新其使用时间
+             * @return 没有找到时返回nullptr
+             */
+            const AtlasEntry *Find(const uint64 id)
+            {
+                auto it=entry_map.find(id);
+
+                if(it==entry_map.end())
+                {
+                    ++miss_count;
+                    return(nullptr);
+                }
+
+                ++hit_count;
+                Touch(it->second);
+                return &(it->second);
+            }
+
+            bool Find(const uint64 id,View *view)
+            {
+                const AtlasEntry *entry=Find(id);
+
+                if(!entry)return(false);
+
+                if(view)*view=GetView(*entry);
+                return(true);
+            }
+
+            const bool Contains(const uint64 id)const{return entry_map.find(id)!=entry_map.end();}
+
+            /**
+             * 分配一块以clear_color清除的空间，调用者通过GetView直接写入(如光栅化字形)。已有同ID的项会被替换。
+             * @return 放不下时返回nullptr，已有同ID的项保持不变
+             */
+            const AtlasEntry *Allocate(const uint64 id,const int w,const int h)
+            {
+                return AllocEntry(id,w,h);
+            }
+
+            /**
+             * 复制一张位图到图集中，已有同ID的项会被替换
+             * @return 放不下时返回nullptr，已有同ID的项保持不变
+             */
+            const AtlasEntry *Insert(const uint64 id,const View &src)
+            {
+                if(src.IsEmpty())return(nullptr);
+
+                AtlasEntry *entry=AllocEntry(id,src.GetWidth(),src.GetHeight());
+
+                if(!entry)return(nullptr);
+
+                PageBitmap &bmp=page_list[entry->page]->bitmap;
+
+                const size_t line_bytes=size_t(entry->width)*sizeof(T);
+
+                for(int row=0;row<entry->height;row++)
+                    memcpy(bmp.GetData(entry->x,entry->y+row),src.GetLine(row),line_bytes);
+
+                return entry;
+            }
+
+            /**
+             * 移除一项，页中的项全部被移除后整页重新可用
+             */
+            bool Remove(const uint64 id)
+            {
+                auto it=entry_map.find(id);
+
+                if(it==entry_map.end())return(false);
+
+                Page *page=page_list[it->second.page];
+
+                entry_map.erase(it);
+
+                auto pos=std::find(page->id_list.begin(),page->id_list.end(),id);
+
+                if(pos!=page->id_list.end())
+                {
+                    *pos=page->id_list.back();
+                    page->id_list.pop_back();
+                }
+
+                if(--page->live_count==0)
+                {
+                    page->id_list.clear();
+                    page->packer.Reset();
+                }
+
+                return(true);
+            }
+
+            /**
+             * 取得一项的子区域视图(不含边距)
+             */
+            View GetView(const AtlasEntry &entry)const
+            {
+                if(entry.page>=page_list.size())return View();
+
+                return page_list[entry.page]->bitmap.GetSubView(entry.x,entry.y,entry.width,entry.height);
+            }
+
+            const int       GetPageWidth    ()const{return page_width;}
+            const int       GetPageHeight   ()const{return page_height;}
+            const int       GetPadding      ()const{return padding;}
+            const uint      GetPageCount    ()const{return uint(page_list.size());}
+            const uint      GetMaxPages     ()const{return max_pages;}
+            const size_t    GetBudget       ()const{return budget_bytes;}
+            const size_t    GetResidentBytes()const{return page_list.size()*GetPageBytes();}    ///<所有页占用的字节数
+            const uint      GetEntryCount   ()const{return uint(entry_map.size());}
+
+            const uint64    GetHitCount     ()const{return hit_count;}
+            const uint64    GetMissCount    ()const{return miss_count;}
+            const uint64    GetEvictCount   ()const{return evict_count;}                        ///<被淘汰的页数
+
+            const PageBitmap *GetPage(const uint index)const{return index<page_list.size()?&(page_list[index]->bitmap):nullptr;}
+
+            /**
+             * 取得一页中被写入过的范围，上传后由调用者Clear
+             */
+            DirtyRegion *GetPageDirty(const uint index){return index<page_list.size()?&(page_list[index]->dirty):nullptr;}
+
+            /**
+             * 页中已使用面积所占比例
+             */
+            const float GetPageOccupancy(const uint index)const{return index<page_list.size()?page_list[index]->packer.GetOccupancy():0;}
+        };//template<typename T,uint C> class AtlasCache
+
+        using AtlasCacheGrey8=AtlasCache<uint8,1>;
+        using AtlasCacheRGBA8=AtlasCache<Vector4u8,4>;
+
+        /**
+         * 以灰度图集中的一项作为Alpha8字形
+         */
+        inline GlyphBitmap ToGlyphBitmap(const BitmapViewGrey8 &view)
+        {
+            return GlyphBitmap(GlyphFormat::Alpha8,view.GetWidth(),view.GetHeight(),view.GetData(),view.GetLineBytes());
+        }
+    }//namespace bitmap
+}//namespace hgl
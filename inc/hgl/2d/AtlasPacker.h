@@ -0,0 +1,79 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 天际线(skyline)矩形装箱器<br>
+         * 记录每一列已被占用的最高位置(一条由若干水平段组成的折线)，新矩形放在能使其底边最低的位置(bottom-left)，
+         * 同样高度时选择浪费面积最少的位置。不支持单独释放矩形，只能整体Reset。
+         */
+        class SkylinePacker
+        {
+            struct Segment
+            {
+                int x,y,width;                                                  ///<此段从x开始宽width，已占用到y(不含)
+            };
+
+            int width,height;
+
+            std::vector<Segment> skyline;
+
+            uint64 used_area;
+            uint rect_count;
+
+        private:
+
+            bool Fit(const size_t index,const int w,const int h,int *y,uint64 *waste)const;
+            void Place(const size_t index,const int x,const int y,const int w,const int h);
+
+        public:
+
+            SkylinePacker()
+            {
+                width=height=0;
+                used_area=0;
+                rect_count=0;
+            }
+
+            SkylinePacker(const int w,const int h):SkylinePacker()
+            {
+                Init(w,h);
+            }
+
+            void Init(const int w,const int h);
+
+            /**
+             * 清除所有已放置的矩形
+             */
+            void Reset();
+
+            const int       GetWidth    ()const{return width;}
+            const int       GetHeight   ()const{return height;}
+            const uint      GetCount    ()const{return rect_count;}
+            const uint64    GetUsedArea ()const{return used_area;}
+
+            /**
+             * 已使用面积所占比例
+             */
+            const float GetOccupancy()const
+            {
+                return (width>0&&height>0)?float(double(used_area)/(double(width)*double(height))):0;
+            }
+
+            /**
+             * 放置一个矩形
+             * @param w 宽
+             * @param h 高
+             * @param x 返回放置位置左边
+             * @param y 返回放置位置上边
+             * @return 没有足够的空间时返回false
+             */
+            bool Insert(const int w,const int h,int *x,int *y);
+        };//class SkylinePacker
+    }//namespace bitmap
+}//namespace hgl
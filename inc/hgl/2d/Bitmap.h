@@ -3,120 +3,226 @@
 
 #include<hgl/type/DataType.h>
 #include<hgl/type/String.h>
-#include<hgl/math/HalfFloat.h>
-#include<iterator>
+#include<hgl/2d/BitmapView.h>
+#include<hgl/2d/BitmapAllocator.h>
 namespace hgl
 {
     namespace bitmap
     {
-        template<typename T> 
-        static void FillPixels(T *p,const T &color,const int length)
-        {
-            std::fill_n(p,length,color);
-        }
-
         /**
-         * 简单的2D象素处理
+         * 简单的2D象素处理<br>
+         * 自行分配并拥有象素数据的位图，可以当做BitmapView使用。<br>
+         * 数据首地址按BITMAP_DATA_ALIGNMENT对齐，每行可带有填充，行跨度为GetLinePixels()个象素。<br>
+         * 创建时各行从上往下存放，可用SetBottomUp改为从下往上，data_bytes与分配器总是对应GetMemory()所指的内存。
          */
-        template<typename T,uint C> class Bitmap
+        template<typename T,uint C> class Bitmap:public BitmapView<T,C>
         {
-            int width,height;
+            using BitmapView<T,C>::width;
+            using BitmapView<T,C>::height;
+            using BitmapView<T,C>::line_pixels;
+            using BitmapView<T,C>::data;
+
+            size_t data_bytes;                                                  ///<data分配的字节数
 
-            T *data;
+            BitmapAllocator *allocator;
+
+        protected:
+
+            void FreeData()
+            {
+                if(data)
+                {
+                    allocator->Free(this->GetMemory(),data_bytes);
+                    data=nullptr;
+                }
+
+                data_bytes=0;
+            }
 
         public:
 
             Bitmap()
             {
-                data=nullptr;
-                width=height=0;
+                data_bytes=0;
+                allocator=GetDefaultBitmapAllocator();
             }
 
-            ~Bitmap()
+            Bitmap(BitmapAllocator *ba):Bitmap()
             {
-                delete[] data;
+                if(ba)
+                    allocator=ba;
             }
 
-            const uint GetChannels      ()const{return C;}
-            const uint GetChannelBits   ()const{return (sizeof(T)/C)<<3;}
+            Bitmap(const Bitmap &)=delete;
+            Bitmap &operator=(const Bitmap &)=delete;
 
-            const int  GetWidth         ()const{return width;}
-            const int  GetHeight        ()const{return height;}
-            const uint GetTotalPixels   ()const{return width*height;}
-            const uint GetLineBytes     ()const{return width*sizeof(T);}
-            const uint GetTotalBytes    ()const{return width*height*sizeof(T);}
+            Bitmap(Bitmap &&bmp):Bitmap()
+            {
+                Swap(bmp);
+            }
 
-            T *GetData(){return data;}
-            T *GetData(int x,int y)
+            Bitmap &operator=(Bitmap &&bmp)
             {
-                return (x<0||x>=width||y<0||y>=height)?nullptr:data+(y*width+x);
+                if(this!=&bmp)
+                {
+                    Clear();
+                    Swap(bmp);
+                }
+
+                return *this;
+            }
+
+            ~Bitmap()
+            {
+                FreeData();
+            }
+
+            void Swap(Bitmap &bmp)
+            {
+                std::swap(width,bmp.width);
+                std::swap(height,bmp.height);
+                std::swap(line_pixels,bmp.line_pixels);
+                std::swap(data,bmp.data);
+                std::swap(data_bytes,bmp.data_bytes);
+                std::swap(allocator,bmp.allocator);
             }
 
-            const T *GetData()const{return data;}
-            const T *GetData(int x,int y)const
+            /**
+             * 设置数据分配器，已有的数据会被清除
+             * @param ba 分配器，为nullptr时使用默认分配器
+             */
+            void SetAllocator(BitmapAllocator *ba)
             {
-                return (x<0||x>=width||y<0||y>=height)?nullptr:data+(y*width+x);
+                Clear();
+
+                allocator=ba?ba:GetDefaultBitmapAllocator();
             }
 
-            bool Create(uint w,uint h)
+            BitmapAllocator *GetAllocator()const{return allocator;}
+
+            const uint GetDataBytes     ()const{return this->GetLineBytes()*height;}           ///<数据区字节数(含填充)
+
+            /**
+             * 计算行跨度字节数为alignment倍数的最小每行象素数
+             */
+            static const uint GetAlignedLinePixels(const uint w,const uint alignment=BITMAP_DATA_ALIGNMENT)
+            {
+                if(!alignment)return w;
+
+                uint lp=w;
+
+                for(uint i=0;i<alignment;i++,lp++)
+                    if((lp*sizeof(T))%alignment==0)
+                        return lp;
+
+                return w;
+            }
+
+            /**
+             * 创建位图
+             * @param w 宽
+             * @param h 高
+             * @param lp 每行象素数，小于w时等于w
+             */
+            bool Create(uint w,uint h,uint lp=0)
             {
                 if(!w||!h)return(false);
 
+                if(lp<w)lp=w;
+
                 if(data)
                 {
-                    if(width==w&&height==h)return(true);
+                    if(line_pixels<0)                                           //重新创建的位图总是从上往下存放
+                    {
+                        data=this->GetMemory();
+                        line_pixels=-line_pixels;                               //此后FreeData()释放的才是分配所得的地址
+                    }
+
+                    if(width==w&&height==h&&line_pixels==int(lp))return(true);
                 }
 
-                width=w;
-                height=h;
+                const size_t bytes=size_t(lp)*h*sizeof(T);
+
+                if(bytes!=data_bytes)
+                {
+                    FreeData();
 
-                delete[] data;
+                    data=(T *)allocator->Alloc(bytes);
 
-                data=new T[width*height];
+                    if(!data)
+                    {
+                        width=height=line_pixels=0;
+                        return(false);
+                    }
+
+                    data_bytes=bytes;
+                }
+
+                width=w;
+                height=h;
+                line_pixels=lp;
 
                 return(true);
             }
 
-            void Clear()
+            /**
+             * 创建行跨度按alignment字节对齐的位图
+             */
+            bool CreateAligned(uint w,uint h,const uint alignment=BITMAP_DATA_ALIGNMENT)
             {
-                if(data)
-                {
-                    delete[] data;
-                    data=nullptr;
-                }
-
-                width=height=0;
+                return Create(w,h,GetAlignedLinePixels(w,alignment));
             }
 
-            void ClearColor(const T &color)
+            void Clear()
             {
-                if(!data)return;
-    
-                FillPixels<T>(data,color,width*height);
+                FreeData();
+
+                width=height=line_pixels=0;
             }
 
-            void Flip()
+            /**
+             * 接管一块象素数据，原有数据会被释放
+             * @param d 象素数据，必须由ba分配(默认分配器为AlignedAlloc)，大小至少为lp*h*sizeof(T)字节
+             * @param w 宽
+             * @param h 高
+             * @param lp 每行象素数，小于w时等于w
+             * @param ba 释放d所用的分配器，为nullptr时使用默认分配器
+             */
+            bool Adopt(T *d,uint w,uint h,uint lp=0,BitmapAllocator *ba=nullptr)
             {
-                if(!data||height<=1)return;
+                if(!d||!w||!h)return(false);
 
-                const uint line_bytes=width*sizeof(T);
+                if(d==this->GetMemory())return(false);
 
-                T *temp=new T[width];
+                if(lp<w)lp=w;
 
-                T *top=data;
-                T *bottom=data+(width*(height-1));
+                Clear();
 
-                while(top<bottom)
-                {
-                    memcpy(temp,top,line_bytes);
-                    memcpy(top,bottom,line_bytes);
-                    memcpy(bottom,temp,line_bytes);
+                allocator=ba?ba:GetDefaultBitmapAllocator();
 
-                    top+=width;
-                    bottom-=width;
-                }
+                data=d;
+                data_bytes=size_t(lp)*h*sizeof(T);
+                width=w;
+                height=h;
+                line_pixels=lp;
+
+                return(true);
+            }
+
+            /**
+             * 放弃象素数据的所有权，位图变为空<br>
+             * 返回的数据须由GetAllocator()->Free(p,GetDataBytes())释放，所以请在调用前取得这两个值。
+             * 返回的是GetMemory()，从下往上存放时为最下面一行，请在调用前用IsBottomUp()取得方向。
+             */
+            T *Release()
+            {
+                T *result=this->GetMemory();
+
+                data=nullptr;
+                data_bytes=0;
+                width=height=line_pixels=0;
 
-                delete[] temp;
+                return result;
             }
         };//template<typename T> class Bitmap
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<map>
+#include<mutex>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        constexpr uint BITMAP_DATA_ALIGNMENT=64;                                ///<位图数据默认对齐字节数
+
+        /**
+         * 位图数据分配器
+         */
+        struct BitmapAllocator
+        {
+            virtual ~BitmapAllocator()=default;
+
+            virtual void *Alloc(const size_t bytes)=0;                          ///<分配至少bytes字节，首地址按BITMAP_DATA_ALIGNMENT对齐
+            virtual void Free(void *ptr,const size_t bytes)=0;                  ///<释放Alloc得到的内存，bytes须与分配时一致
+        };//struct BitmapAllocator
+
+        void *AlignedAlloc(const size_t bytes,const size_t alignment=BITMAP_DATA_ALIGNMENT);
+        void AlignedFree(void *ptr);
+
+        /**
+         * 取得默认的位图数据分配器(直接对齐分配，不缓存)
+         */
+        BitmapAllocator *GetDefaultBitmapAllocator();
+
+        /**
+         * 位图数据缓存池<br>
+         * 释放的内存块按尺寸缓存，再次分配相同尺寸时直接复用，适合反复创建同尺寸的帧缓冲区。<br>
+         * 可被多个线程同时使用。所有从本池分配的位图都必须在本池销毁前释放。
+         */
+        class BitmapPool:public BitmapAllocator
+        {
+            std::mutex lock;
+
+            std::map<size_t,std::vector<void *>> free_blocks;                  ///<按尺寸分类的空闲块
+
+            size_t max_cache_bytes;                                             ///<最多缓存的字节数
+            size_t cache_bytes;                                                 ///<当前缓存的字节数
+
+            uint64 hit_count;
+            uint64 miss_count;
+
+        public:
+
+            /**
+             * @param max_bytes 最多缓存的字节数，超出后释放的内存块直接归还系统
+             */
+            BitmapPool(const size_t max_bytes=size_t(256)*1024*1024);
+            ~BitmapPool() override;
+
+            void *Alloc(const size_t bytes) override;
+            void Free(void *ptr,const size_t bytes) override;
+
+            void Trim();                                                        ///<将所有缓存的内存块归还系统
+
+            void SetMaxCacheBytes(const size_t max_bytes);
+
+            const size_t GetMaxCacheBytes()const{return max_cache_bytes;}
+            const size_t GetCacheBytes()const{return cache_bytes;}
+            const uint64 GetHitCount()const{return hit_count;}
+            const uint64 GetMissCount()const{return miss_count;}
+        };//class BitmapPool
+    }//namespace bitmap
+}//namespace hgl
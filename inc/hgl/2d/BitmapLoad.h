@@ -6,8 +6,14 @@ namespace hgl
 {
     namespace bitmap
     {
+        /**
+         * 位图载入接收器<br>
+         * 解码器按行送出数据，行号y总是从上往下计数，与文件中的行序无关。
+         */
         struct BitmapLoader
         {
+            virtual ~BitmapLoader()=default;
+
             virtual const uint OnChannels()const=0;
             virtual const uint OnChannelBits()const=0;
 
@@ -16,56 +22,140 @@ namespace hgl
                 return OnChannelBits()*OnChannels();
             }
 
-            virtual void *OnRecvBitmap(uint w,uint h)=0;
+            /**
+             * 文件中各行的存放方向，只有行序可变的格式(如TGA)在OnRecvBitmap之前调用
+             */
+            virtual void OnRowOrder(const bool bottom_up){}
+
+            /**
+             * 开始接收位图
+             * @return 是否继续载入
+             */
+            virtual bool OnRecvBitmap(uint w,uint h)=0;
+
+            /**
+             * 取得第y行数据的存放地址，解码器会将该行直接写到这里<br>
+             * 返回nullptr时，解码器将该行写入内部的行缓冲区，只需OnRecvRow处理即可，这样可以用很少的内存处理大图。
+             */
+            virtual void *OnRowBuffer(uint y){return(nullptr);}
+
+            /**
+             * 第y行数据接收完成
+             * @param data 行数据，即OnRowBuffer返回的地址或内部行缓冲区
+             * @return 是否继续载入
+             */
+            virtual bool OnRecvRow(uint y,const void *data){return(true);}
 
             virtual void OnLoadFailed()=0;
-            virtual void OnFlip()=0;
         };
 
+        /**
+         * 将数据载入到位图中<br>
+         * 提供了目标位图时直接填充该位图(尺寸相同时不会重新分配内存)，否则在第一次收到数据时创建新位图。<br>
+         * 每行数据直接写到其最终位置，从下往上存放的图片也无需再翻转。<br>
+         * keep_orientation为true时位图保持文件中的行序(见BitmapView::IsBottomUp)，未压缩的数据可以一次读入。
+         */
         template<typename T> struct BitmapLoaderImpl:public BitmapLoader
         {
             T *bmp;
+            bool own;                                                           ///<bmp是否为自行创建
+
+            bool keep_orientation;                                              ///<是否保持文件中的行序
+            bool file_bottom_up;
 
         public:
 
-            BitmapLoaderImpl()
+            BitmapLoaderImpl(T *target=nullptr,const bool keep=false)
+            {
+                bmp=target;
+                own=!target;
+                keep_orientation=keep;
+                file_bottom_up=false;
+            }
+
+            ~BitmapLoaderImpl()
             {
+                if(own)
+                    delete bmp;
+            }
+
+            /**
+             * 取走自行创建的位图
+             */
+            T *Detach()
+            {
+                T *result=bmp;
+
                 bmp=nullptr;
+                own=false;
+
+                return result;
+            }
+
+            const uint OnChannels()const override{return T::CHANNELS;}
+            const uint OnChannelBits()const override{return T::CHANNEL_BITS;}
+
+            void OnRowOrder(const bool bottom_up) override
+            {
+                file_bottom_up=bottom_up;
             }
-    
-            const uint OnChannels()const override{return bmp->GetChannels();}
-            const uint OnChannelBits()const override{return bmp->GetChannelBits();}
 
-            void *OnRecvBitmap(uint w,uint h) override
+            bool OnRecvBitmap(uint w,uint h) override
             {
                 if(!bmp)
                     bmp=new T;
 
-                bmp->Create(w,h);
-                return bmp->GetData();
+                if(!bmp->Create(w,h))
+                    return(false);
+
+                if(keep_orientation)
+                    bmp->SetBottomUp(file_bottom_up);
+
+                return(true);
             }
 
-            void OnLoadFailed() override
+            void *OnRowBuffer(uint y) override
             {
-                SAFE_CLEAR(bmp);
+                return bmp?bmp->GetLine(y):nullptr;
             }
 
-            void OnFlip() override
+            void OnLoadFailed() override
             {
-                if(bmp)
-                    bmp->Flip();
+                if(!bmp)return;
+
+                if(own)
+                {
+                    SAFE_CLEAR(bmp);
+                }
+                else
+                    bmp->Clear();
             }
         };
 
         bool LoadBitmapFromTGAStream(io::InputStream *,BitmapLoader *);
+        bool LoadBitmapFromQOIStream(io::InputStream *,BitmapLoader *);        ///<只支持RGB8/RGBA8，象素与TGA一样按BGR(A)顺序存放
+
+        /**
+         * 从TGA流载入到已有的位图中
+         * @param keep_orientation 是否保持文件中的行序，为false时总是从上往下存放
+         */
+        template<typename T>
+        inline bool LoadBitmapFromTGA(io::InputStream *is,T *bmp,const bool keep_orientation=false)
+        {
+            if(!is||!bmp)return(false);
+
+            BitmapLoaderImpl<T> bli(bmp,keep_orientation);
+
+            return LoadBitmapFromTGAStream(is,&bli);
+        }
 
         template<typename T>
-        inline T *LoadBitmapFromTGA(io::InputStream *is)
+        inline T *LoadBitmapFromTGA(io::InputStream *is,const bool keep_orientation=false)
         {
-            BitmapLoaderImpl<T> bli;
+            BitmapLoaderImpl<T> bli(nullptr,keep_orientation);
 
             if(LoadBitmapFromTGAStream(is,&bli))
-                return bli.bmp;
+                return bli.Detach();
 
             return(nullptr);
         }
@@ -74,14 +164,27 @@ namespace hgl
         inline BitmapRGBA8 *LoadBitmapRGBA8FromTGA(io::InputStream *is){return LoadBitmapFromTGA<BitmapRGBA8>(is);}
 
         template<typename T>
-        inline T *LoadBitmapFromTGA(const OSString &filename)
+        inline T *LoadBitmapFromTGA(const OSString &filename,const bool keep_orientation=false)
         {
             io::OpenFileInputStream fis(filename);
 
             if(!fis)
                 return(nullptr);
 
-            return LoadBitmapFromTGA<T>(&fis);
+            return LoadBitmapFromTGA<T>(&fis,keep_orientation);
+        }
+
+        template<typename T>
+        inline bool LoadBitmapFromTGA(const OSString &filename,T *bmp,const bool keep_orientation=false)
+        {
+            if(!bmp)return(false);
+
+            io::OpenFileInputStream fis(filename);
+
+            if(!fis)
+                return(false);
+
+            return LoadBitmapFromTGA<T>(&fis,bmp,keep_orientation);
         }
 
         inline BitmapRGB8 *LoadBitmapRGB8FromTGA(const OSString &filename){return LoadBitmapFromTGA<BitmapRGB8>(filename);}
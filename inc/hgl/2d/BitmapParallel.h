@@ -0,0 +1,172 @@
+#pragma once
+
+#include<hgl/2d/BitmapView.h>
+#include<hgl/2d/Blend.h>
+#include<hgl/2d/Blit.h>
+#include<hgl/2d/PixelFormat.h>
+#include<hgl/2d/TaskPool.h>
+
+/**
+ * 整张位图操作的并行版本
+ *
+ * 位图按TASK_BAND_BYTES大小的行带分给任务池中的线程处理，pool为nullptr时使用全局任务池(GetGlobalTaskPool)，
+ * 两者都没有或数据量较小时在调用线程串行处理，结果与串行版本完全相同。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        constexpr size_t STREAM_FILL_MIN_BYTES=8*1024*1024;                    ///<填充量不小于此值时使用非临时写入(大于常见的末级缓存中单核可用的部分)
+
+        /**
+         * 以非临时写入方式(不经过缓存)填充象素，用于填充后不会马上读取的大块数据<br>
+         * x86上象素大小为1/2/3/4/6/8/12/16字节时使用SSE2的非临时写入，其它情况按普通方式填充
+         * @param pixel 一个象素的数据
+         * @param pixel_bytes 象素字节数
+         * @param count 象素数量
+         */
+        void StreamFillPixels(void *dst,const void *pixel,const uint pixel_bytes,const size_t count);
+
+        inline TaskPool *SelectTaskPool(TaskPool *pool)
+        {
+            return pool?pool:GetGlobalTaskPool();
+        }
+
+        /**
+         * 并行以同一颜色填充整张位图
+         * @param stream 是否允许非临时写入，仅在总数据量不小于STREAM_FILL_MIN_BYTES时使用
+         */
+        template<typename T,uint C>
+        inline void ParallelClearColor(BitmapView<T,C> *bmp,const T &color,TaskPool *pool=nullptr,const bool stream=true)
+        {
+            if(!bmp||bmp->IsEmpty())return;
+
+            const int width=bmp->GetWidth();
+            const int line_pixels=bmp->GetLinePixels();
+            const bool use_stream=stream&&(size_t(bmp->GetTotalBytes())>=STREAM_FILL_MIN_BYTES);
+
+            auto fill=[&color,use_stream](T *p,const size_t count)
+            {
+                if(use_stream)
+                    StreamFillPixels(p,&color,sizeof(T),count);
+                else
+                    FillPixels<T>(p,color,int(count));
+            };
+
+            ForEachRowBand(SelectTaskPool(pool),bmp->GetHeight(),size_t(width)*sizeof(T),[bmp,&fill,width,line_pixels](const uint y0,const uint y1)
+            {
+                T *p=bmp->GetLine(y0);
+
+                if(width==line_pixels)                                          //没有行尾填充时一个行带是连续的
+                {
+                    fill(p,size_t(width)*(y1-y0));
+                    return;
+                }
+
+                for(uint y=y0;y<y1;y++)
+                {
+                    fill(p,width);
+                    p+=line_pixels;
+                }
+            });
+        }
+
+        /**
+         * 并行上下翻转整张位图
+         */
+        template<typename T,uint C>
+        inline void ParallelFlip(BitmapView<T,C> *bmp,TaskPool *pool=nullptr)
+        {
+            if(!bmp||bmp->IsEmpty()||bmp->GetHeight()<=1)return;
+
+            const int height=bmp->GetHeight();
+            const size_t line_bytes=size_t(bmp->GetWidth())*sizeof(T);
+
+            //每个行带交换上半部分中的一组行与下半部分中对应的行，所以按两倍行数据量计算
+            ForEachRowBand(SelectTaskPool(pool),uint(height/2),line_bytes*2,[bmp,height,line_bytes](const uint y0,const uint y1)
+            {
+                for(uint y=y0;y<y1;y++)
+                    SwapMemory(bmp->GetLine(y),bmp->GetLine(height-1-y),line_bytes);
+            });
+        }
+
+        /**
+         * 逐行带对两张相同尺寸的位图调用func(dst_band,src_band)
+         */
+        template<typename DT,uint DC,typename ST,uint SC,typename F>
+        inline bool ParallelBitmapBands(BitmapView<DT,DC> *dst,const BitmapView<ST,SC> *src,TaskPool *pool,const F &func)
+        {
+            if(!dst||!src||dst->IsEmpty()||src->IsEmpty())
+                return(false);
+
+            if(dst->GetWidth()!=src->GetWidth()
+             ||dst->GetHeight()!=src->GetHeight())
+                return(false);
+
+            const int width=src->GetWidth();
+            const size_t row_bytes=size_t(width)*(sizeof(DT)+sizeof(ST));
+
+            ForEachRowBand(SelectTaskPool(pool),src->GetHeight(),row_bytes,[dst,src,&func,width](const uint y0,const uint y1)
+            {
+                BitmapView<DT,DC> d=dst->GetSubView(0,y0,width,y1-y0);
+                const BitmapView<ST,SC> s=src->GetSubView(0,y0,width,y1-y0);
+
+                func(&d,&s);
+            });
+
+            return(true);
+        }
+
+        /**
+         * 并行混合两张相同尺寸的位图，BB为位图混合器，如BlendBitmapRGBA8toRGBA8
+         */
+        template<typename BB,typename DT,uint DC,typename ST,uint SC>
+        inline bool ParallelBlendBitmap(const BitmapView<ST,SC> *src,BitmapView<DT,DC> *dst,const float alpha,TaskPool *pool=nullptr)
+        {
+            const BB blend;
+
+            return ParallelBitmapBands(dst,src,pool,[&blend,alpha](BitmapView<DT,DC> *d,const BitmapView<ST,SC> *s)
+            {
+                blend(s,d,alpha);
+            });
+        }
+
+        /**
+         * 并行转换两张相同尺寸的位图，可用于所有ConvertBitmap支持的格式组合
+         */
+        template<typename DT,uint DC,typename ST,uint SC>
+        inline bool ParallelConvertBitmap(BitmapView<DT,DC> *dst,const BitmapView<ST,SC> *src,TaskPool *pool=nullptr)
+        {
+            return ParallelBitmapBands(dst,src,pool,[](BitmapView<DT,DC> *d,const BitmapView<ST,SC> *s)
+            {
+                ConvertBitmap(d,s);
+            });
+        }
+
+        /**
+         * 并行执行Blit，参数与Blit相同(args为空或混合策略与alpha)。src与dst不可重叠。
+         */
+        template<typename DT,uint DC,typename ST,uint SC,typename ...ARGS>
+        inline bool ParallelBlit(const BitmapView<ST,SC> *src,const ClipRect *src_rect,BitmapView<DT,DC> *dst,const int x,const int y,TaskPool *pool,const ARGS &...args)
+        {
+            if(!src||!dst||src->IsEmpty()||dst->IsEmpty())
+                return(false);
+
+            BlitRect br;
+
+            if(!ClipBlitRect(&br,src->GetWidth(),src->GetHeight(),src_rect,dst->GetWidth(),dst->GetHeight(),x,y))
+                return(false);
+
+            const size_t row_bytes=size_t(br.width)*(sizeof(DT)+sizeof(ST));
+
+            ForEachRowBand(SelectTaskPool(pool),uint(br.height),row_bytes,[&](const uint y0,const uint y1)
+            {
+                const ClipRect band{br.src_x,br.src_y+int(y0),br.src_x+br.width,br.src_y+int(y1)};
+
+                Blit(src,&band,dst,br.dst_x,br.dst_y+int(y0),args...);
+            });
+
+            return(true);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -6,18 +6,101 @@ namespace hgl
 {
     namespace bitmap
     {
-        bool SaveBitmapToTGA(io::OutputStream *os,void *data,uint width,uint height,uint channels,uint single_channel_bits);
+        class TaskPool;
+
+        /**
+         * TGA保存选项
+         */
+        struct TGASaveOption
+        {
+            bool rle=false;                                                     ///<是否使用RLE压缩
+            bool bottom_up=false;                                               ///<数据是否从下往上存放(data为最下面一行)，文件按左下角原点保存，各行按内存顺序写出
+
+            TaskPool *task_pool=nullptr;                                        ///<并行压缩使用的任务池，为nullptr时在当前线程压缩
+            uint band_rows=0;                                                   ///<每个压缩任务处理的行数，为0时自动决定
+
+            uint write_buffer_bytes=4*1024*1024;                                ///<合并写入缓冲区大小，数据攒满后一次写出
+        };//struct TGASaveOption
+
+        /**
+         * 以TGA格式保存象素数据到流<br>
+         * RLE压缩时图片被分为若干行带，各行带可在task_pool中并行压缩，再按顺序写出。
+         * @param line_bytes 数据每行跨度字节数，为0时表示各行连续存放
+         */
+        bool SaveBitmapToTGA(io::OutputStream *os,const void *data,uint width,uint height,uint channels,uint single_channel_bits,uint line_bytes,const TGASaveOption &option);
+
+        /**
+         * @param line_bytes 数据每行跨度字节数，为0时表示各行连续存放
+         * @param rle 是否使用RLE压缩
+         */
+        inline bool SaveBitmapToTGA(io::OutputStream *os,void *data,uint width,uint height,uint channels,uint single_channel_bits,uint line_bytes=0,bool rle=false)
+        {
+            TGASaveOption option;
+
+            option.rle=rle;
+
+            return SaveBitmapToTGA(os,data,width,height,channels,single_channel_bits,line_bytes,option);
+        }
+
+        /**
+         * 以QOI格式保存象素数据到流
+         * @param data 象素数据，与TGA一样按BGR(A)顺序存放
+         * @param channels 通道数，只支持3或4
+         * @param line_bytes 数据每行跨度字节数，为0时表示各行连续存放
+         * @param linear 数据是否为线性颜色空间(仅记录在文件头中)
+         * @param bottom_up 数据是否从下往上存放(data为最下面一行)，QOI只能从上往下保存，此时从内存的最后一行开始编码
+         */
+        bool SaveBitmapToQOI(io::OutputStream *os,const void *data,uint width,uint height,uint channels,uint line_bytes=0,bool linear=false,bool bottom_up=false);
+
+        template<typename T,uint C>
+        inline bool SaveBitmapToQOI(io::OutputStream *os,const BitmapView<T,C> *bmp,const bool linear=false)
+        {
+            if(!os||!bmp)return(false);
+
+            return SaveBitmapToQOI(os,bmp->GetMemory(),bmp->GetWidth(),bmp->GetHeight(),bmp->GetChannels(),bmp->GetLineBytes(),linear,bmp->IsBottomUp());
+        }
+
+        template<typename T,uint C>
+        inline bool SaveBitmapToTGA(io::OutputStream *os,const BitmapView<T,C> *bmp,const TGASaveOption &option)
+        {
+            if(!os||!bmp)return(false);
+
+            TGASaveOption bmp_option=option;
+
+            bmp_option.bottom_up=bmp->IsBottomUp();                             //按位图本身的方向保存，无需翻转
+
+            return SaveBitmapToTGA(os,bmp->GetMemory(),bmp->GetWidth(),bmp->GetHeight(),bmp->GetChannels(),bmp->GetChannelBits(),bmp->GetLineBytes(),bmp_option);
+        }
 
         template<typename T>
-        inline bool SaveBitmapToTGA(io::OutputStream *os,const T *bmp)
+        inline bool SaveBitmapToTGA(io::OutputStream *os,const T *bmp,const bool rle=false)
         {
             if(!os||!bmp)return(false);
 
-            return SaveBitmapToTGA(os,(void *)(bmp->GetData()),bmp->GetWidth(),bmp->GetHeight(),bmp->GetChannels(),bmp->GetChannelBits());
+            TGASaveOption option;
+
+            option.rle=rle;
+            option.bottom_up=bmp->IsBottomUp();
+
+            return SaveBitmapToTGA(os,bmp->GetMemory(),bmp->GetWidth(),bmp->GetHeight(),bmp->GetChannels(),bmp->GetChannelBits(),bmp->GetLineBytes(),option);
+        }
+
+        template<typename T,uint C>
+        inline bool SaveBitmapToTGA(const OSString &filename,const BitmapView<T,C> *bmp,const TGASaveOption &option)
+        {
+            if(filename.IsEmpty()||!bmp)
+                return(false);
+
+            io::OpenFileOutputStream fos(filename,io::FileOpenMode::CreateTrunc);
+
+            if(!fos)
+                return(false);
+
+            return SaveBitmapToTGA(&fos,bmp,option);
         }
 
         template<typename T>
-        inline bool SaveBitmapToTGA(const OSString &filename,T *bmp)
+        inline bool SaveBitmapToTGA(const OSString &filename,T *bmp,const bool rle=false)
         {
             if(filename.IsEmpty()||!bmp)
                 return(false);
@@ -26,8 +109,8 @@ namespace hgl
 
             if(!fos)
                 return(false);
-        
-            return SaveBitmapToTGA(fos,bmp);
+
+            return SaveBitmapToTGA(fos,bmp,rle);
         }
     }//namespace bitmap
-}//namespace hgl
\ No newline at end of file
+}//namespace hgl
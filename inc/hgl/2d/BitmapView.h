@@ -0,0 +1,220 @@
+#ifndef HGL_2D_BITMAP_VIEW_INCLUDE
+#define HGL_2D_BITMAP_VIEW_INCLUDE
+
+#include<hgl/type/DataType.h>
+#include<hgl/math/HalfFloat.h>
+#include<algorithm>
+#include<string.h>
+#include<stddef.h>
+namespace hgl
+{
+    namespace bitmap
+    {
+        template<typename T>
+        static void FillPixels(T *p,const T &color,const int length)
+        {
+            std::fill_n(p,length,color);
+        }
+
+        /**
+         * 交换两块不重叠内存的内容，不分配临时内存
+         */
+        void SwapMemory(void *a,void *b,const size_t bytes);
+
+        /**
+         * 位图视图<br>
+         * 不拥有象素数据，仅记录数据指针、尺寸与行跨度。可用于引用另一位图的子区域、内存映射文件或外部(如GPU映射)的缓冲区。<br>
+         * 视图本身可以随意复制，其所引用的数据须由使用者保证在使用期间有效。<br>
+         * 行跨度为负数时各行在内存中从下往上存放(如左下角为原点的TGA/BMP)，data仍指向最上面一行，
+         * 所以按行访问的代码无需区分两种方向。
+         */
+        template<typename T,uint C> class BitmapView
+        {
+        protected:
+
+            int width,height;
+            int line_pixels;                                                    ///<每行象素数(含行尾填充)，负数表示从下往上存放
+
+            T *data;
+
+        public:
+
+            using PixelType=T;
+
+            static constexpr uint CHANNELS=C;
+            static constexpr uint CHANNEL_BITS=(sizeof(T)/C)<<3;
+
+            BitmapView()
+            {
+                data=nullptr;
+                width=height=line_pixels=0;
+            }
+
+            /**
+             * @param d 象素数据
+             * @param w 宽
+             * @param h 高
+             * @param lp 每行象素数，小于w时等于w
+             */
+            BitmapView(T *d,int w,int h,int lp=0)
+            {
+                Set(d,w,h,lp);
+            }
+
+            /**
+             * 创建从下往上存放的数据的视图
+             * @param memory 数据首地址，即最下面一行
+             * @param lp 每行象素数，小于w时等于w
+             */
+            static BitmapView<T,C> FromBottomUp(T *memory,int w,int h,int lp=0)
+            {
+                BitmapView<T,C> bv(memory,w,h,lp);
+
+                bv.SetBottomUp(true);
+                return bv;
+            }
+
+        protected:
+
+            void Set(T *d,int w,int h,int lp=0)
+            {
+                if(!d||w<=0||h<=0)
+                {
+                    data=nullptr;
+                    width=height=line_pixels=0;
+                    return;
+                }
+
+                data=d;
+                width=w;
+                height=h;
+                line_pixels=(lp<w?w:lp);
+            }
+
+        public:
+
+            const bool IsEmpty          ()const{return !data;}
+
+            const uint GetChannels      ()const{return C;}
+            const uint GetChannelBits   ()const{return (sizeof(T)/C)<<3;}
+
+            const int  GetWidth         ()const{return width;}
+            const int  GetHeight        ()const{return height;}
+            const int  GetLinePixels    ()const{return line_pixels;}                         ///<从一行到下一行的跨度象素数(含填充)，从下往上存放时为负数
+            const uint GetTotalPixels   ()const{return width*height;}
+            const uint GetLineBytes     ()const{return (line_pixels<0?-line_pixels:line_pixels)*sizeof(T);}   ///<每行跨度字节数(含填充)，不区分方向
+            const ptrdiff_t GetStride   ()const{return ptrdiff_t(line_pixels)*ptrdiff_t(sizeof(T));}    ///<从一行到下一行的跨度字节数，从下往上存放时为负数
+            const uint GetTotalBytes    ()const{return width*height*sizeof(T);}                ///<象素数据字节数(不含填充)
+
+            const bool IsContinuous     ()const{return line_pixels==width;}                    ///<各行之间是否没有填充(且从上往下存放)
+            const bool IsBottomUp       ()const{return line_pixels<0;}                         ///<各行是否从下往上存放
+
+            /**
+             * 设置各行的存放方向<br>
+             * 不移动数据，只改变对已有内存的解释，所以方向改变时看到的图像会上下颠倒。
+             * 可用于把另一方向的数据当作本方向使用，或以零代价得到上下翻转的视图。
+             */
+            void SetBottomUp(const bool bottom_up)
+            {
+                if(!data||bottom_up==IsBottomUp())return;
+
+                data+=line_pixels*(height-1);
+                line_pixels=-line_pixels;
+            }
+
+            /**
+             * 取得数据在内存中的起始地址，从下往上存放时为最下面一行
+             */
+            T *GetMemory(){return (data&&line_pixels<0)?data+line_pixels*(height-1):data;}
+            const T *GetMemory()const{return (data&&line_pixels<0)?data+line_pixels*(height-1):data;}
+
+            T *GetData(){return data;}
+            T *GetData(int x,int y)
+            {
+                return (x<0||x>=width||y<0||y>=height)?nullptr:data+(y*line_pixels+x);
+            }
+
+            const T *GetData()const{return data;}
+            const T *GetData(int x,int y)const
+            {
+                return (x<0||x>=width||y<0||y>=height)?nullptr:data+(y*line_pixels+x);
+            }
+
+            T *GetLine(int y){return (y<0||y>=height)?nullptr:data+y*line_pixels;}
+            const T *GetLine(int y)const{return (y<0||y>=height)?nullptr:data+y*line_pixels;}
+
+            /**
+             * 取得子区域视图，区域超出部分会被裁掉
+             */
+            BitmapView<T,C> GetSubView(int l,int t,int w,int h)const
+            {
+                if(l<0){w+=l;l=0;}
+                if(t<0){h+=t;t=0;}
+                if(l+w>width)w=width-l;
+                if(t+h>height)h=height-t;
+
+                if(!data||w<=0||h<=0)
+                    return BitmapView<T,C>();
+
+                BitmapView<T,C> sv;                                             //直接复制行跨度以保留方向
+
+                sv.data=data+(t*line_pixels+l);
+                sv.width=w;
+                sv.height=h;
+                sv.line_pixels=line_pixels;
+
+                return sv;
+            }
+
+            void ClearColor(const T &color)
+            {
+                if(!data)return;
+
+                if(IsContinuous())
+                {
+                    FillPixels<T>(data,color,width*height);
+                    return;
+                }
+
+                T *p=data;
+
+                for(int y=0;y<height;y++)
+                {
+                    FillPixels<T>(p,color,width);
+                    p+=line_pixels;
+                }
+            }
+
+            /**
+             * 上下翻转象素数据，逐行原地交换，不分配内存<br>
+             * 只需改变看到的方向时请使用SetBottomUp，不必移动数据。
+             */
+            void Flip()
+            {
+                if(!data||height<=1)return;
+
+                const size_t line_bytes=size_t(width)*sizeof(T);
+
+                T *top=data;
+                T *bottom=data+(line_pixels*(height-1));
+
+                for(int y=0;y<height/2;y++)
+                {
+                    SwapMemory(top,bottom,line_bytes);
+
+                    top+=line_pixels;
+                    bottom-=line_pixels;
+                }
+            }
+        };//template<typename T,uint C> class BitmapView
+
+        using BitmapViewGrey8=BitmapView<uint8,1>;
+        using BitmapViewRG8=BitmapView<Vector2u8,2>;
+        using BitmapViewRGB8=BitmapView<Vector3u8,3>;
+        using BitmapViewRGBA8=BitmapView<Vector4u8,4>;
+
+        using BitmapViewU16=BitmapView<uint16,1>;
+        using BitmapViewU32=BitmapView<uint32,1>;
+    }//namespace bitmap
+}//namespace hgl
+#endif//HGL_2D_BITMAP_VIEW_INCLUDE
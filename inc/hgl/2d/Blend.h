@@ -18,8 +18,90 @@ namespace hgl
             {
                 return src;
             }
+
+            /**
+             * 将同一颜色混合到一段连续的象素上
+             * @param color 颜色
+             * @param dst 目标象素
+             * @param count 象素数量
+             * @param alpha 透明度
+             */
+            virtual void BlendSpan(const T &color,T *dst,const int count,const float alpha)const
+            {
+                for(int i=0;i<count;i++)
+                {
+                    *dst=(*this)(color,*dst,alpha);
+                    ++dst;
+                }
+            }
+
+            /**
+             * 将同一颜色混合到一段间隔固定的象素上
+             * @param color 颜色
+             * @param dst 目标象素
+             * @param count 象素数量
+             * @param stride 相邻两个象素的间隔(以象素计)
+             * @param alpha 透明度
+             */
+            virtual void BlendSpan(const T &color,T *dst,const int count,const int stride,const float alpha)const
+            {
+                for(int i=0;i<count;i++)
+                {
+                    *dst=(*this)(color,*dst,alpha);
+                    dst+=stride;
+                }
+            }
+
+            /**
+             * 将同一颜色按逐象素覆盖率混合到一段连续的象素上(用于抗锯齿)
+             * @param color 颜色
+             * @param dst 目标象素
+             * @param coverage 每个象素的覆盖率(0-255)
+             * @param count 象素数量
+             * @param alpha 透明度
+             */
+            virtual void BlendCoverageSpan(const T &color,T *dst,const uint8 *coverage,const int count,const float alpha)const
+            {
+                for(int i=0;i<count;i++)
+                {
+                    if(coverage[i])
+                        dst[i]=(*this)(color,dst[i],alpha*coverage[i]/255.0f);
+                }
+            }
         };//template<typename T> struct BlendColor
 
+        /**
+         * 不混合，直接以新颜色覆盖
+         */
+        template<typename T> struct BlendColorNone:public BlendColor<T>
+        {
+            void BlendSpan(const T &color,T *dst,const int count,const float)const override
+            {
+                FillPixels<T>(dst,color,count);
+            }
+
+            void BlendSpan(const T &color,T *dst,const int count,const int stride,const float)const override
+            {
+                for(int i=0;i<count;i++)
+                {
+                    *dst=color;
+                    dst+=stride;
+                }
+            }
+
+            /**
+             * 不混合时无法表现部分覆盖，覆盖率过半的象素直接写入
+             */
+            void BlendCoverageSpan(const T &color,T *dst,const uint8 *coverage,const int count,const float)const override
+            {
+                for(int i=0;i<count;i++)
+                {
+                    if(coverage[i]>=128)
+                        dst[i]=color;
+                }
+            }
+        };//template<typename T> struct BlendColorNone
+
         /**
          * 位图混合处理模板
          */
@@ -34,73 +116,181 @@ namespace hgl
         {
             const uint32 operator()(const uint32 &src,const uint32 &dst)const
             {
-                uint64 result=src+dst;
+                uint64 result=uint64(src)+dst;
 
                 return (result>HGL_U32_MAX)?HGL_U32_MAX:(result&HGL_U32_MAX);
             }
 
             const uint32 operator()(const uint32 &src,const uint32 &dst,const float &alpha)const
             {
-                uint64 result=src*alpha+dst;
+                uint64 result=uint64(src*alpha)+dst;
 
                 return (result>HGL_U32_MAX)?HGL_U32_MAX:(result&HGL_U32_MAX);
             }
+
+            void BlendSpan(const uint32 &color,uint32 *dst,const int count,const float alpha)const override
+            {
+                const uint64 add=uint64(color*alpha);
+
+                for(int i=0;i<count;i++)
+                {
+                    const uint64 result=add+dst[i];
+
+                    dst[i]=(result>HGL_U32_MAX)?HGL_U32_MAX:uint32(result);
+                }
+            }
+
+            void BlendSpan(const uint32 &color,uint32 *dst,const int count,const int stride,const float alpha)const override
+            {
+                const uint64 add=uint64(color*alpha);
+
+                for(int i=0;i<count;i++)
+                {
+                    const uint64 result=add+*dst;
+
+                    *dst=(result>HGL_U32_MAX)?HGL_U32_MAX:uint32(result);
+                    dst+=stride;
+                }
+            }
+
+            void BlendCoverageSpan(const uint32 &color,uint32 *dst,const uint8 *coverage,const int count,const float alpha)const override
+            {
+                const double add=color*alpha/255.0;
+
+                for(int i=0;i<count;i++)
+                {
+                    const uint64 result=uint64(add*coverage[i])+dst[i];
+
+                    dst[i]=(result>HGL_U32_MAX)?HGL_U32_MAX:uint32(result);
+                }
+            }
         };
 
+        /**
+         * 将一组U32值饱和叠加到目标上<br>
+         * alpha为1时等同于BlendColorU32Additive不带alpha的operator()，根据CPU支持情况自动选用AVX2/SSE2/NEON实现；
+         * 否则逐个按带alpha的公式计算
+         */
+        void BlendAdditiveU32(uint32 *dst,const uint32 *src,const uint count,const float alpha);
+
+        /**
+         * 计算(v+127)/255，即v/255的四舍五入结果(v<=255*255)
+         */
+        inline const uint DivideBy255(const uint v)
+        {
+            return (v+127)/255;
+        }
+
+        /**
+         * 将0-1的浮点alpha转换为0-255的整数alpha
+         */
+        inline const uint AlphaToU8(const float alpha)
+        {
+            if(alpha<=0)return 0;
+            if(alpha>=1)return 255;
+
+            return uint(alpha*255.0f+0.5f);
+        }
+
+        /**
+         * 将同一颜色按逐象素覆盖率混合到一组RGBA8象素上(目标alpha保持不变)，用于抗锯齿与字形绘制<br>
+         * 根据CPU支持情况自动选用AVX2/SSE2/NEON实现。每象素的alpha为DivideBy255(DivideBy255(color.a*AlphaToU8(alpha))*coverage)，
+         * 分两次取整，所以与以alpha*coverage/255调用BlendColorRGBA8的结果可能相差1
+         * @param coverage 每个象素的覆盖率(0-255)
+         * @param alpha 整体透明度(0-1)
+         */
+        void BlendCoverageRGBA8(Vector4u8 *dst,const Vector4u8 &color,const uint8 *coverage,const uint count,const float alpha);
+
         struct BlendColorRGBA8:public bitmap::BlendColor<Vector4u8>
         {
             const Vector4u8 operator()(const Vector4u8 &src,const Vector4u8 &dst)const
             {
-                uint8 na=255-src.a;
+                const uint a=src.a;
+                const uint na=255-a;
 
-                return Vector4u8((src.r*src.a+dst.r*na)/255,
-                                 (src.g*src.a+dst.g*na)/255,
-                                 (src.b*src.a+dst.b*na)/255,
+                return Vector4u8(DivideBy255(src.r*a+dst.r*na),
+                                 DivideBy255(src.g*a+dst.g*na),
+                                 DivideBy255(src.b*a+dst.b*na),
                                  dst.a);
             }
 
             const Vector4u8 operator()(const Vector4u8 &src,const Vector4u8 &dst,const float &alpha)const
             {
-                uint8 a=src.a*alpha;
-                uint8 na=255-src.a;
+                const uint a=DivideBy255(src.a*AlphaToU8(alpha));
+                const uint na=255-a;
 
-                return Vector4u8((src.r*src.a+dst.r*na)/255,
-                                 (src.g*src.a+dst.g*na)/255,
-                                 (src.b*src.a+dst.b*na)/255,
+                return Vector4u8(DivideBy255(src.r*a+dst.r*na),
+                                 DivideBy255(src.g*a+dst.g*na),
+                                 DivideBy255(src.b*a+dst.b*na),
                                  dst.a);
             }
-        };
 
-        template<> void bitmap::BlendBitmap<BitmapRGBA8,BitmapRGB8>::operator()(const BitmapRGBA8 *src_bitmap,BitmapRGB8 *dst_bitmap,const float alpha)const
-        {
-            if(!src_bitmap||!dst_bitmap||alpha<=0)return;
+            void BlendSpan(const Vector4u8 &color,Vector4u8 *dst,const int count,const float alpha)const override
+            {
+                //颜色固定，所以src*a部分只需计算一次
+                const uint a=DivideBy255(color.a*AlphaToU8(alpha));
+                const uint na=255-a;
 
-            const uint width=src_bitmap->GetWidth();
-            const uint height=src_bitmap->GetHeight();
+                const uint r=color.r*a;
+                const uint g=color.g*a;
+                const uint b=color.b*a;
 
-            if(width!=dst_bitmap->GetWidth()||height!=dst_bitmap->GetHeight())
-                return;
+                for(int i=0;i<count;i++)
+                {
+                    dst[i].r=DivideBy255(r+dst[i].r*na);
+                    dst[i].g=DivideBy255(g+dst[i].g*na);
+                    dst[i].b=DivideBy255(b+dst[i].b*na);
+                }
+            }
 
-                  Vector3u8 *dst=dst_bitmap->GetData();
-            const Vector4u8 *src=src_bitmap->GetData();
+            void BlendSpan(const Vector4u8 &color,Vector4u8 *dst,const int count,const int stride,const float alpha)const override
+            {
+                const uint a=DivideBy255(color.a*AlphaToU8(alpha));
+                const uint na=255-a;
 
-            float a;
-            float na;
+                const uint r=color.r*a;
+                const uint g=color.g*a;
+                const uint b=color.b*a;
 
-            for(uint i=0;i<width*height;i++)
-            {
-                a=src->a*alpha;
-                na=255-src->a;
+                for(int i=0;i<count;i++)
+                {
+                    dst->r=DivideBy255(r+dst->r*na);
+                    dst->g=DivideBy255(g+dst->g*na);
+                    dst->b=DivideBy255(b+dst->b*na);
 
-                dst->r=(src->r*a+dst->r*na)/255;
-                dst->g=(src->g*a+dst->g*na)/255;
-                dst->b=(src->b*a+dst->b*na)/255;
+                    dst+=stride;
+                }
+            }
 
-                ++dst;
-                ++src;
+            void BlendCoverageSpan(const Vector4u8 &color,Vector4u8 *dst,const uint8 *coverage,const int count,const float alpha)const override
+            {
+                if(count>0)
+                    BlendCoverageRGBA8(dst,color,coverage,uint(count),alpha);
             }
-        }
+        };
+
+        /**
+         * 将一组RGBA8象素按其alpha混合到RGB8象素上<br>
+         * 根据CPU支持情况自动选用AVX2/SSE2/NEON实现，结果与标量实现逐位一致
+         * @param dst 目标象素
+         * @param src 源象素
+         * @param count 象素数量
+         * @param alpha 整体透明度(0-1)
+         */
+        void BlendRGBA8toRGB8(Vector3u8 *dst,const Vector4u8 *src,const uint count,const float alpha);
+
+        /**
+         * 将一组RGBA8象素按其alpha混合到RGBA8象素上(目标alpha保持不变)
+         */
+        void BlendRGBA8toRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count,const float alpha);
+
+        template<> void BlendBitmap<BitmapViewRGBA8,BitmapViewRGB8>::operator()(const BitmapViewRGBA8 *,BitmapViewRGB8 *,const float)const;
+        template<> void BlendBitmap<BitmapViewRGBA8,BitmapViewRGBA8>::operator()(const BitmapViewRGBA8 *,BitmapViewRGBA8 *,const float)const;
+
+        template<> void BlendBitmap<BitmapRGBA8,BitmapRGB8>::operator()(const BitmapRGBA8 *,BitmapRGB8 *,const float)const;
+        template<> void BlendBitmap<BitmapRGBA8,BitmapRGBA8>::operator()(const BitmapRGBA8 *,BitmapRGBA8 *,const float)const;
 
-        using BlendBitmapRGBA8toRGB8=bitmap::BlendBitmap<BitmapRGBA8,BitmapRGB8>;
+        using BlendBitmapRGBA8toRGB8=bitmap::BlendBitmap<BitmapViewRGBA8,BitmapViewRGB8>;             ///<同样可用于BitmapRGBA8/BitmapRGB8
+        using BlendBitmapRGBA8toRGBA8=bitmap::BlendBitmap<BitmapViewRGBA8,BitmapViewRGBA8>;
     }//namespace bitmap
 }//namespace hgl
@@ -0,0 +1,105 @@
+#pragma once
+
+#include<hgl/2d/Blend.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 运行时可切换的混合策略<br>
+         * 通过BlendColor<T>的虚函数混合，未设置时不混合
+         */
+        template<typename T> class BlendPolicyDynamic
+        {
+            BlendColorNone<T> no_blend;
+            BlendColor<T> *blend;
+
+        public:
+
+            BlendPolicyDynamic()
+            {
+                blend=&no_blend;
+            }
+
+            BlendPolicyDynamic(const BlendPolicyDynamic &bp)
+            {
+                blend=(bp.blend==&bp.no_blend)?&no_blend:bp.blend;
+            }
+
+            BlendPolicyDynamic &operator=(const BlendPolicyDynamic &bp)
+            {
+                blend=(bp.blend==&bp.no_blend)?&no_blend:bp.blend;
+                return *this;
+            }
+
+            void SetBlend(BlendColor<T> *bc)
+            {
+                blend=bc?bc:&no_blend;
+            }
+
+            void CloseBlend()
+            {
+                blend=&no_blend;
+            }
+
+            const T Blend(const T &color,const T &dst,const float alpha)const
+            {
+                return (*blend)(color,dst,alpha);
+            }
+
+            void BlendSpan(const T &color,T *dst,const int count,const float alpha)const
+            {
+                blend->BlendSpan(color,dst,count,alpha);
+            }
+
+            void BlendSpan(const T &color,T *dst,const int count,const int stride,const float alpha)const
+            {
+                blend->BlendSpan(color,dst,count,stride,alpha);
+            }
+
+            void BlendCoverageSpan(const T &color,T *dst,const uint8 *coverage,const int count,const float alpha)const
+            {
+                blend->BlendCoverageSpan(color,dst,coverage,count,alpha);
+            }
+        };//template<typename T> class BlendPolicyDynamic
+
+        /**
+         * 编译期固定的混合策略<br>
+         * 以限定名调用BC的成员函数，不经过虚函数表，可被编译器内联及向量化
+         */
+        template<typename T,typename BC> struct BlendPolicyStatic
+        {
+            BC bc;
+
+        public:
+
+            constexpr BlendPolicyStatic()=default;
+
+            const T Blend(const T &color,const T &dst,const float alpha)const
+            {
+                return bc.BC::operator()(color,dst,alpha);
+            }
+
+            void BlendSpan(const T &color,T *dst,const int count,const float alpha)const
+            {
+                bc.BC::BlendSpan(color,dst,count,alpha);
+            }
+
+            void BlendSpan(const T &color,T *dst,const int count,const int stride,const float alpha)const
+            {
+                bc.BC::BlendSpan(color,dst,count,stride,alpha);
+            }
+
+            void BlendCoverageSpan(const T &color,T *dst,const uint8 *coverage,const int count,const float alpha)const
+            {
+                bc.BC::BlendCoverageSpan(color,dst,coverage,count,alpha);
+            }
+        };//template<typename T,typename BC> struct BlendPolicyStatic
+
+        template<typename T> using BlendPolicyOpaque=BlendPolicyStatic<T,BlendColorNone<T>>;        ///<直接覆盖
+
+        using BlendPolicyAlphaRGBA8 =BlendPolicyStatic<Vector4u8,BlendColorRGBA8>;                  ///<RGBA8 alpha混合
+        using BlendPolicyAdditiveU32=BlendPolicyStatic<uint32,BlendColorU32Additive>;               ///<U32饱和叠加
+    }//namespace bitmap
+}//namespace hgl
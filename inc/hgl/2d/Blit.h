@@ -0,0 +1,247 @@
+#pragma once
+
+#include<hgl/2d/BlendPolicy.h>
+#include<hgl/2d/PixelFormat.h>
+#include<hgl/2d/DirtyRegion.h>
+#include<hgl/2d/Instrument.h>
+
+/**
+ * 位图之间的块复制与混合
+ *
+ * 所有Blit函数都把src中的src_rect区域(为nullptr时为整张位图)放到dst的(x,y)处，两者超出位图范围的部分都被裁掉，
+ * 全部被裁掉时返回false。不混合时按行memcpy，可用于同一位图内有重叠的区域；混合与格式转换时dst与src不可重叠。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 裁剪后的复制区域
+         */
+        struct BlitRect
+        {
+            int src_x,src_y;
+            int dst_x,dst_y;
+            int width,height;
+        };//struct BlitRect
+
+        /**
+         * 计算裁剪后的复制区域
+         * @param sw,sh 源位图尺寸
+         * @param src_rect 源区域，为nullptr时为整张源位图
+         * @param dw,dh 目标位图尺寸
+         * @param x,y 源区域左上角在目标位图中的位置
+         * @return 没有需要复制的区域时返回false
+         */
+        inline bool ClipBlitRect(BlitRect *br,const int sw,const int sh,const ClipRect *src_rect,const int dw,const int dh,int x,int y)
+        {
+            if(!br)return(false);
+
+            ClipRect sr=src_rect?*src_rect:ClipRect{0,0,sw,sh};
+
+            if(sr.left<0){x-=sr.left;sr.left=0;}
+            if(sr.top <0){y-=sr.top; sr.top =0;}
+            if(sr.right >sw)sr.right =sw;
+            if(sr.bottom>sh)sr.bottom=sh;
+
+            if(x<0){sr.left-=x;x=0;}
+            if(y<0){sr.top -=y;y=0;}
+            if(sr.right -sr.left>dw-x)sr.right =sr.left+(dw-x);
+            if(sr.bottom-sr.top >dh-y)sr.bottom=sr.top +(dh-y);
+
+            if(sr.IsEmpty())return(false);
+
+            br->src_x=sr.left;
+            br->src_y=sr.top;
+            br->dst_x=x;
+            br->dst_y=y;
+            br->width=sr.GetWidth();
+            br->height=sr.GetHeight();
+
+            return(true);
+        }
+
+        /**
+         * 按行处理裁剪后的区域，func(dst,src,count)。整行且两者都连续时一次处理全部象素。
+         */
+        template<typename DT,uint DC,typename ST,uint SC,typename F>
+        inline bool BlitRows(const BitmapView<ST,SC> *src,const ClipRect *src_rect,BitmapView<DT,DC> *dst,const int x,const int y,const F &func)
+        {
+            CM2D_INSTRUMENT_SCOPE(Blit);
+
+            if(!src||!dst||src->IsEmpty()||dst->IsEmpty())
+                return(false);
+
+            BlitRect br;
+
+            if(!ClipBlitRect(&br,src->GetWidth(),src->GetHeight(),src_rect,dst->GetWidth(),dst->GetHeight(),x,y))
+                return(false);
+
+            CM2D_INSTRUMENT_PIXELS(int64(br.width)*br.height);
+
+            DT *dp=dst->GetData(br.dst_x,br.dst_y);
+            const ST *sp=src->GetData(br.src_x,br.src_y);
+
+            if(br.width==dst->GetWidth()&&br.width==src->GetWidth()
+             &&dst->IsContinuous()&&src->IsContinuous())
+            {
+                func(dp,sp,uint(br.width*br.height));
+                return(true);
+            }
+
+            for(int row=0;row<br.height;row++)
+            {
+                func(dp,sp,uint(br.width));
+
+                dp+=dst->GetLinePixels();
+                sp+=src->GetLinePixels();
+            }
+
+            return(true);
+        }
+
+        /**
+         * 直接复制，src与dst可以是同一位图中重叠的区域
+         */
+        template<typename T,uint C>
+        inline bool Blit(const BitmapView<T,C> *src,const ClipRect *src_rect,BitmapView<T,C> *dst,const int x,const int y)
+        {
+            CM2D_INSTRUMENT_SCOPE(Blit);
+
+            if(!src||!dst||src->IsEmpty()||dst->IsEmpty())
+                return(false);
+
+            BlitRect br;
+
+            if(!ClipBlitRect(&br,src->GetWidth(),src->GetHeight(),src_rect,dst->GetWidth(),dst->GetHeight(),x,y))
+                return(false);
+
+            CM2D_INSTRUMENT_PIXELS(int64(br.width)*br.height);
+
+            uint8 *dp=(uint8 *)dst->GetData(br.dst_x,br.dst_y);
+            const uint8 *sp=(const uint8 *)src->GetData(br.src_x,br.src_y);
+
+            const size_t line_bytes=size_t(br.width)*sizeof(T);
+
+            if(br.width==dst->GetWidth()&&br.width==src->GetWidth()
+             &&dst->IsContinuous()&&src->IsContinuous())
+            {
+                memmove(dp,sp,line_bytes*br.height);
+                return(true);
+            }
+
+            ptrdiff_t dst_step=dst->GetStride();
+            ptrdiff_t src_step=src->GetStride();
+
+            //目标在源之后时从内存地址最大的一行开始，避免覆盖尚未复制的源数据
+            if((dp>sp)==(dst_step>0))
+            {
+                dp+=dst_step*(br.height-1);
+                sp+=src_step*(br.height-1);
+                dst_step=-dst_step;
+                src_step=-src_step;
+            }
+
+            for(int row=0;row<br.height;row++)
+            {
+                memmove(dp,sp,line_bytes);
+
+                dp+=dst_step;
+                sp+=src_step;
+            }
+
+            return(true);
+        }
+
+        /**
+         * 按混合策略逐象素混合:dst=bp.Blend(src,dst,alpha)
+         * @param bp 混合策略，如BlendPolicyDynamic/BlendPolicyStatic
+         * @param alpha 整体透明度
+         */
+        template<typename T,uint C,typename BP>
+        inline bool Blit(const BitmapView<T,C> *src,const ClipRect *src_rect,BitmapView<T,C> *dst,const int x,const int y,const BP &bp,const float alpha=1)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[&bp,alpha](T *d,const T *s,const uint count)
+            {
+                for(uint i=0;i<count;i++)
+                    d[i]=bp.Blend(s[i],d[i],alpha);
+            });
+        }
+
+        /**
+         * 不混合的策略直接复制
+         */
+        template<typename T,uint C>
+        inline bool Blit(const BitmapView<T,C> *src,const ClipRect *src_rect,BitmapView<T,C> *dst,const int x,const int y,const BlendPolicyOpaque<T> &,const float=1)
+        {
+            return Blit(src,src_rect,dst,x,y);
+        }
+
+        inline bool Blit(const BitmapViewRGBA8 *src,const ClipRect *src_rect,BitmapViewRGBA8 *dst,const int x,const int y,const BlendPolicyAlphaRGBA8 &,const float alpha=1)
+        {
+            if(alpha<=0)return(false);
+
+            return BlitRows(src,src_rect,dst,x,y,[alpha](Vector4u8 *d,const Vector4u8 *s,const uint count){BlendRGBA8toRGBA8(d,s,count,alpha);});
+        }
+
+        /**
+         * RGBA8按其alpha混合到RGB8上
+         */
+        inline bool Blit(const BitmapViewRGBA8 *src,const ClipRect *src_rect,BitmapViewRGB8 *dst,const int x,const int y,const BlendPolicyAlphaRGBA8 &,const float alpha=1)
+        {
+            if(alpha<=0)return(false);
+
+            return BlitRows(src,src_rect,dst,x,y,[alpha](Vector3u8 *d,const Vector4u8 *s,const uint count){BlendRGBA8toRGB8(d,s,count,alpha);});
+        }
+
+        inline bool Blit(const BitmapViewU32 *src,const ClipRect *src_rect,BitmapViewU32 *dst,const int x,const int y,const BlendPolicyAdditiveU32 &,const float alpha=1)
+        {
+            if(alpha<=0)return(false);
+
+            return BlitRows(src,src_rect,dst,x,y,[alpha](uint32 *d,const uint32 *s,const uint count){BlendAdditiveU32(d,s,count,alpha);});
+        }
+
+        /**
+         * 复制并转换格式
+         */
+        inline bool Blit(const BitmapViewRGB8 *src,const ClipRect *src_rect,BitmapViewRGBA8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](Vector4u8 *d,const Vector3u8 *s,const uint n){RGB8toRGBA8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewRGBA8 *src,const ClipRect *src_rect,BitmapViewRGB8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](Vector3u8 *d,const Vector4u8 *s,const uint n){RGBA8toRGB8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewRGB8 *src,const ClipRect *src_rect,BitmapViewGrey8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](uint8 *d,const Vector3u8 *s,const uint n){RGB8toGrey8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewRGBA8 *src,const ClipRect *src_rect,BitmapViewGrey8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](uint8 *d,const Vector4u8 *s,const uint n){RGBA8toGrey8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewGrey8 *src,const ClipRect *src_rect,BitmapViewRGB8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](Vector3u8 *d,const uint8 *s,const uint n){Grey8toRGB8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewGrey8 *src,const ClipRect *src_rect,BitmapViewRGBA8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](Vector4u8 *d,const uint8 *s,const uint n){Grey8toRGBA8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewRG8 *src,const ClipRect *src_rect,BitmapViewRGBA8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](Vector4u8 *d,const Vector2u8 *s,const uint n){RG8toRGBA8(d,s,n);});
+        }
+
+        inline bool Blit(const BitmapViewRGBA8 *src,const ClipRect *src_rect,BitmapViewRG8 *dst,const int x,const int y)
+        {
+            return BlitRows(src,src_rect,dst,x,y,[](Vector2u8 *d,const Vector4u8 *s,const uint n){RGBA8toRG8(d,s,n);});
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,44 @@
+#pragma once
+
+#include<hgl/platform/Platform.h>
+
+#if defined(__x86_64__)||defined(_M_X64)||defined(__i386__)||defined(_M_IX86)
+    #define CM2D_SIMD_X86
+#elif defined(__ARM_NEON)||defined(__ARM_NEON__)||defined(_M_ARM64)
+    #define CM2D_SIMD_NEON
+#endif//
+
+#if defined(CM2D_SIMD_X86)&&(defined(__GNUC__)||defined(__clang__))
+    #define CM2D_TARGET_SSE2    __attribute__((target("sse2")))
+    #define CM2D_TARGET_SSSE3   __attribute__((target("ssse3")))
+    #define CM2D_TARGET_AVX2    __attribute__((target("avx2")))
+    #define CM2D_TARGET_F16C    __attribute__((target("avx,f16c")))
+#else
+    #define CM2D_TARGET_SSE2
+    #define CM2D_TARGET_SSSE3
+    #define CM2D_TARGET_AVX2
+    #define CM2D_TARGET_F16C
+#endif//
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 当前CPU可用的SIMD指令集
+         */
+        struct CPUFeature
+        {
+            bool sse2=false;
+            bool ssse3=false;
+            bool avx2=false;
+            bool f16c=false;
+            bool neon=false;
+        };//struct CPUFeature
+
+        /**
+         * 取得当前CPU的SIMD指令集支持情况(首次调用时检测)
+         */
+        const CPUFeature &GetCPUFeature();
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,93 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 一行覆盖率数据
+         */
+        struct CoverageSpan
+        {
+            int y;                                                              ///<行号
+            int x;                                                              ///<起始列
+            int count;                                                          ///<象素数量
+            const uint8 *coverage;                                              ///<每象素覆盖率(0-255)
+        };//struct CoverageSpan
+
+        /**
+         * 抗锯齿覆盖率光栅化器<br>
+         * 以有向面积累加的方式(同FreeType/stb_truetype)计算每个象素被覆盖的比例，非零环绕规则。<br>
+         * 所有边先裁剪到位图范围内，然后逐行扫描，每行只使用一条可重复使用的累加缓冲区。
+         */
+        class CoverageRasterizer
+        {
+            struct Edge
+            {
+                float x0,y0;                                                    ///<上端点
+                float x1,y1;                                                    ///<下端点
+                float dir;                                                      ///<方向(向下为1，向上为-1)
+            };
+
+            int width,height;
+
+            std::vector<Edge> edge_list;
+
+            float start_x,start_y;
+            float last_x,last_y;
+
+            std::vector<float> cells;                                           ///<面积累加缓冲区(width+2)
+            std::vector<uint8> coverage;                                        ///<当前行覆盖率
+
+            std::vector<uint> active;                                           ///<当前行活动边
+            uint next_edge;
+            int cur_y,end_y;
+
+        private:
+
+            void AddEdge(float x0,float y0,float x1,float y1);
+            void AddClipEdge(float x0,float y0,float x1,float y1);
+            void AccumulateEdge(const Edge &,const int y);
+
+        public:
+
+            CoverageRasterizer();
+            ~CoverageRasterizer()=default;
+
+            /**
+             * 清除所有边，并设置裁剪尺寸
+             */
+            void Reset(const int w,const int h);
+
+            const bool IsEmpty()const{return edge_list.empty();}
+
+            void MoveTo(const float x,const float y);
+            void LineTo(const float x,const float y);
+            void ClosePath();
+
+            void AddLine(const float x0,const float y0,const float x1,const float y1);      ///<添加一条边(需自行保证路径闭合)
+            void AddPolygon(const Vector2f *points,const int count);                        ///<添加一个闭合多边形
+
+            void AddThickLine(const float x0,const float y0,const float x1,const float y1,const float line_width);     ///<添加一条有宽度的直线(平头)
+            void AddCircle(const float cx,const float cy,const float radius,const bool clockwise=true);                ///<添加一个圆
+            void AddRing(const float cx,const float cy,const float radius,const float line_width);                     ///<添加一个圆环
+
+        public:
+
+            /**
+             * 开始逐行扫描
+             * @return 是否有需要输出的内容
+             */
+            bool BeginSweep();
+
+            /**
+             * 输出下一个非空行
+             * @return 是否还有数据
+             */
+            bool SweepScanline(CoverageSpan &);
+        };//class CoverageRasterizer
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,119 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 裁剪矩形(right/bottom不包含在内)
+         */
+        struct ClipRect
+        {
+            int left,top,right,bottom;
+
+        public:
+
+            const bool IsEmpty()const{return left>=right||top>=bottom;}
+
+            const bool Contains(const int x,const int y)const
+            {
+                return x>=left&&x<right&&y>=top&&y<bottom;
+            }
+
+            const bool Contains(const ClipRect &cr)const
+            {
+                return cr.left>=left&&cr.right<=right&&cr.top>=top&&cr.bottom<=bottom;
+            }
+
+            const bool Intersects(const ClipRect &cr)const
+            {
+                return cr.left<right&&cr.right>left&&cr.top<bottom&&cr.bottom>top;
+            }
+
+            const int GetWidth()const{return right-left;}
+            const int GetHeight()const{return bottom-top;}
+            const uint64 GetArea()const{return IsEmpty()?0:uint64(right-left)*uint64(bottom-top);}
+        };//struct ClipRect
+
+        constexpr uint DIRTY_REGION_MAX_RECTS=16;                               ///<脏矩形默认最大数量
+
+        /**
+         * 脏区域<br>
+         * 以少量矩形记录位图上被修改过的范围。新矩形与已有矩形合并后多出的面积不超过二者面积之和的一定比例时合并，
+         * 矩形数量超过上限时合并代价最小的两个，所以记录的范围可能大于实际修改的范围，但不会遗漏。
+         */
+        class DirtyRegion
+        {
+            std::vector<ClipRect> rect_list;
+
+            ClipRect bounds;                                                    ///<有效范围，所有矩形都被裁剪到此范围内
+            bool use_bounds;
+
+            uint max_rects;
+
+        protected:
+
+            void MergeCheapestPair();
+
+        public:
+
+            DirtyRegion(const uint mr=DIRTY_REGION_MAX_RECTS)
+            {
+                bounds=ClipRect{0,0,0,0};
+                use_bounds=false;
+                max_rects=(mr>0?mr:1);
+            }
+
+            /**
+             * 设置有效范围，已有的矩形会被裁剪
+             */
+            void SetBounds(const int width,const int height);
+
+            const ClipRect &GetBounds()const{return bounds;}
+
+            const bool  IsEmpty     ()const{return rect_list.empty();}
+            const uint  GetCount    ()const{return uint(rect_list.size());}
+            const ClipRect *GetRects()const{return rect_list.data();}
+            const uint64 GetArea    ()const;                                    ///<所有矩形的面积之和(重叠部分重复计算)
+
+            /**
+             * 求包含所有矩形的最小矩形，没有矩形时返回空矩形
+             */
+            const ClipRect GetBoundingRect()const;
+
+            const bool Intersects(const ClipRect &cr)const;
+
+            void Clear(){rect_list.clear();}
+
+            /**
+             * 添加一个被修改的矩形(right/bottom不包含在内)
+             */
+            void Add(ClipRect cr);
+
+            void Add(const int left,const int top,const int right,const int bottom)
+            {
+                Add(ClipRect{left,top,right,bottom});
+            }
+
+            void Add(const DirtyRegion &dr)
+            {
+                for(const ClipRect &cr:dr.rect_list)
+                    Add(cr);
+            }
+
+            /**
+             * 将整个有效范围标记为脏
+             */
+            void AddAll()
+            {
+                if(!use_bounds||bounds.IsEmpty())return;
+
+                rect_list.clear();
+                rect_list.push_back(bounds);
+            }
+        };//class DirtyRegion
+    }//namespace bitmap
+}//namespace hgl
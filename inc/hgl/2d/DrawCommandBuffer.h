@@ -0,0 +1,247 @@
+#pragma once
+
+#include<hgl/2d/DrawGeometry.h>
+#include<hgl/2d/TaskPool.h>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        enum class DrawCommandType
+        {
+            PutPixel,
+            HLine,
+            VLine,
+            Bar,
+            Line,
+            WireCircle,
+            SolidCircle,
+            Sector,
+            SolidSector,
+        };//enum class DrawCommandType
+
+        /**
+         * 绘制指令缓冲区<br>
+         * 先记录绘制指令，在Render时按屏幕分块归类，再由TaskPool并行回放。<br>
+         * 每个分块内的指令保持记录时的顺序，且各图元在分块裁剪下输出的象素与整体绘制完全一致，所以结果与串行绘制相同。
+         */
+        template<typename T,typename FormatBitmap,typename BlendPolicy=BlendPolicyDynamic<T>> class DrawCommandBuffer
+        {
+        public:
+
+            using DrawGeometryType=DrawGeometry<T,FormatBitmap,BlendPolicy>;
+
+        protected:
+
+            struct DrawCommand
+            {
+                DrawCommandType type;
+                int arg[5];
+
+                T color;
+                float alpha;
+                BlendColor<T> *blend;                                           ///<仅BlendPolicyDynamic使用
+            };
+
+            std::vector<DrawCommand> command_list;
+
+            T draw_color;
+            float alpha;
+            BlendColor<T> *blend;
+
+            int tile_size;
+
+            std::vector<std::vector<uint>> tile_commands;                      ///<每个分块的指令序号
+            std::vector<uint> active_tiles;                                     ///<有指令的分块
+
+        protected:
+
+            void AddCommand(const DrawCommandType type,const int a0=0,const int a1=0,const int a2=0,const int a3=0,const int a4=0)
+            {
+                DrawCommand dc;
+
+                dc.type=type;
+                dc.arg[0]=a0;
+                dc.arg[1]=a1;
+                dc.arg[2]=a2;
+                dc.arg[3]=a3;
+                dc.arg[4]=a4;
+                dc.color=draw_color;
+                dc.alpha=alpha;
+                dc.blend=blend;
+
+                command_list.push_back(dc);
+            }
+
+            /**
+             * 求指令影响的范围(包含边界)
+             */
+            static bool GetBounds(const DrawCommand &dc,int &l,int &t,int &r,int &b)
+            {
+                const int *a=dc.arg;
+
+                switch(dc.type)
+                {
+                    case DrawCommandType::PutPixel:     l=r=a[0];t=b=a[1];break;
+                    case DrawCommandType::HLine:        l=a[0];t=b=a[1];r=a[0]+a[2]-1;break;
+                    case DrawCommandType::VLine:        l=r=a[0];t=a[1];b=a[1]+a[2]-1;break;
+                    case DrawCommandType::Bar:          l=a[0];t=a[1];r=a[0]+a[2]-1;b=a[1]+a[3]-1;break;
+                    case DrawCommandType::Line:         l=(a[0]<a[2]?a[0]:a[2]);r=(a[0]<a[2]?a[2]:a[0]);
+                                                        t=(a[1]<a[3]?a[1]:a[3]);b=(a[1]<a[3]?a[3]:a[1]);break;
+                    case DrawCommandType::WireCircle:
+                    case DrawCommandType::SolidCircle:
+                    case DrawCommandType::Sector:
+                    case DrawCommandType::SolidSector:  l=a[0]-a[2];r=a[0]+a[2];t=a[1]-a[2];b=a[1]+a[2];break;
+                    default:return(false);
+                }
+
+                return(l<=r&&t<=b);
+            }
+
+            static void ApplyBlend(DrawGeometry<T,FormatBitmap,BlendPolicyDynamic<T>> &dg,BlendColor<T> *bc)
+            {
+                dg.SetBlend(bc);
+            }
+
+            template<typename DG> static void ApplyBlend(DG &,BlendColor<T> *){}
+
+            static void Execute(DrawGeometryType &dg,const DrawCommand &dc)
+            {
+                const int *a=dc.arg;
+
+                dg.SetDrawColor(dc.color);
+                dg.SetAlpha(dc.alpha);
+                ApplyBlend(dg,dc.blend);
+
+                switch(dc.type)
+                {
+                    case DrawCommandType::PutPixel:     dg.PutPixel(a[0],a[1]);break;
+                    case DrawCommandType::HLine:        dg.DrawHLine(a[0],a[1],a[2]);break;
+                    case DrawCommandType::VLine:        dg.DrawVLine(a[0],a[1],a[2]);break;
+                    case DrawCommandType::Bar:          dg.DrawBar(a[0],a[1],a[2],a[3]);break;
+                    case DrawCommandType::Line:         dg.DrawLine(a[0],a[1],a[2],a[3]);break;
+                    case DrawCommandType::WireCircle:   dg.DrawWireCircle(a[0],a[1],a[2]);break;
+                    case DrawCommandType::SolidCircle:  dg.DrawSolidCircle(a[0],a[1],a[2]);break;
+                    case DrawCommandType::Sector:       dg.DrawSector(a[0],a[1],a[2],a[3],a[4]);break;
+                    case DrawCommandType::SolidSector:  dg.DrawSolidSector(a[0],a[1],a[2],a[3],a[4]);break;
+                }
+            }
+
+        public:
+
+            /**
+             * @param ts 分块尺寸(象素)
+             */
+            DrawCommandBuffer(const int ts=128)
+            {
+                hgl_zero(draw_color);
+                alpha=1;
+                blend=nullptr;
+                tile_size=(ts>0?ts:128);
+            }
+
+            virtual ~DrawCommandBuffer()=default;
+
+            const int GetTileSize()const{return tile_size;}
+            const uint GetCommandCount()const{return uint(command_list.size());}
+
+            void Clear(){command_list.clear();}
+
+            void SetDrawColor(const T &color){draw_color=color;}
+            void SetAlpha(const float &a){alpha=a;}
+            void SetBlend(BlendColor<T> *bc){blend=bc;}                       ///<仅BlendPolicyDynamic有效，bc在Render完成前必须有效
+            void CloseBlend(){blend=nullptr;}
+
+            void PutPixel(int x,int y)                              {AddCommand(DrawCommandType::PutPixel,x,y);}
+            void DrawHLine(int x,int y,int length)                  {if(length>0)AddCommand(DrawCommandType::HLine,x,y,length);}
+            void DrawVLine(int x,int y,int length)                  {if(length>0)AddCommand(DrawCommandType::VLine,x,y,length);}
+            void DrawBar(int l,int t,int w,int h)                   {if(w>0&&h>0)AddCommand(DrawCommandType::Bar,l,t,w,h);}
+            void DrawLine(int x1,int y1,int x2,int y2)              {AddCommand(DrawCommandType::Line,x1,y1,x2,y2);}
+            void DrawWireCircle(int x,int y,int radius)             {if(radius>0)AddCommand(DrawCommandType::WireCircle,x,y,radius);}
+            void DrawSolidCircle(int x,int y,int radius)            {if(radius>0)AddCommand(DrawCommandType::SolidCircle,x,y,radius);}
+            void DrawSector(int x,int y,uint r,uint st,uint end)    {if(r>0)AddCommand(DrawCommandType::Sector,x,y,int(r),int(st),int(end));}
+            void DrawSolidSector(int x,int y,uint r,uint st,uint end){if(r>0)AddCommand(DrawCommandType::SolidSector,x,y,int(r),int(st),int(end));}
+
+            /**
+             * 将所有指令绘制到位图上
+             * @param bmp 目标位图
+             * @param pool 任务池，为nullptr时在当前线程逐块绘制
+             * @param dirty 脏区域，不为nullptr时记入各指令(已裁剪)的包围盒
+             */
+            bool Render(FormatBitmap *bmp,TaskPool *pool=nullptr,DirtyRegion *dirty=nullptr)
+            {
+                if(!bmp||command_list.empty())return(false);
+
+                const int width=bmp->GetWidth();
+                const int height=bmp->GetHeight();
+
+                if(width<=0||height<=0)return(false);
+
+                const int tile_cols=(width+tile_size-1)/tile_size;
+                const int tile_rows=(height+tile_size-1)/tile_size;
+
+                tile_commands.resize(tile_cols*tile_rows);
+
+                for(std::vector<uint> &tc:tile_commands)
+                    tc.clear();
+
+                //按包围盒归入所覆盖的每个分块
+                int l,t,r,b;
+
+                for(uint i=0;i<command_list.size();i++)
+                {
+                    if(!GetBounds(command_list[i],l,t,r,b))continue;
+
+                    if(r<0||b<0||l>=width||t>=height)continue;
+
+                    if(l<0)l=0;
+                    if(t<0)t=0;
+                    if(r>=width)r=width-1;
+                    if(b>=height)b=height-1;
+
+                    if(dirty)
+                        dirty->Add(l,t,r+1,b+1);
+
+                    for(int ty=t/tile_size;ty<=b/tile_size;ty++)
+                        for(int tx=l/tile_size;tx<=r/tile_size;tx++)
+                            tile_commands[ty*tile_cols+tx].push_back(i);
+                }
+
+                active_tiles.clear();
+
+                for(uint i=0;i<tile_commands.size();i++)
+                    if(!tile_commands[i].empty())
+                        active_tiles.push_back(i);
+
+                if(active_tiles.empty())return(true);
+
+                const auto draw_tile=[&](const uint index)
+                {
+                    const uint tile=active_tiles[index];
+                    const int tx=(tile%tile_cols)*tile_size;
+                    const int ty=(tile/tile_cols)*tile_size;
+
+                    DrawGeometryType dg(bmp);
+
+                    dg.SetClipRect(tx,ty,tile_size,tile_size);
+
+                    for(const uint ci:tile_commands[tile])
+                        Execute(dg,command_list[ci]);
+                };
+
+                if(pool)
+                    pool->Run(uint(active_tiles.size()),draw_tile);
+                else
+                    for(uint i=0;i<active_tiles.size();i++)
+                        draw_tile(i);
+
+                return(true);
+            }
+        };//template<typename T,typename FormatBitmap,typename BlendPolicy> class DrawCommandBuffer
+
+        using DrawCommandBufferU32=DrawCommandBuffer<uint32,BitmapU32>;
+        using DrawCommandBufferRGB8=DrawCommandBuffer<Vector3u8,BitmapRGB8>;
+        using DrawCommandBufferRGBA8=DrawCommandBuffer<Vector4u8,BitmapRGBA8>;
+    }//namespace bitmap
+}//namespace hgl
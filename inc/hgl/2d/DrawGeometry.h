@@ -1,14 +1,27 @@
 #pragma once
 
 #include<hgl/2d/Bitmap.h>
-#include<hgl/2d/Blend.h>
+#include<hgl/2d/BlendPolicy.h>
+#include<hgl/2d/CoverageRasterizer.h>
+#include<hgl/2d/PolygonRasterizer.h>
+#include<hgl/2d/DirtyRegion.h>
+#include<hgl/2d/GlyphBitmap.h>
+#include<hgl/2d/Instrument.h>
 #include<hgl/math/FastTriangle.h>
+#include<climits>
 
 namespace hgl
 {
     namespace bitmap
     {
-        template<typename T,typename FormatBitmap> class DrawGeometry
+        /**
+         * 2D几何图形绘制
+         * @param T 象素类型
+         * @param FormatBitmap 位图类型
+         * @param BlendPolicy 混合策略，默认为运行时可切换的BlendPolicyDynamic，<br>
+         *                    使用BlendPolicyStatic系列时混合函数可被内联，但不能再调用SetBlend/CloseBlend
+         */
+        template<typename T,typename FormatBitmap,typename BlendPolicy=BlendPolicyDynamic<T>> class DrawGeometry
         {
         protected:
 
@@ -17,8 +30,46 @@ namespace hgl
             T draw_color;
             float alpha;
 
-            BlendColor<T> no_blend;
-            BlendColor<T> *blend;
+            BlendPolicy blend;
+
+            bool use_clip;
+            ClipRect user_clip;                                                 ///<用户设定的裁剪区域
+
+            CoverageRasterizer rasterizer;                                      ///<抗锯齿绘制使用的光栅化器
+            PolygonRasterizer polygon_rasterizer;                               ///<实心多边形绘制使用的光栅化器
+
+            DirtyRegion *dirty_region;                                          ///<记录被修改范围的脏区域，可为nullptr
+            int dirty_mute;                                                     ///<大于0时不记录，组合图元已整体记录过包围盒
+
+        protected:
+
+            /**
+             * 将一个范围(right/bottom不包含在内)与裁剪区域求交后记入脏区域
+             */
+            void MarkDirty(int l,int t,int r,int b)
+            {
+                if(!dirty_region||dirty_mute>0)return;
+
+                const ClipRect cr=GetClipRect();
+
+                if(l<cr.left)l=cr.left;
+                if(t<cr.top)t=cr.top;
+                if(r>cr.right)r=cr.right;
+                if(b>cr.bottom)b=cr.bottom;
+
+                dirty_region->Add(l,t,r,b);
+            }
+
+            /**
+             * 在作用域内关闭脏区域记录
+             */
+            struct DirtyMute
+            {
+                int &count;
+
+                DirtyMute(int &c):count(c){++count;}
+                ~DirtyMute(){--count;}
+            };
 
         public:
 
@@ -27,11 +78,34 @@ namespace hgl
                 bitmap=fb;
                 hgl_zero(draw_color);
                 alpha=1;
-                blend=&no_blend;
+                use_clip=false;
+                dirty_region=nullptr;
+                dirty_mute=0;
             }
 
             virtual ~DrawGeometry()=default;
 
+            /**
+             * 更换绘制目标，颜色、混合与裁剪设置保持不变
+             */
+            void SetBitmap(FormatBitmap *fb)
+            {
+                bitmap=fb;
+            }
+
+            FormatBitmap *GetBitmap()const{return bitmap;}
+
+            /**
+             * 设置脏区域，之后每个绘制操作都会将其影响的范围(已裁剪)记入其中
+             * @param dr 脏区域，为nullptr时不再记录。多个线程同时绘制时不可共用同一个脏区域
+             */
+            void SetDirtyRegion(DirtyRegion *dr)
+            {
+                dirty_region=dr;
+            }
+
+            DirtyRegion *GetDirtyRegion()const{return dirty_region;}
+
             virtual void SetDrawColor(const T &color)
             {
                 draw_color=color;
@@ -39,12 +113,12 @@ namespace hgl
 
             void SetBlend(BlendColor<T> *bc)
             {
-                blend=bc;
+                blend.SetBlend(bc);
             }
 
             void CloseBlend()
             {
-                blend=&no_blend;
+                blend.CloseBlend();
             }
 
             void SetAlpha(const float &a)
@@ -52,6 +126,38 @@ namespace hgl
                 alpha=a;
             }
 
+            /**
+             * 设置裁剪区域，所有绘制都不会超出此区域
+             */
+            void SetClipRect(const int left,const int top,const int width,const int height)
+            {
+                use_clip=true;
+                user_clip=ClipRect{left,top,left+width,top+height};
+            }
+
+            void CloseClipRect()
+            {
+                use_clip=false;
+            }
+
+            /**
+             * 取得实际的裁剪区域(用户裁剪区域与位图范围的交集)
+             */
+            const ClipRect GetClipRect()const
+            {
+                ClipRect cr{0,0,bitmap->GetWidth(),bitmap->GetHeight()};
+
+                if(use_clip)
+                {
+                    if(user_clip.left  >cr.left  )cr.left  =user_clip.left;
+                    if(user_clip.top   >cr.top   )cr.top   =user_clip.top;
+                    if(user_clip.right <cr.right )cr.right =user_clip.right;
+                    if(user_clip.bottom<cr.bottom)cr.bottom=user_clip.bottom;
+                }
+
+                return cr;
+            }
+
             bool GetPixel(int x,int y,T &color)
             {
                 if(!bitmap)return(false);
@@ -67,14 +173,20 @@ namespace hgl
 
             bool PutPixel(int x,int y)
             {
+                CM2D_INSTRUMENT_SCOPE(PutPixel);
+
                 if(!bitmap)return(false);
 
+                if(use_clip&&!user_clip.Contains(x,y))return(false);
+
                 T *p=bitmap->GetData(x,y);
 
                 if(!p)return(false);
 
-                *p=(*blend)(draw_color,*p,alpha);
+                *p=blend.Blend(draw_color,*p,alpha);
 
+                CM2D_INSTRUMENT_PIXELS(1);
+                MarkDirty(x,y,x+1,y+1);
                 return(true);
             }
 
@@ -85,51 +197,61 @@ namespace hgl
 
             bool DrawHLine(int x,int y,int length)
             {
+                CM2D_INSTRUMENT_SCOPE(HLine);
+
                 if(!bitmap)return(false);
 
-                const int width=bitmap->GetWidth();
-                const int height=bitmap->GetHeight();
+                const ClipRect cr=GetClipRect();
 
-                if(y<0||y>=height)return(false);
-                if(x>=width)return(false);
-                if(x<0){length+=x;x=0;}
-                if(x+length>width)length=width-x;
+                if(y<cr.top||y>=cr.bottom)return(false);
+                if(x>=cr.right)return(false);
+                if(x<cr.left){length-=cr.left-x;x=cr.left;}
+                if(x+length>cr.right)length=cr.right-x;
 
                 if(length<=0)return(false);
 
-                T *p=bitmap->GetData(x,y);
-
-                for(int i=0;i<length;i++)
-                    *p++=(*blend)(draw_color,*p,alpha);
+                blend.BlendSpan(draw_color,bitmap->GetData(x,y),length,alpha);
 
+                CM2D_INSTRUMENT_PIXELS(length);
+                MarkDirty(x,y,x+length,y+1);
                 return(true);
             }
 
             bool DrawBar(int l,int t,int w,int h)
             {
+                CM2D_INSTRUMENT_SCOPE(Bar);
+
                 if(!bitmap)return(false);
 
-                const int width=bitmap->GetWidth();
-                const int height=bitmap->GetHeight();
+                const int line_pixels=bitmap->GetLinePixels();
+                const ClipRect cr=GetClipRect();
 
-                if(l>=width||t>=height)return(false);
+                if(l>=cr.right||t>=cr.bottom)return(false);
 
-                if(l<0){w+=l;l=0;}
-                if(t<0){h+=t;t=0;}
+                if(l<cr.left){w-=cr.left-l;l=cr.left;}
+                if(t<cr.top){h-=cr.top-t;t=cr.top;}
 
-                if(l+w>width)w=width-l;
-                if(t+h>height)h=height-t;
+                if(l+w>cr.right)w=cr.right-l;
+                if(t+h>cr.bottom)h=cr.bottom-t;
 
                 if(w<=0||h<=0)return(false);
 
+                MarkDirty(l,t,l+w,t+h);
+                CM2D_INSTRUMENT_PIXELS(int64(w)*h);
+
                 T *p=bitmap->GetData(l,t);
 
-                for(int y=t;y<t+h;y++)
+                if(w==line_pixels)      //整行覆盖且没有行尾填充时，所有行是连续的
                 {
-                    for(int i=0;i<length;i++)
-                        *p++=(*blend)(draw_color,*p,alpha);
+                    blend.BlendSpan(draw_color,p,w*h,alpha);
+                    return(true);
+                }
+
+                for(int y=0;y<h;y++)
+                {
+                    blend.BlendSpan(draw_color,p,w,alpha);
 
-                    p+=width-w;
+                    p+=line_pixels;
                 }
 
                 return(true);
@@ -137,35 +259,52 @@ namespace hgl
 
             bool DrawVLine(int x,int y,int length)
             {
+                CM2D_INSTRUMENT_SCOPE(VLine);
+
                 if(!bitmap)return(false);
 
-                const int width=bitmap->GetWidth();
-                const int height=bitmap->GetHeight();
+                const int line_pixels=bitmap->GetLinePixels();
+                const ClipRect cr=GetClipRect();
 
-                if(x<0||x>=width)return(false);
-                if(y>=height)return(false);
-                if(y<0){length+=y;y=0;}
-                if(y+length>height)length=height-y;
+                if(x<cr.left||x>=cr.right)return(false);
+                if(y>=cr.bottom)return(false);
+                if(y<cr.top){length-=cr.top-y;y=cr.top;}
+                if(y+length>cr.bottom)length=cr.bottom-y;
 
                 if(length<=0)return(false);
 
-                T *p=bitmap->GetData(x,y);
-
-                for(int i=0;i<length;i++)
-                {
-                    *p=(*blend)(draw_color,*p,alpha);
-                    p+=width;
-                }
+                blend.BlendSpan(draw_color,bitmap->GetData(x,y),length,line_pixels,alpha);
 
+                CM2D_INSTRUMENT_PIXELS(length);
+                MarkDirty(x,y,x+1,y+length);
                 return(true);
             }
 
             bool DrawWireCircle(int x0,int y0,int radius)
             {
+                CM2D_INSTRUMENT_SCOPE(WireCircle);
+
                 if(!bitmap)return(false);
 
                 if(radius<=0)return(false);
 
+                const ClipRect cr=GetClipRect();
+
+                if(x0+radius<cr.left||x0-radius>=cr.right)return(false);
+                if(y0+radius<cr.top||y0-radius>=cr.bottom)return(false);
+
+                MarkDirty(x0-radius,y0-radius,x0+radius+1,y0+radius+1);
+
+                const DirtyMute mute(dirty_mute);
+
+                //整个圆都在裁剪区域内时，不再逐点检查
+                if(x0-radius>=cr.left&&x0+radius<cr.right
+                 &&y0-radius>=cr.top&&y0+radius<cr.bottom)
+                {
+                    DrawWireCircleUnchecked(bitmap->GetData(x0,y0),bitmap->GetLinePixels(),radius);
+                    return(true);
+                }
+
                 int tn;
                 int x,y;
                 int xmax;
@@ -211,40 +350,40 @@ namespace hgl
 
             bool DrawSolidCircle(int x,int y,int radius)
             {
+                CM2D_INSTRUMENT_SCOPE(SolidCircle);
+
                 if(!bitmap)return(false);
 
                 if(radius<=0)return(false);
 
-                int x0=x-radius;
-                int y0=y-radius;
-                int x1=x+radius;
-                int y1=y+radius;
+                const ClipRect cr=GetClipRect();
 
-                const int width=bitmap->GetWidth();
-                const int height=bitmap->GetHeight();
+                if(x+radius<cr.left||x-radius>=cr.right)return(false);
+                if(y+radius<cr.top||y-radius>=cr.bottom)return(false);
 
-                if(x0<0)x0=0;
-                if(y0<0)y0=0;
-                if(x1>=width)x1=width-1;
-                if(y1>=height)y1=height-1;
+                MarkDirty(x-radius,y-radius,x+radius+1,y+radius+1);
 
-                if(x0>x1||y0>y1)return(false);
+                const DirtyMute mute(dirty_mute);
 
-                int r2=radius*radius;
+                //逐行求出满足dx*dx+dy*dy<=r*r的最大半宽hw，各输出一条水平线
+                //err=hw*hw+dy*dy-r*r，随dy递增、hw递减增量更新
+                int hw=radius;
+                int err=0;
 
-                for(int cy=y0;cy<=y1;cy++)
+                for(int dy=0;dy<=radius;dy++)
                 {
-                    int dy=cy-y;
-                    int dy2=dy*dy;
-
-                    for(int cx=x0;cx<=x1;cx++)
+                    while(err>0)
                     {
-                        int dx=cx-x;
-                        int dx2=dx*dx;
-
-                        if(dx2+dy2<=r2)
-                            PutPixel(cx,cy);
+                        err-=(hw<<1)-1;
+                        --hw;
                     }
+
+                    DrawHLine(x-hw,y+dy,(hw<<1)+1);
+
+                    if(dy)
+                        DrawHLine(x-hw,y-dy,(hw<<1)+1);
+
+                    err+=(dy<<1)+1;
                 }
 
                 return(true);
@@ -252,13 +391,26 @@ namespace hgl
 
             void DrawLine(int x1, int y1, int x2, int y2)
             {
-                int p, n, x, y, tn;
+                CM2D_INSTRUMENT_SCOPE(Line);
+
+                int t;
+
+                if(!bitmap)return;
+
+                const ClipRect cr=GetClipRect();
+
+                if(GetOutCode(cr,x1,y1)&GetOutCode(cr,x2,y2))       //两端点在同一侧外部
+                    return;
+
+                MarkDirty(x1<x2?x1:x2,y1<y2?y1:y2,(x1<x2?x2:x1)+1,(y1<y2?y2:y1)+1);
+
+                const DirtyMute mute(dirty_mute);
 
                 if(y1==y2)
                 {
                     if(x1>x2)
                     {
-                        x=x2;x2=x1;x1=x;
+                        t=x2;x2=x1;x1=t;
                     }
 
                     DrawHLine(x1, y1, x2-x1+1);
@@ -269,7 +421,7 @@ namespace hgl
                 {
                     if(y1>y2)
                     {
-                        y=y2;y2=y1;y1=y;
+                        t=y2;y2=y1;y1=t;
                     }
 
                     DrawVLine(x1, y1, y2-y1+1);
@@ -278,73 +430,26 @@ namespace hgl
 
                 if(abs(y2-y1)<=abs(x2-x1))
                 {
-                    if((y2<y1&&x2<x1)||(y1<=y2&&x1>x2))
-                    {
-                        x=x2;y=y2;x2=x1;y2=y1;x1=x;y1=y;
-                    }
-
-                    if(y2>=y1&&x2>=x1)
+                    if(x1>x2)
                     {
-                        x=x2-x1;y=y2-y1;
-                        p=2*y;n=2*x-2*y;tn=x;
-
-                        while(x1<=x2)
-                        {
-                            if(tn>=0)tn-=p;
-                            else { tn+=n;y1++; }
-
-                            PutPixel(x1++, y1);
-                        }
+                        t=x2;x2=x1;x1=t;
+                        t=y2;y2=y1;y1=t;
                     }
-                    else
-                    {
-                        x=x2-x1;y=y2-y1;
-                        p=-2*y;n=2*x+2*y;tn=x;
-                        while(x1<=x2)
-                        {
-                            if(tn>=0)tn-=p;
-                            else { tn+=n;y1--; }
 
-                            PutPixel(x1++, y1);
-                        }
-                    }
+                    DrawLineMajor(cr,x1,y1,x2-x1,y2-y1,false);
                 }
                 else
                 {
-                    x=x1;x1=y2;y2=x;y=y1;y1=x2;x2=y;
-
-                    if((y2<y1&&x2<x1)||(y1<=y2&&x1>x2))
-                    {
-                        x=x2;y=y2;x2=x1;y2=y1;x1=x;y1=y;
-                    }
-
-                    if(y2>=y1&&x2>=x1)
+                    if(y1>y2)
                     {
-                        x=x2-x1;y=y2-y1;p=2*y;n=2*x-2*y;tn=x;
-
-                        while(x1<=x2)
-                        {
-                            if(tn>=0)tn-=p;
-                            else { tn+=n;y1++; }
-
-                            PutPixel(y1, x1++);
-                        }
+                        t=x2;x2=x1;x1=t;
+                        t=y2;y2=y1;y1=t;
                     }
-                    else
-                    {
-                        x=x2-x1;y=y2-y1;p=-2*y;n=2*x+2*y;tn=x;
-
-                        while(x1<=x2)
-                        {
-                            if(tn>=0)tn-=p;
-                            else { tn+=n;y1--; }
 
-                            PutPixel(y1, x1++);
-                        }
-                    }
+                    DrawLineMajor(cr,y1,x1,y2-y1,x2-x1,true);
                 }
             }
-            
+
             void DrawLine(const Vector2i &start,const Vector2i &end)
             {
                 DrawLine(start.x,start.y,end.x,end.y);
@@ -358,6 +463,15 @@ namespace hgl
                 int tn, x, y;
                 int xmax;
 
+                CM2D_INSTRUMENT_SCOPE(Sector);
+
+                if(!bitmap)return;
+                if(!r)return;                                                   //半径为0时下面的八分圆算法会写到包围盒之外
+
+                MarkDirty(x0-int(r),y0-int(r),x0+int(r)+1,y0+int(r)+1);
+
+                const DirtyMute mute(dirty_mute);
+
                 y=r; x=0;
                 xmax=(int)(r*HGL_SIN_45);
                 tn=(1-r*2);
@@ -444,47 +558,712 @@ namespace hgl
                 }
             }
 
-            void DrawMonoBitmap(const int left,const int top,const uint8 *data,const int w,const int h)
+        protected:
+
+            enum
             {
-                if(!data)return;
+                OUT_LEFT    =1,
+                OUT_RIGHT   =2,
+                OUT_TOP     =4,
+                OUT_BOTTOM  =8
+            };
+
+            /**
+             * 求Cohen-Sutherland区域码
+             */
+            static int GetOutCode(const ClipRect &cr,const int x,const int y)
+            {
+                int code=0;
 
-                if(left<0||left>=bitmap->GetWidth()-w)return;
-                if(top<0||top>=bitmap->GetHeight()-h)return;
+                if(x<cr.left)code|=OUT_LEFT;else if(x>=cr.right)code|=OUT_RIGHT;
+                if(y<cr.top)code|=OUT_TOP;else if(y>=cr.bottom)code|=OUT_BOTTOM;
 
-                const uint8 *sp=data;
-                uint8 bit;
-                T *tp=bitmap->GetData(left,top);
+                return code;
+            }
+
+            /**
+             * 沿主轴u绘制Bresenham直线(需保证0<|dv|<=du)
+             * @param u0,v0 起点的主轴/次轴坐标
+             * @param du 主轴长度
+             * @param dv 次轴变化量(可为负)
+             * @param steep 为true时主轴为y轴，否则为x轴
+             */
+            void DrawLineMajor(const ClipRect &cr,const int u0,const int v0,const int du,const int dv,const bool steep)
+            {
+                const int line_pixels=bitmap->GetLinePixels();
+
+                const int umin=(steep?cr.top:cr.left);
+                const int vmin=(steep?cr.left:cr.top);
+                const int umax=(steep?cr.bottom:cr.right)-1;
+                const int vmax=(steep?cr.right:cr.bottom)-1;
+
+                const int64 a=(dv<0?-dv:dv);
+                const int64 du2=int64(du)<<1;
+                const int vs=(dv<0?-1:1);
+
+                //第k个点为(u0+k,v0+vs*m(k))，其中m(k)=ceil((2a*k-du)/(2du))。
+                //据此直接求出落在位图内的k范围，范围内逐点步进指针，不再检查边界
+                int64 k0=0,k1=du;
+
+                if(u0<umin)k0=umin-u0;
+                if(u0+du>umax)k1=umax-u0;
+
+                const int64 mlo=(vs>0)?vmin-v0:v0-vmax;     //m允许的范围
+                const int64 mhi=(vs>0)?vmax-v0:v0-vmin;
+
+                if(mhi<0)return;
+
+                if(mlo>0)
+                {
+                    const int64 k=(du*(2*mlo-1))/(2*a)+1;
+
+                    if(k>k0)k0=k;
+                }
+
+                {
+                    const int64 k=(du*(2*mhi+1))/(2*a);
+
+                    if(k<k1)k1=k;
+                }
+
+                if(k0>k1)return;
+
+                CM2D_INSTRUMENT_PIXELS(k1-k0+1);
+
+                const int64 n=2*a*k0-du;
+                const int64 m=(n<=0)?0:(n+du2-1)/du2;
+
+                int64 err=du2*m-n;                          //取值[0,2du)
+
+                const int ustep=steep?line_pixels:1;
+                const int vstep=(steep?1:line_pixels)*vs;
+
+                T *p=steep?bitmap->GetData(v0+vs*int(m),u0+int(k0))
+                          :bitmap->GetData(u0+int(k0),v0+vs*int(m));
+
+                for(int64 k=k0;;)
+                {
+                    *p=blend.Blend(draw_color,*p,alpha);
+
+                    if(++k>k1)break;
+
+                    p+=ustep;
+                    err-=2*a;
+
+                    if(err<0)
+                    {
+                        err+=du2;
+                        p+=vstep;
+                    }
+                }
+            }
+
+            /**
+             * 绘制完全位于位图内的圆，不做边界检查
+             * @param center 圆心象素指针
+             * @param pitch 每行象素数
+             */
+            void DrawWireCircleUnchecked(T *center,const int pitch,const int radius)
+            {
+                int tn;
+                int x,y;
+                int xmax;
 
-                const uint line_wrap=bitmap->GetWidth()-w;
+                y=radius;
+                x=0;
+                xmax=int(radius*HGL_SIN_45);
+                tn=(1-radius*2);
 
-                bit=1<<7;
+                #define DRAW_CIRCLE_8_POINT  { \
+                                                T *p; \
+                                                p=center+x*pitch+y;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center+y*pitch+x;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center+y*pitch-x;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center+x*pitch-y;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center-x*pitch-y;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center-y*pitch-x;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center-y*pitch+x;*p=blend.Blend(draw_color,*p,alpha);    \
+                                                p=center-x*pitch+y;*p=blend.Blend(draw_color,*p,alpha);    \
+                                            }
 
-                for(int row=0;row<h;row++)
+                while(x<=xmax)
                 {
-                    for(int col=0;col<w;col++)
+                    if(tn>=0)
                     {
-                        if(*sp&bit)
+                        tn+=(6+((x-y)<<2));
+                        y--;
+                    }
+                    else
+                        tn+=((x<<2)+2);
+
+                    DRAW_CIRCLE_8_POINT
+
+                    x++;
+                }
+
+                DRAW_CIRCLE_8_POINT
+
+                CM2D_INSTRUMENT_PIXELS((x+1)*8);
+
+                #undef DRAW_CIRCLE_8_POINT
+            }
+
+            /**
+             * 扇形的一条边界在某一行上形成的半直线区间[lo,hi]
+             */
+            struct SectorEdgeRange
+            {
+                int lo,hi;
+            };
+
+            /**
+             * 求出满足 a*dx<=b 的dx区间
+             */
+            static SectorEdgeRange GetHalfLine(const double a,const double b)
+            {
+                constexpr double eps=1e-9;
+                constexpr double limit=1e9;        //避免a接近0时换算int溢出
+
+                if(a>eps||a<-eps)
+                {
+                    double v=b/a;
+
+                    if(v>limit)v=limit;else if(v<-limit)v=-limit;
+
+                    return (a>0)?SectorEdgeRange{INT_MIN,int(floor(v+eps))}
+                                :SectorEdgeRange{int(ceil(v-eps)),INT_MAX};
+                }
+
+                return (b>=-eps)?SectorEdgeRange{INT_MIN,INT_MAX}:SectorEdgeRange{1,0};
+            }
+
+            void DrawSpan(const int x0,const int y,int l,int r,const SectorEdgeRange &range)
+            {
+                if(l<range.lo)l=range.lo;
+                if(r>range.hi)r=range.hi;
+
+                if(l<=r)
+                    DrawHLine(x0+l,y,r-l+1);
+            }
+
+            /**
+             * 绘制扇形中的一行
+             * @param hw 本行圆的半宽
+             * @param dy 本行相对圆心的偏移(屏幕坐标，向下为正)
+             * @param sc,ss 起始角的cos/sin
+             * @param ec,es 结束角的cos/sin
+             * @param less_than_half 扇形张角是否不超过180度
+             */
+            void DrawSectorRow(int x0,int y0,int hw,int dy,double sc,double ss,double ec,double es,bool less_than_half)
+            {
+                //以y轴向上的坐标(dx,-dy)判断，点在起始边逆时针一侧: ss*dx<=-sc*dy
+                //                                  点在结束边顺时针一侧: -es*dx<=ec*dy
+                const SectorEdgeRange sr=GetHalfLine(ss,-sc*dy);
+                const SectorEdgeRange er=GetHalfLine(-es,ec*dy);
+
+                if(less_than_half)
+                {
+                    DrawSpan(x0,y0+dy,(sr.lo>-hw?sr.lo:-hw),(sr.hi<hw?sr.hi:hw),er);
+                    return;
+                }
+
+                //超过180度为两个半平面的并集，先画起始边区间，再画结束边区间中不与其重叠的部分
+                DrawSpan(x0,y0+dy,-hw,hw,sr);
+
+                if(sr.lo>sr.hi)
+                {
+                    DrawSpan(x0,y0+dy,-hw,hw,er);
+                }
+                else
+                {
+                    if(sr.lo>-hw)DrawSpan(x0,y0+dy,-hw,(sr.lo<=hw?sr.lo-1:hw),er);
+                    if(sr.hi< hw)DrawSpan(x0,y0+dy,(sr.hi>=-hw?sr.hi+1:-hw),hw,er);
+                }
+            }
+
+        public:
+
+            /**
+             * 绘制实心扇形
+             * @param x0,y0 圆心
+             * @param r 半径
+             * @param stangle 起始角度(0度为正右方，逆时针方向)
+             * @param endangle 结束角度
+             */
+            bool DrawSolidSector(int x0,int y0,uint r,uint stangle,uint endangle)
+            {
+                CM2D_INSTRUMENT_SCOPE(SolidSector);
+
+                if(!bitmap)return(false);
+                if(r<=0)return(false);
+
+                const uint sweep=(endangle>=stangle)?(endangle-stangle>=360?360:endangle-stangle)                 //先以未化简的角度求扫过的角度
+                                                    :(endangle%360+360-stangle%360)%360;
+
+                stangle%=360;
+
+                if(sweep==0)return(false);
+                if(sweep==360)return DrawSolidCircle(x0,y0,r);
+
+                const int radius=r;
+                const ClipRect cr=GetClipRect();
+
+                if(x0+radius<cr.left||x0-radius>=cr.right)return(false);
+                if(y0+radius<cr.top||y0-radius>=cr.bottom)return(false);
+
+                MarkDirty(x0-radius,y0-radius,x0+radius+1,y0+radius+1);
+
+                const DirtyMute mute(dirty_mute);
+
+                const double sc=Lcos(stangle);
+                const double ss=Lsin(stangle);
+                const double ec=Lcos((stangle+sweep)%360);                     //Lcos/Lsin为按度查表，只接受0-359
+                const double es=Lsin((stangle+sweep)%360);
+                const bool less_than_half=(sweep<=180);
+
+                int hw=radius;
+                int err=0;
+
+                for(int dy=0;dy<=radius;dy++)
+                {
+                    while(err>0)
+                    {
+                        err-=(hw<<1)-1;
+                        --hw;
+                    }
+
+                    DrawSectorRow(x0,y0,hw,dy,sc,ss,ec,es,less_than_half);
+
+                    if(dy)
+                        DrawSectorRow(x0,y0,hw,-dy,sc,ss,ec,es,less_than_half);
+
+                    err+=(dy<<1)+1;
+                }
+
+                return(true);
+            }
+
+            /**
+             * 以当前颜色和混合方式输出光栅化器中的覆盖率数据
+             */
+            bool FillCoverage(CoverageRasterizer &cr)
+            {
+                if(!bitmap)return(false);
+
+                if(!cr.BeginSweep())return(false);
+
+                const ClipRect clip=GetClipRect();
+
+                CoverageSpan span;
+                int l,r;
+                ClipRect bound{INT_MAX,INT_MAX,INT_MIN,INT_MIN};                //实际输出的范围
+
+                while(cr.SweepScanline(span))
+                {
+                    if(span.y<clip.top||span.y>=clip.bottom)continue;
+
+                    l=(span.x>clip.left?span.x:clip.left);
+                    r=(span.x+span.count<clip.right?span.x+span.count:clip.right);
+
+                    if(l<r)
+                    {
+                        blend.BlendCoverageSpan(draw_color,bitmap->GetData(l,span.y),span.coverage+(l-span.x),r-l,alpha);
+                        CM2D_INSTRUMENT_PIXELS(r-l);
+
+                        if(l<bound.left)bound.left=l;
+                        if(r>bound.right)bound.right=r;
+                        if(span.y<bound.top)bound.top=span.y;
+                        if(span.y>=bound.bottom)bound.bottom=span.y+1;
+                    }
+                }
+
+                if(!bound.IsEmpty())
+                    MarkDirty(bound.left,bound.top,bound.right,bound.bottom);
+
+                return(true);
+            }
+
+            /**
+             * 绘制抗锯齿直线
+             * @param line_width 线宽(象素)
+             */
+            bool DrawAALine(const float x1,const float y1,const float x2,const float y2,const float line_width=1)
+            {
+                CM2D_INSTRUMENT_SCOPE(AALine);
+
+                if(!bitmap)return(false);
+
+                rasterizer.Reset(bitmap->GetWidth(),bitmap->GetHeight());
+                rasterizer.AddThickLine(x1,y1,x2,y2,line_width);
+
+                return FillCoverage(rasterizer);
+            }
+
+            bool DrawAALine(const Vector2f &start,const Vector2f &end,const float line_width=1)
+            {
+                return DrawAALine(start.x,start.y,end.x,end.y,line_width);
+            }
+
+            /**
+             * 绘制抗锯齿实心多边形(非零环绕规则)
+             */
+            bool DrawAAPolygon(const Vector2f *points,const int count)
+            {
+                CM2D_INSTRUMENT_SCOPE(AAPolygon);
+
+                if(!bitmap||!points||count<3)return(false);
+
+                rasterizer.Reset(bitmap->GetWidth(),bitmap->GetHeight());
+                rasterizer.AddPolygon(points,count);
+
+                return FillCoverage(rasterizer);
+            }
+
+            /**
+             * 绘制抗锯齿实心圆
+             */
+            bool DrawAASolidCircle(const float x,const float y,const float radius)
+            {
+                CM2D_INSTRUMENT_SCOPE(AASolidCircle);
+
+                if(!bitmap||radius<=0)return(false);
+
+                rasterizer.Reset(bitmap->GetWidth(),bitmap->GetHeight());
+                rasterizer.AddCircle(x,y,radius);
+
+                return FillCoverage(rasterizer);
+            }
+
+            /**
+             * 绘制抗锯齿圆环
+             * @param line_width 线宽(象素)，以radius为中心向内外各扩展一半
+             */
+            bool DrawAAWireCircle(const float x,const float y,const float radius,const float line_width=1)
+            {
+                CM2D_INSTRUMENT_SCOPE(AAWireCircle);
+
+                if(!bitmap||radius<=0)return(false);
+
+                rasterizer.Reset(bitmap->GetWidth(),bitmap->GetHeight());
+                rasterizer.AddRing(x,y,radius,line_width);
+
+                return FillCoverage(rasterizer);
+            }
+
+            /**
+             * 以当前颜色和混合方式输出多边形光栅化器中的象素段
+             */
+            bool FillSpans(PolygonRasterizer &pr)
+            {
+                if(!bitmap)return(false);
+
+                if(!pr.BeginSweep())return(false);
+
+                const ClipRect clip=GetClipRect();
+
+                ScanSpan span;
+                int l,r;
+                ClipRect bound{INT_MAX,INT_MAX,INT_MIN,INT_MIN};                //实际输出的范围
+
+                while(pr.SweepSpan(span))
+                {
+                    if(span.y<clip.top||span.y>=clip.bottom)continue;
+
+                    l=(span.left>clip.left?span.left:clip.left);
+                    r=(span.right<clip.right?span.right:clip.right);
+
+                    if(l<r)
+                    {
+                        blend.BlendSpan(draw_color,bitmap->GetData(l,span.y),r-l,alpha);
+                        CM2D_INSTRUMENT_PIXELS(r-l);
+
+                        if(l<bound.left)bound.left=l;
+                        if(r>bound.right)bound.right=r;
+                        if(span.y<bound.top)bound.top=span.y;
+                        if(span.y>=bound.bottom)bound.bottom=span.y+1;
+                    }
+                }
+
+                if(!bound.IsEmpty())
+                    MarkDirty(bound.left,bound.top,bound.right,bound.bottom);
+
+                return(true);
+            }
+
+            /**
+             * 绘制实心多边形(无抗锯齿)，象素中心在多边形内的象素被填充，边上的象素按左上规则处理
+             */
+            bool DrawSolidPolygon(const Vector2f *points,const int count,const FillRule rule=FillRule::NonZero)
+            {
+                CM2D_INSTRUMENT_SCOPE(SolidPolygon);
+
+                if(!bitmap||!points||count<3)return(false);
+
+                polygon_rasterizer.Reset(bitmap->GetWidth(),bitmap->GetHeight());
+                polygon_rasterizer.SetFillRule(rule);
+                polygon_rasterizer.AddPolygon(points,count);
+
+                return FillSpans(polygon_rasterizer);
+            }
+
+            /**
+             * 绘制实心三角形(无抗锯齿，左上规则)，共用边的相邻三角形之间既不重叠也没有缝隙
+             * @return 是否有象素被绘制
+             */
+            bool DrawSolidTriangle(const Vector2f &v0,const Vector2f &v1,const Vector2f &v2)
+            {
+                CM2D_INSTRUMENT_SCOPE(SolidTriangle);
+
+                if(!bitmap)return(false);
+
+                const ClipRect clip=GetClipRect();
+
+                ClipRect bound{INT_MAX,INT_MAX,INT_MIN,INT_MIN};
+
+                ScanTriangle(v0,v1,v2,clip.left,clip.top,clip.right,clip.bottom,[this,&bound](const int y,const int l,const int r)
+                {
+                    blend.BlendSpan(draw_color,bitmap->GetData(l,y),r-l,alpha);
+                    CM2D_INSTRUMENT_PIXELS(r-l);
+
+                    if(l<bound.left)bound.left=l;
+                    if(r>bound.right)bound.right=r;
+                    if(y<bound.top)bound.top=y;
+                    bound.bottom=y+1;
+                });
+
+                if(bound.IsEmpty())return(false);
+
+                MarkDirty(bound.left,bound.top,bound.right,bound.bottom);
+                return(true);
+            }
+
+            /**
+             * 批量绘制三角形列表
+             * @param vertices 顶点
+             * @param vertex_count 顶点数量
+             * @param indices 每3个一组的顶点索引，为nullptr时每3个连续的顶点为一个三角形
+             * @param index_count 索引数量
+             * @return 有象素被绘制的三角形数量
+             */
+            int DrawSolidTriangles(const Vector2f *vertices,const int vertex_count,const uint *indices=nullptr,const int index_count=0)
+            {
+                CM2D_INSTRUMENT_SCOPE(SolidTriangle);
+
+                if(!bitmap||!vertices||vertex_count<3)return(0);
+
+                int result=0;
+
+                if(!indices)
+                {
+                    for(int i=0;i+2<vertex_count;i+=3)
+                        if(DrawSolidTriangle(vertices[i],vertices[i+1],vertices[i+2]))
+                            ++result;
+
+                    return result;
+                }
+
+                for(int i=0;i+2<index_count;i+=3)
+                {
+                    if(indices[i  ]>=uint(vertex_count)
+                     ||indices[i+1]>=uint(vertex_count)
+                     ||indices[i+2]>=uint(vertex_count))
+                        continue;
+
+                    if(DrawSolidTriangle(vertices[indices[i]],vertices[indices[i+1]],vertices[indices[i+2]]))
+                        ++result;
+                }
+
+                return result;
+            }
+
+        protected:
+
+            /**
+             * 以当前颜色绘制一行单色位数据中为1的象素，相邻为1的位合并为一段BlendSpan
+             * @param table GetMonoByteRuns()的结果
+             * @param tp 第一个象素
+             * @param data 位数据
+             * @param bit 起始位序号(高位在前)
+             * @param count 象素数量
+             */
+            void DrawMonoRow(const MonoByteRuns *table,T *tp,const uint8 *data,const size_t bit,const int count)
+            {
+                int run_start=-1;                                               //尚未结束的一段，它一直延续到上一字节的末尾
+
+                for(int col=0;col<count;col+=8)
+                {
+                    const size_t b=bit+col;
+                    const uint shift=uint(b&7);
+                    const int n=(count-col<8?count-col:8);
+
+                    const uint8 *p=data+(b>>3);
+                    uint v=uint(*p)<<shift;
+
+                    if(shift&&n>int(8-shift))                                   //只在确实需要时读取下一字节，不越界
+                        v|=p[1]>>(8-shift);
+
+                    v&=(0xFF00>>n)&0xFF;
+
+                    if(v==0)
+                    {
+                        if(run_start>=0)
+                        {
+                            blend.BlendSpan(draw_color,tp+run_start,col-run_start,alpha);
+                            run_start=-1;
+                        }
+
+                        continue;
+                    }
+
+                    if(v==0xFF)
+                    {
+                        if(run_start<0)run_start=col;
+                        continue;
+                    }
+
+                    const MonoByteRuns &runs=table[v];
+
+                    for(uint i=0;i<runs.count;i++)
+                    {
+                        const int rs=col+runs.start[i];
+                        const int re=rs+runs.length[i];
+
+                        if(run_start>=0&&rs!=col)
                         {
-                            *tp=(*blend)(draw_color,*tp,alpha);
+                            blend.BlendSpan(draw_color,tp+run_start,col-run_start,alpha);
+                            run_start=-1;
                         }
 
-                        ++tp;
+                        if(run_start<0)
+                            run_start=rs;
 
-                        bit>>=1;
-                        if(bit==0)
+                        if(re<col+8)
                         {
-                            ++sp;
-                            bit=1<<7;
+                            blend.BlendSpan(draw_color,tp+run_start,re-run_start,alpha);
+                            run_start=-1;
                         }
                     }
+                }
+
+                if(run_start>=0)
+                    blend.BlendSpan(draw_color,tp+run_start,count-run_start,alpha);
+            }
 
-                    tp+=line_wrap;
+            /**
+             * 绘制一个字形，cr为实际裁剪区域
+             */
+            bool DrawGlyph(const ClipRect &cr,const GlyphBitmap &glyph,const int x,const int y)
+            {
+                if(glyph.IsEmpty())return(false);
+
+                const int l=(x>cr.left?x:cr.left);
+                const int t=(y>cr.top?y:cr.top);
+                const int r=(x+glyph.width<cr.right?x+glyph.width:cr.right);
+                const int b=(y+glyph.height<cr.bottom?y+glyph.height:cr.bottom);
+
+                if(l>=r||t>=b)return(false);
+
+                MarkDirty(l,t,r,b);
+                CM2D_INSTRUMENT_PIXELS(int64(r-l)*(b-t));
+
+                const int line_pixels=bitmap->GetLinePixels();
+                const int cw=r-l;
+                const int skip_x=l-x;
+
+                T *tp=bitmap->GetData(l,t);
+
+                if(glyph.format==GlyphFormat::Alpha8)
+                {
+                    const size_t lb=(glyph.line_bytes?glyph.line_bytes:uint(glyph.width));
+                    const uint8 *sp=glyph.data+size_t(t-y)*lb+skip_x;
+
+                    for(int row=t;row<b;row++)
+                    {
+                        blend.BlendCoverageSpan(draw_color,tp,sp,cw,alpha);
+
+                        sp+=lb;
+                        tp+=line_pixels;
+                    }
                 }
+                else
+                {
+                    const size_t line_bits=(glyph.line_bytes?size_t(glyph.line_bytes)<<3:size_t(glyph.width));
+
+                    const MonoByteRuns *table=GetMonoByteRuns();
+
+                    size_t bit=size_t(t-y)*line_bits+skip_x;
+
+                    for(int row=t;row<b;row++)
+                    {
+                        DrawMonoRow(table,tp,glyph.data,bit,cw);
+
+                        bit+=line_bits;
+                        tp+=line_pixels;
+                    }
+                }
+
+                return(true);
+            }
+
+        public:
+
+            /**
+             * 以当前颜色绘制一个字形，超出裁剪区域的部分被裁掉
+             */
+            bool DrawGlyph(const GlyphBitmap &glyph,const int x,const int y)
+            {
+                CM2D_INSTRUMENT_SCOPE(Glyph);
+
+                if(!bitmap)return(false);
+
+                return DrawGlyph(GetClipRect(),glyph,x,y);
+            }
+
+            /**
+             * 以当前颜色批量绘制字形
+             * @return 实际绘制(未被完全裁掉)的字形数量
+             */
+            int DrawGlyphs(const GlyphDraw *list,const int count)
+            {
+                CM2D_INSTRUMENT_SCOPE(Glyph);
+
+                if(!bitmap||!list||count<=0)return(0);
+
+                const ClipRect cr=GetClipRect();
+
+                int result=0;
+
+                for(int i=0;i<count;i++)
+                    if(list[i].glyph&&DrawGlyph(cr,*list[i].glyph,list[i].x,list[i].y))
+                        ++result;
+
+                return result;
+            }
+
+            /**
+             * 绘制单色位图，各行的位数据连续存放不按字节对齐，超出裁剪区域的部分被裁掉
+             */
+            void DrawMonoBitmap(const int left,const int top,const uint8 *data,const int w,const int h)
+            {
+                if(!data)return;
+
+                DrawGlyph(GlyphBitmap(GlyphFormat::Mono,w,h,data),left,top);
             }
-        };//template<typename T,uint CHANNELS> class DrawGeometry
+        };//template<typename T,typename FormatBitmap,typename BlendPolicy> class DrawGeometry
 
         using DrawGeometryU32=DrawGeometry<uint32,BitmapU32>;
         using DrawGeometryRGB8=DrawGeometry<Vector3u8,BitmapRGB8>;
         using DrawGeometryRGBA8=DrawGeometry<Vector4u8,BitmapRGBA8>;
+
+        using DrawGeometryViewU32=DrawGeometry<uint32,BitmapViewU32>;
+        using DrawGeometryViewRGB8=DrawGeometry<Vector3u8,BitmapViewRGB8>;
+        using DrawGeometryViewRGBA8=DrawGeometry<Vector4u8,BitmapViewRGBA8>;
+
+        using DrawGeometryU32Opaque=DrawGeometry<uint32,BitmapU32,BlendPolicyOpaque<uint32>>;
+        using DrawGeometryRGB8Opaque=DrawGeometry<Vector3u8,BitmapRGB8,BlendPolicyOpaque<Vector3u8>>;
+        using DrawGeometryRGBA8Opaque=DrawGeometry<Vector4u8,BitmapRGBA8,BlendPolicyOpaque<Vector4u8>>;
+
+        using DrawGeometryU32Additive=DrawGeometry<uint32,BitmapU32,BlendPolicyAdditiveU32>;
+        using DrawGeometryRGBA8Alpha=DrawGeometry<Vector4u8,BitmapRGBA8,BlendPolicyAlphaRGBA8>;
     }//namespace bitmap
 }//namespace hgl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<hgl/type/String.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 只读的内存映射文件
+         */
+        class FileMapping
+        {
+            const void *data;
+            int64 size;
+
+#ifdef _WIN32
+            void *file_handle;
+            void *map_handle;
+#endif//_WIN32
+
+        public:
+
+            FileMapping();
+            ~FileMapping(){Close();}
+
+            FileMapping(const FileMapping &)=delete;
+            FileMapping &operator=(const FileMapping &)=delete;
+
+            bool Open(const OSString &filename);
+            void Close();
+
+            const bool IsOpen()const{return data!=nullptr;}
+
+            const void *GetData()const{return data;}
+            const int64 GetSize()const{return size;}
+        };//class FileMapping
+    }//namespace bitmap
+}//namespace hgl
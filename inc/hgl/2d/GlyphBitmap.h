@@ -0,0 +1,67 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        enum class GlyphFormat
+        {
+            Mono,                                                               ///<每象素1位，高位在前
+            Alpha8,                                                             ///<每象素8位覆盖率(0-255)
+        };//enum class GlyphFormat
+
+        /**
+         * 字形位图(不持有数据)
+         */
+        struct GlyphBitmap
+        {
+            GlyphFormat format=GlyphFormat::Mono;
+
+            int width=0,height=0;
+
+            uint line_bytes=0;                                                  ///<每行字节数，为0时Mono各行的位数据连续存放不按字节对齐，Alpha8每行为width字节
+
+            const uint8 *data=nullptr;
+
+        public:
+
+            GlyphBitmap()=default;
+            GlyphBitmap(const GlyphFormat gf,const int w,const int h,const uint8 *d,const uint lb=0)
+            {
+                format=gf;
+                width=w;
+                height=h;
+                line_bytes=lb;
+                data=d;
+            }
+
+            const bool IsEmpty()const{return !data||width<=0||height<=0;}
+        };//struct GlyphBitmap
+
+        /**
+         * 批量绘制时的一个字形
+         */
+        struct GlyphDraw
+        {
+            const GlyphBitmap *glyph;
+            int x,y;                                                            ///<字形左上角位置
+        };//struct GlyphDraw
+
+        /**
+         * 一个字节中连续为1的位段(高位在前，最多4段)
+         */
+        struct MonoByteRuns
+        {
+            uint8 count;
+            uint8 start[4];
+            uint8 length[4];
+        };//struct MonoByteRuns
+
+        /**
+         * 取得256个字节值各自的位段表
+         */
+        const MonoByteRuns *GetMonoByteRuns();
+    }//namespace bitmap
+}//namespace hgl
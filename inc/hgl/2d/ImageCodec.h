@@ -0,0 +1,199 @@
+#pragma once
+
+#include<hgl/2d/BitmapLoad.h>
+#include<hgl/2d/BitmapSave.h>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        constexpr uint IMAGE_CODEC_MAX_HEADER_BYTES=64;                         ///<识别格式时最多读取的文件头字节数
+
+        class ImageCodec;
+        class TaskPool;
+
+        /**
+         * 图片基本信息，只需读取文件头即可得到
+         */
+        struct ImageInfo
+        {
+            const ImageCodec *codec=nullptr;
+
+            uint width=0;
+            uint height=0;
+            uint channels=0;                                                    ///<解码后的通道数
+            uint channel_bits=0;                                                ///<解码后每通道位数
+
+            uint file_pixel_bits=0;                                             ///<文件中每象素位数(调色板图片为索引位数)
+
+            bool bottom_up=false;                                               ///<文件中的行是否从下往上存放
+            bool compressed=false;
+            bool color_map=false;
+        };//struct ImageInfo
+
+        /**
+         * 图片编解码器<br>
+         * 解码通过BitmapLoader按行送出数据，所以任何编解码器都可以直接载入到各种Bitmap或自定义的接收器中。
+         */
+        class ImageCodec
+        {
+        public:
+
+            virtual ~ImageCodec()=default;
+
+            virtual const char *GetName()const=0;                               ///<格式名称，如"TGA"
+            virtual const char *GetExtName()const=0;                            ///<文件扩展名(不含点)，如"tga"
+
+            virtual const uint GetHeaderBytes()const=0;                         ///<识别格式所需的文件头字节数，不超过IMAGE_CODEC_MAX_HEADER_BYTES
+
+            /**
+             * 根据文件头判断是否为本格式
+             * @param header 文件开头数据
+             * @param size 数据长度，可能小于GetHeaderBytes()
+             */
+            virtual bool CheckHeader(const uint8 *header,const uint size)const=0;
+
+            /**
+             * 从文件头中取得图片信息，codec成员由调用者填写
+             */
+            virtual bool Probe(const uint8 *header,const uint size,ImageInfo *info)const{return(false);}
+
+            virtual bool Load(io::InputStream *,BitmapLoader *)const=0;
+
+            virtual bool CanSave(const uint channels,const uint channel_bits)const{return(false);}
+
+            /**
+             * @param line_bytes 数据每行跨度字节数，为0时表示各行连续存放
+             * @param bottom_up 数据是否从下往上存放(data为最下面一行)
+             */
+            virtual bool Save(io::OutputStream *,const void *data,uint width,uint height,uint channels,uint channel_bits,uint line_bytes,bool bottom_up)const{return(false);}
+        };//class ImageCodec
+
+        /**
+         * 注册编解码器，codec须在程序结束前一直有效<br>
+         * 识别格式时后注册的编解码器优先，内置的编解码器为TGA与QOI。
+         */
+        void RegisterImageCodec(const ImageCodec *codec);
+
+        /**
+         * 按格式名称或扩展名查找编解码器(不区分大小写)
+         */
+        const ImageCodec *GetImageCodec(const char *name);
+
+        /**
+         * 根据文件头识别格式
+         */
+        const ImageCodec *DetectImageCodec(const uint8 *header,const uint size);
+
+        /**
+         * 根据流开头的数据识别格式，不会改变流的读取位置<br>
+         * 流须支持Peek或Seek。
+         */
+        const ImageCodec *DetectImageCodec(io::InputStream *is);
+
+        /**
+         * 只读取文件头取得图片信息，不解码象素<br>
+         * 流支持Peek或Seek时读取位置不变，之后仍可直接载入。
+         */
+        bool ProbeImage(io::InputStream *is,ImageInfo *info);
+        bool ProbeImage(const OSString &filename,ImageInfo *info);
+
+        struct ImageFileInfo
+        {
+            OSString filename;
+            ImageInfo info;
+        };
+
+        /**
+         * 取得目录中所有可识别图片的信息，无法识别的文件被忽略
+         * @param folder 目录
+         * @param result 结果追加到这里
+         * @param recursive 是否包含子目录
+         * @param pool 并行读取文件头所用的任务池，可为nullptr
+         * @return 识别出的图片数量
+         */
+        uint ProbeImageFolder(const OSString &folder,std::vector<ImageFileInfo> &result,const bool recursive=false,TaskPool *pool=nullptr);
+
+        /**
+         * 识别格式并载入
+         */
+        bool LoadBitmapFromStream(io::InputStream *is,BitmapLoader *bl);
+
+        template<typename T>
+        inline bool LoadBitmap(io::InputStream *is,T *bmp)
+        {
+            if(!is||!bmp)return(false);
+
+            BitmapLoaderImpl<T> bli(bmp);
+
+            return LoadBitmapFromStream(is,&bli);
+        }
+
+        template<typename T>
+        inline T *LoadBitmap(io::InputStream *is)
+        {
+            BitmapLoaderImpl<T> bli;
+
+            if(LoadBitmapFromStream(is,&bli))
+                return bli.Detach();
+
+            return(nullptr);
+        }
+
+        template<typename T>
+        inline T *LoadBitmap(const OSString &filename)
+        {
+            io::OpenFileInputStream fis(filename);
+
+            if(!fis)
+                return(nullptr);
+
+            return LoadBitmap<T>(&fis);
+        }
+
+        template<typename T>
+        inline bool LoadBitmap(const OSString &filename,T *bmp)
+        {
+            if(!bmp)return(false);
+
+            io::OpenFileInputStream fis(filename);
+
+            if(!fis)
+                return(false);
+
+            return LoadBitmap<T>(&fis,bmp);
+        }
+
+        /**
+         * 以指定格式保存位图
+         * @param format 格式名称或扩展名
+         */
+        template<typename T,uint C>
+        inline bool SaveBitmap(io::OutputStream *os,const BitmapView<T,C> *bmp,const char *format)
+        {
+            if(!os||!bmp)return(false);
+
+            const ImageCodec *codec=GetImageCodec(format);
+
+            if(!codec||!codec->CanSave(C,bmp->GetChannelBits()))
+                return(false);
+
+            return codec->Save(os,bmp->GetMemory(),bmp->GetWidth(),bmp->GetHeight(),C,bmp->GetChannelBits(),bmp->GetLineBytes(),bmp->IsBottomUp());
+        }
+
+        template<typename T,uint C>
+        inline bool SaveBitmap(const OSString &filename,const BitmapView<T,C> *bmp,const char *format)
+        {
+            if(filename.IsEmpty()||!bmp)
+                return(false);
+
+            io::OpenFileOutputStream fos(filename,io::FileOpenMode::CreateTrunc);
+
+            if(!fos)
+                return(false);
+
+            return SaveBitmap(&fos,bmp,format);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,140 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+
+/**
+ * 可选的热点统计
+ *
+ * 定义CM2D_INSTRUMENT(CMake选项CM2D_INSTRUMENT)后，绘制图元、位图混合/Blit与TGA读写会记录调用次数、处理的象素与字节数，
+ * 并每隔若干次调用抽样计时一次；未定义时统计宏全部为空，没有任何额外开销，统计接口返回的都是0。
+ *
+ * 嵌套的操作(如实心圆内部绘制的水平线)只计入最外层，所以各项次数之和就是使用者实际的调用次数。
+ * 设置跟踪回调后每个最外层操作的开始与结束都会回调，可借此转发到Tracy/ETW/perfetto等工具。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        enum class InstrumentOp
+        {
+            PutPixel,
+            HLine,
+            VLine,
+            Bar,
+            Line,
+            WireCircle,
+            SolidCircle,
+            Sector,
+            SolidSector,
+            AALine,
+            AAPolygon,
+            AASolidCircle,
+            AAWireCircle,
+            SolidPolygon,
+            SolidTriangle,
+            Glyph,
+            BlendBitmap,
+            Blit,
+            TGALoad,
+            TGASave,
+        };//enum class InstrumentOp
+
+        constexpr uint INSTRUMENT_OP_COUNT=uint(InstrumentOp::TGASave)+1;
+
+        constexpr uint INSTRUMENT_DEFAULT_SAMPLE_INTERVAL=64;                   ///<默认每个线程每64次操作计时一次
+
+#ifdef CM2D_INSTRUMENT
+        constexpr bool INSTRUMENT_ENABLED=true;
+#else
+        constexpr bool INSTRUMENT_ENABLED=false;
+#endif//CM2D_INSTRUMENT
+
+        /**
+         * 一种操作的累计统计
+         */
+        struct InstrumentStats
+        {
+            uint64 count=0;                                                     ///<调用次数
+            uint64 pixels=0;                                                    ///<写入或处理的象素数
+            uint64 bytes=0;                                                     ///<TGA读写的象素数据字节数(按未压缩计)
+
+            uint64 sampled_count=0;                                             ///<被计时的调用次数
+            uint64 sampled_ns=0;                                                ///<被计时调用的总耗时(纳秒)
+            uint64 max_ns=0;                                                    ///<被计时调用中的最长耗时(纳秒)
+
+        public:
+
+            /**
+             * 按抽样估计的平均耗时(纳秒)
+             */
+            const double GetAverageNS()const{return sampled_count?double(sampled_ns)/double(sampled_count):0;}
+        };//struct InstrumentStats
+
+        /**
+         * 跟踪回调，在执行操作的线程中调用，应尽量简短
+         */
+        struct InstrumentTrace
+        {
+            void (*begin)(const InstrumentOp op,void *user_data)=nullptr;
+            void (*end)(const InstrumentOp op,const uint64 pixels,void *user_data)=nullptr;
+
+            void *user_data=nullptr;
+        };//struct InstrumentTrace
+
+        const char *GetInstrumentOpName(const InstrumentOp op);
+
+        /**
+         * 取得一种操作的统计，各项分别读取，与正在进行的操作之间不保证一致
+         */
+        InstrumentStats GetInstrumentStats(const InstrumentOp op);
+
+        /**
+         * 取得全部操作的统计
+         * @param stats 至少INSTRUMENT_OP_COUNT项，按InstrumentOp的顺序存放
+         */
+        void GetInstrumentStats(InstrumentStats *stats);
+
+        void ResetInstrumentStats();
+
+        /**
+         * 设置抽样计时间隔
+         * @param interval 每个线程每interval次操作计时一次，为0时不计时，为1时全部计时
+         */
+        void SetInstrumentSampleInterval(const uint interval);
+
+        /**
+         * 设置跟踪回调，须在没有其它线程进行被统计的操作时设置
+         * @param trace 为nullptr时取消，回调内容会被复制
+         */
+        void SetInstrumentTrace(const InstrumentTrace *trace);
+
+#ifdef CM2D_INSTRUMENT
+        /**
+         * 统计一次操作，在作用域结束时记录
+         */
+        class InstrumentScope
+        {
+            bool outer;                                                         ///<是否为最外层的操作
+
+        public:
+
+            InstrumentScope(const InstrumentOp op);
+            ~InstrumentScope();
+
+            InstrumentScope(const InstrumentScope &)=delete;
+            InstrumentScope &operator=(const InstrumentScope &)=delete;
+        };//class InstrumentScope
+
+        void InstrumentAddPixels(const uint64 pixels);                          ///<计入当前操作的象素数
+        void InstrumentAddBytes(const uint64 bytes);                            ///<计入当前操作的字节数
+
+        #define CM2D_INSTRUMENT_SCOPE(op)       const hgl::bitmap::InstrumentScope cm2d_instrument_scope(hgl::bitmap::InstrumentOp::op)
+        #define CM2D_INSTRUMENT_PIXELS(n)       hgl::bitmap::InstrumentAddPixels(uint64(n))
+        #define CM2D_INSTRUMENT_BYTES(n)        hgl::bitmap::InstrumentAddBytes(uint64(n))
+#else
+        #define CM2D_INSTRUMENT_SCOPE(op)       ((void)0)
+        #define CM2D_INSTRUMENT_PIXELS(n)       ((void)0)
+        #define CM2D_INSTRUMENT_BYTES(n)        ((void)0)
+#endif//CM2D_INSTRUMENT
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,93 @@
+#pragma once
+
+#include<hgl/2d/BitmapView.h>
+#include<hgl/2d/FileMapping.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 检查内存中的TGA文件数据，取得象素数据地址
+         * @param tga_data TGA文件数据
+         * @param tga_size TGA文件数据长度
+         * @param pixel_bits 要求的每象素位数
+         * @param width 返回图片宽
+         * @param height 返回图片高
+         * @param bottom_up 返回各行是否从下往上存放(此时返回的是最下面一行)，为nullptr时只接受从上往下存放的图片
+         * @return 象素数据地址，不是未压缩图片或每象素位数不符时返回nullptr
+         */
+        const void *GetTGAPixelData(const void *tga_data,const int64 tga_size,const uint pixel_bits,uint &width,uint &height,bool *bottom_up=nullptr);
+
+        /**
+         * 通过内存映射直接访问文件中象素数据的只读位图<br>
+         * 不复制象素数据，在Close或析构前GetView返回的视图一直有效。从下往上存放的文件得到的视图行跨度为负数，可以直接使用。<br>
+         * 文件以只读方式映射，所以视图的象素类型为const T，无法通过它或它的副本写入。
+         */
+        template<typename T,uint C> class MappedBitmap
+        {
+            FileMapping file;
+            BitmapView<const T,C> view;
+
+        public:
+
+            MappedBitmap()=default;
+            ~MappedBitmap()=default;
+
+            MappedBitmap(const MappedBitmap &)=delete;
+            MappedBitmap &operator=(const MappedBitmap &)=delete;
+
+            const bool IsEmpty()const{return view.IsEmpty();}
+
+            const BitmapView<const T,C> &GetView()const{return view;}
+
+            /**
+             * 映射TGA文件
+             * @return 文件不是未压缩图片或格式不符时返回false，此时可改用流方式载入
+             */
+            bool OpenTGA(const OSString &filename)
+            {
+                Close();
+
+                if(!file.Open(filename))
+                    return(false);
+
+                uint w,h;
+                bool bottom_up;
+
+                const void *pixels=GetTGAPixelData(file.GetData(),file.GetSize(),BitmapView<T,C>::CHANNELS*BitmapView<T,C>::CHANNEL_BITS,w,h,&bottom_up);
+
+                if(!pixels||size_t(pixels)%alignof(T))
+                {
+                    file.Close();
+                    return(false);
+                }
+
+                view=bottom_up?BitmapView<const T,C>::FromBottomUp((const T *)pixels,w,h):BitmapView<const T,C>((const T *)pixels,w,h);
+                return(true);
+            }
+
+            void Close()
+            {
+                view=BitmapView<const T,C>();
+                file.Close();
+            }
+        };//template<typename T,uint C> class MappedBitmap
+
+        using MappedBitmapGrey8=MappedBitmap<uint8,1>;
+        using MappedBitmapRGB8=MappedBitmap<Vector3u8,3>;
+        using MappedBitmapRGBA8=MappedBitmap<Vector4u8,4>;
+
+        /**
+         * 以内存映射方式载入TGA文件，不复制象素数据
+         */
+        template<typename T,uint C>
+        inline bool LoadBitmapFromTGA(const OSString &filename,MappedBitmap<T,C> *mb)
+        {
+            if(filename.IsEmpty()||!mb)
+                return(false);
+
+            return mb->OpenTGA(filename);
+        }
+    }//namespace bitmap
+}//namespace hgl
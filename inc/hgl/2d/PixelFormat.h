@@ -0,0 +1,184 @@
+#pragma once
+
+#include<hgl/2d/BitmapView.h>
+
+/**
+ * 象素格式转换
+ *
+ * 所有函数均以象素为单位处理count个连续象素，除注明可原地转换的以外，dst与src不可重叠。
+ * RGB与BGR的区别仅在于字节顺序，swap_rb/bgr参数用于直接处理TGA等按BGR顺序存放的数据。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        //rgb.cpp
+        void SwapRB(Vector3u8 *dst,const Vector3u8 *src,const uint count);                                     ///<RGB<->BGR，可原地转换
+        void RGB8toRGBA8(Vector4u8 *dst,const Vector3u8 *src,const uint count,const bool swap_rb=false,const uint8 alpha=255);
+        void RGBA8toRGB8(Vector3u8 *dst,const Vector4u8 *src,const uint count,const bool swap_rb=false);
+
+        //grey.cpp，亮度按(77*R+150*G+29*B+128)>>8计算
+        void RGB8toGrey8(uint8 *dst,const Vector3u8 *src,const uint count,const bool bgr=false);
+        void RGBA8toGrey8(uint8 *dst,const Vector4u8 *src,const uint count,const bool bgr=false);
+        void Grey8toRGB8(Vector3u8 *dst,const uint8 *src,const uint count);
+        void Grey8toRGBA8(Vector4u8 *dst,const uint8 *src,const uint count,const uint8 alpha=255);
+
+        //rgba.cpp
+        void SwapRB(Vector4u8 *dst,const Vector4u8 *src,const uint count);                                     ///<RGBA<->BGRA，可原地转换
+        void RG8toRGBA8(Vector4u8 *dst,const Vector2u8 *src,const uint count);                                 ///<B为0，A为255
+        void RGBA8toRG8(Vector2u8 *dst,const Vector4u8 *src,const uint count);
+
+        void PremultiplyRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count);                           ///<RGB乘以A，可原地转换
+        void UnpremultiplyRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count);                         ///<RGB除以A，可原地转换
+
+        //srgb.cpp，8位版本查表计算
+        void SRGBtoLinear(uint8 *dst,const uint8 *src,const uint count);                                       ///<逐字节转换，可原地转换
+        void LinearToSRGB(uint8 *dst,const uint8 *src,const uint count);                                       ///<逐字节转换，可原地转换
+        void SRGBtoLinearRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count);                          ///<Alpha不变，可原地转换
+        void LinearToSRGBRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count);                          ///<Alpha不变，可原地转换
+        void SRGB8toLinearF32(float *dst,const uint8 *src,const uint count);
+        void LinearF32toSRGB8(uint8 *dst,const float *src,const uint count);                                   ///<输入限制在[0,1]内，以4096级查表
+
+        //half.cpp，count为数值个数
+        void FloatToHalf(half_float *dst,const float *src,const uint count);
+        void HalfToFloat(float *dst,const half_float *src,const uint count);
+        void U8toHalf(half_float *dst,const uint8 *src,const uint count);                                      ///<[0,255]映射到[0,1]
+        void HalftoU8(uint8 *dst,const half_float *src,const uint count);                                      ///<[0,1]映射到[0,255]，超出部分截断
+
+        /**
+         * 逐行转换位图，两个位图尺寸必须相同。各行都连续时一次转换全部象素。
+         */
+        template<typename DV,typename SV,typename F>
+        inline bool ConvertBitmapRows(DV *dst,const SV *src,const F &func)
+        {
+            if(!dst||!src||dst->IsEmpty()||src->IsEmpty())
+                return(false);
+
+            if(dst->GetWidth()!=src->GetWidth()
+             ||dst->GetHeight()!=src->GetHeight())
+                return(false);
+
+            if(dst->IsContinuous()&&src->IsContinuous())
+            {
+                func(dst->GetData(),src->GetData(),src->GetTotalPixels());
+                return(true);
+            }
+
+            const int width=src->GetWidth();
+            const int height=src->GetHeight();
+
+            for(int y=0;y<height;y++)
+                func(dst->GetLine(y),src->GetLine(y),width);
+
+            return(true);
+        }
+
+        /**
+         * 原地逐行处理位图
+         */
+        template<typename V,typename F>
+        inline bool ProcessBitmapRows(V *bmp,const F &func)
+        {
+            return ConvertBitmapRows(bmp,bmp,func);
+        }
+
+        inline bool ConvertBitmap(BitmapViewRGBA8 *dst,const BitmapViewRGB8 *src,const bool swap_rb=false)
+        {
+            return ConvertBitmapRows(dst,src,[swap_rb](Vector4u8 *d,const Vector3u8 *s,const uint n){RGB8toRGBA8(d,s,n,swap_rb);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewRGB8 *dst,const BitmapViewRGBA8 *src,const bool swap_rb=false)
+        {
+            return ConvertBitmapRows(dst,src,[swap_rb](Vector3u8 *d,const Vector4u8 *s,const uint n){RGBA8toRGB8(d,s,n,swap_rb);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewGrey8 *dst,const BitmapViewRGB8 *src,const bool bgr=false)
+        {
+            return ConvertBitmapRows(dst,src,[bgr](uint8 *d,const Vector3u8 *s,const uint n){RGB8toGrey8(d,s,n,bgr);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewGrey8 *dst,const BitmapViewRGBA8 *src,const bool bgr=false)
+        {
+            return ConvertBitmapRows(dst,src,[bgr](uint8 *d,const Vector4u8 *s,const uint n){RGBA8toGrey8(d,s,n,bgr);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewRGB8 *dst,const BitmapViewGrey8 *src)
+        {
+            return ConvertBitmapRows(dst,src,[](Vector3u8 *d,const uint8 *s,const uint n){Grey8toRGB8(d,s,n);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewRGBA8 *dst,const BitmapViewGrey8 *src)
+        {
+            return ConvertBitmapRows(dst,src,[](Vector4u8 *d,const uint8 *s,const uint n){Grey8toRGBA8(d,s,n);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewRGBA8 *dst,const BitmapViewRG8 *src)
+        {
+            return ConvertBitmapRows(dst,src,[](Vector4u8 *d,const Vector2u8 *s,const uint n){RG8toRGBA8(d,s,n);});
+        }
+
+        inline bool ConvertBitmap(BitmapViewRG8 *dst,const BitmapViewRGBA8 *src)
+        {
+            return ConvertBitmapRows(dst,src,[](Vector2u8 *d,const Vector4u8 *s,const uint n){RGBA8toRG8(d,s,n);});
+        }
+
+        inline bool SwapRB(BitmapViewRGB8 *bmp)
+        {
+            return ProcessBitmapRows(bmp,[](Vector3u8 *d,const Vector3u8 *s,const uint n){SwapRB(d,s,n);});
+        }
+
+        inline bool SwapRB(BitmapViewRGBA8 *bmp)
+        {
+            return ProcessBitmapRows(bmp,[](Vector4u8 *d,const Vector4u8 *s,const uint n){SwapRB(d,s,n);});
+        }
+
+        inline bool Premultiply(BitmapViewRGBA8 *bmp)
+        {
+            return ProcessBitmapRows(bmp,[](Vector4u8 *d,const Vector4u8 *s,const uint n){PremultiplyRGBA8(d,s,n);});
+        }
+
+        inline bool Unpremultiply(BitmapViewRGBA8 *bmp)
+        {
+            return ProcessBitmapRows(bmp,[](Vector4u8 *d,const Vector4u8 *s,const uint n){UnpremultiplyRGBA8(d,s,n);});
+        }
+
+        inline bool SRGBtoLinear(BitmapViewRGBA8 *bmp)
+        {
+            return ProcessBitmapRows(bmp,[](Vector4u8 *d,const Vector4u8 *s,const uint n){SRGBtoLinearRGBA8(d,s,n);});
+        }
+
+        inline bool LinearToSRGB(BitmapViewRGBA8 *bmp)
+        {
+            return ProcessBitmapRows(bmp,[](Vector4u8 *d,const Vector4u8 *s,const uint n){LinearToSRGBRGBA8(d,s,n);});
+        }
+
+        /**
+         * 将8位位图转换为紧密排列的半精度浮点数据(常用于上传浮点纹理)
+         * @param dst 输出，至少需要width*height*CHANNELS个half_float
+         */
+        template<typename T,uint C>
+        inline bool ConvertBitmapToHalf(half_float *dst,const BitmapView<T,C> *src)
+        {
+            static_assert(sizeof(T)==C,"ConvertBitmapToHalf only supports 8-bit channels");
+
+            if(!dst||!src||src->IsEmpty())
+                return(false);
+
+            const uint row_values=src->GetWidth()*C;
+
+            if(src->IsContinuous())
+            {
+                U8toHalf(dst,(const uint8 *)src->GetData(),row_values*src->GetHeight());
+                return(true);
+            }
+
+            for(int y=0;y<src->GetHeight();y++)
+            {
+                U8toHalf(dst,(const uint8 *)src->GetLine(y),row_values);
+                dst+=row_values;
+            }
+
+            return(true);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,215 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<vector>
+#include<utility>
+#include<climits>
+#include<cmath>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 多边形填充规则
+         */
+        enum class FillRule
+        {
+            NonZero,                                                            ///<非零环绕
+            EvenOdd,                                                            ///<奇偶
+        };//enum class FillRule
+
+        /**
+         * 一行中被填充的连续象素(right不包含在内)
+         */
+        struct ScanSpan
+        {
+            int y;
+            int left,right;
+        };//struct ScanSpan
+
+        /**
+         * 扫描线与一条边的交点计算<br>
+         * 象素中心(x+0.5,y+0.5)在图形内时填充该象素，正好在边上时遵循左上规则:左边与上边上的象素被填充，右边与下边上的不填充。
+         * 所以共用一条边的两个图形既不会重叠也不会留下缝隙。
+         * 同一条边总是从上端点开始以相同的公式计算，多边形与三角形的结果一致。
+         */
+        struct ScanEdge
+        {
+            double x0,y0;                                                       ///<上端点
+            double slope;                                                       ///<dx/dy
+
+            int y_begin,y_end;                                                  ///<覆盖的行范围(y_end不包含在内)
+
+        public:
+
+            /**
+             * @param top 上端点(y较小)
+             * @param bottom 下端点
+             */
+            void Set(const Vector2f &top,const Vector2f &bottom)
+            {
+                x0=top.x;
+                y0=top.y;
+                slope=(double(bottom.x)-double(top.x))/(double(bottom.y)-double(top.y));
+
+                y_begin=FirstRow(top.y);
+                y_end  =FirstRow(bottom.y);
+            }
+
+            /**
+             * 第y行象素中心处的x
+             */
+            const double GetX(const int y)const
+            {
+                return x0+(y+0.5-y0)*slope;
+            }
+
+            /**
+             * 象素中心不小于v的第一行(或第一列)
+             */
+            static const int FirstRow(const double v)
+            {
+                const double r=ceil(v-0.5);
+
+                if(!(r>=double(INT_MIN/2)))return INT_MIN/2;                    //同时处理NaN
+                if(r>double(INT_MAX/2))return INT_MAX/2;
+
+                return int(r);
+            }
+        };//struct ScanEdge
+
+        /**
+         * 把一行中从xl到xr的范围转换为象素范围，并裁剪到[cl,cr)
+         * @return 是否有象素
+         */
+        inline bool ScanSpanRange(const double xl,const double xr,const int cl,const int cr,int *l,int *r)
+        {
+            const int a=ScanEdge::FirstRow(xl);
+            const int b=ScanEdge::FirstRow(xr);
+
+            *l=(a>cl?a:cl);
+            *r=(b<cr?b:cr);
+
+            return *l<*r;
+        }
+
+        /**
+         * 扫描三角形，按行从上到下对每个非空行调用func(y,left,right)
+         * @param cl,ct,cr,cb 裁剪范围(cr/cb不包含在内)
+         */
+        template<typename F>
+        inline void ScanTriangle(Vector2f v0,Vector2f v1,Vector2f v2,const int cl,const int ct,const int cr,const int cb,const F &func)
+        {
+            //按y排序，y相同时按x，使同一条边无论出现在哪个三角形中端点顺序都相同
+            auto less=[](const Vector2f &a,const Vector2f &b){return a.y<b.y||(a.y==b.y&&a.x<b.x);};
+
+            if(less(v1,v0))std::swap(v0,v1);
+            if(less(v2,v1))std::swap(v1,v2);
+            if(less(v1,v0))std::swap(v0,v1);
+
+            if(v0.y==v2.y)return;
+
+            ScanEdge longe,upper,lower;
+
+            longe.Set(v0,v2);
+
+            int y =(longe.y_begin>ct?longe.y_begin:ct);
+            int ye=(longe.y_end  <cb?longe.y_end  :cb);
+
+            if(y>=ye)return;
+
+            //中间顶点在长边的右侧时，长边为左边
+            const bool long_left=((double(v1.x)-v0.x)*(double(v2.y)-v0.y)-(double(v1.y)-v0.y)*(double(v2.x)-v0.x))>0;
+
+            const bool has_upper=(v0.y<v1.y);
+            const bool has_lower=(v1.y<v2.y);
+
+            if(has_upper)upper.Set(v0,v1);
+            if(has_lower)lower.Set(v1,v2);
+
+            const int y_mid=has_upper?upper.y_end:ScanEdge::FirstRow(v1.y);
+
+            int l,r;
+
+            for(;y<ye;y++)
+            {
+                const ScanEdge &se=(y<y_mid||!has_lower)?upper:lower;
+
+                const double xa=longe.GetX(y);
+                const double xb=se.GetX(y);
+
+                if(long_left?ScanSpanRange(xa,xb,cl,cr,&l,&r):ScanSpanRange(xb,xa,cl,cr,&l,&r))
+                    func(y,l,r);
+            }
+        }
+
+        /**
+         * 扫描线多边形光栅化器(无抗锯齿)<br>
+         * 所有边先按起始行排序(边表)，逐行维护与当前行相交的活动边表，按交点输出填充的象素段。
+         * 可以添加多个多边形，按填充规则处理重叠与洞。
+         */
+        class PolygonRasterizer
+        {
+            struct Edge:public ScanEdge
+            {
+                int dir;                                                        ///<方向(向下为1，向上为-1)
+            };
+
+            struct Crossing
+            {
+                double x;
+                int dir;
+            };
+
+            int width,height;
+            FillRule rule;
+
+            std::vector<Edge> edge_list;
+
+            std::vector<uint> active;                                           ///<当前行活动边
+            std::vector<Crossing> crossings;                                    ///<当前行的交点
+            std::vector<ScanSpan> span_list;                                    ///<当前行输出的象素段
+
+            uint next_edge;
+            uint next_span;
+            int cur_y,end_y;
+
+        private:
+
+            void AddEdge(const Vector2f &p0,const Vector2f &p1);
+            bool ScanRow();
+
+        public:
+
+            PolygonRasterizer();
+            ~PolygonRasterizer()=default;
+
+            /**
+             * 清除所有边，并设置裁剪尺寸
+             */
+            void Reset(const int w,const int h);
+
+            void SetFillRule(const FillRule fr){rule=fr;}
+            const FillRule GetFillRule()const{return rule;}
+
+            const bool IsEmpty()const{return edge_list.empty();}
+
+            void AddPolygon(const Vector2f *points,const int count);                        ///<添加一个闭合多边形
+
+        public:
+
+            /**
+             * 开始逐行扫描
+             * @return 是否有需要输出的内容
+             */
+            bool BeginSweep();
+
+            /**
+             * 输出下一个象素段，按行从上到下，同一行内从左到右
+             * @return 是否还有数据
+             */
+            bool SweepSpan(ScanSpan &);
+        };//class PolygonRasterizer
+    }//namespace bitmap
+}//namespace hgl
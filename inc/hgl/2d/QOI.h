@@ -0,0 +1,91 @@
+#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<string.h>
+namespace hgl
+{
+    namespace imgfmt
+    {
+        /**
+         * QOI(Quite OK Image)格式，参见 https://qoiformat.org/qoi-specification.pdf
+         */
+        constexpr const uint8 QOI_MAGIC[4]          ={'q','o','i','f'};
+        constexpr const uint  QOI_HEADER_SIZE       =14;
+        constexpr const uint  QOI_END_MARKER_SIZE   =8;                     ///<结尾7个0与1个1
+        constexpr const uint  QOI_MAX_PIXELS        =400000000;             ///<规范建议的最大象素数
+
+        constexpr const uint8 QOI_OP_INDEX  =0x00;
+        constexpr const uint8 QOI_OP_DIFF   =0x40;
+        constexpr const uint8 QOI_OP_LUMA   =0x80;
+        constexpr const uint8 QOI_OP_RUN    =0xC0;
+        constexpr const uint8 QOI_OP_RGB    =0xFE;
+        constexpr const uint8 QOI_OP_RGBA   =0xFF;
+        constexpr const uint8 QOI_MASK_2    =0xC0;
+
+        constexpr const uint  QOI_MAX_RUN   =62;
+
+        constexpr const uint8 QOI_SRGB      =0;
+        constexpr const uint8 QOI_LINEAR    =1;
+
+        /**
+         * QOI文件头(文件中为大端序，这里为解析后的值)
+         */
+        struct QOIHeader
+        {
+            uint32 width;
+            uint32 height;
+            uint8 channels;                 // 3 RGB,4 RGBA
+            uint8 colorspace;               // 0 sRGB,1 linear
+        };
+
+        inline const uint QOIColorHash(const uint8 r,const uint8 g,const uint8 b,const uint8 a)
+        {
+            return (r*3+g*5+b*7+a*11)%64;
+        }
+
+        /**
+         * 解析QOI文件头
+         * @param data 文件开头数据，至少QOI_HEADER_SIZE字节
+         * @return 是否为有效的QOI文件头
+         */
+        inline bool ParseQOIHeader(QOIHeader *header,const uint8 *data,const uint size)
+        {
+            if(!header||!data||size<QOI_HEADER_SIZE)return(false);
+
+            if(data[0]!=QOI_MAGIC[0]
+             ||data[1]!=QOI_MAGIC[1]
+             ||data[2]!=QOI_MAGIC[2]
+             ||data[3]!=QOI_MAGIC[3])return(false);
+
+            header->width     =(uint32(data[4])<<24)|(uint32(data[5])<<16)|(uint32(data[ 6])<<8)|data[ 7];
+            header->height    =(uint32(data[8])<<24)|(uint32(data[9])<<16)|(uint32(data[10])<<8)|data[11];
+            header->channels  =data[12];
+            header->colorspace=data[13];
+
+            if(!header->width||!header->height)return(false);
+            if(header->channels!=3&&header->channels!=4)return(false);
+            if(header->colorspace>QOI_LINEAR)return(false);
+
+            return(uint64(header->width)*header->height<=QOI_MAX_PIXELS);
+        }
+
+        /**
+         * 生成QOI文件头
+         */
+        inline void WriteQOIHeader(uint8 *data,const QOIHeader &header)
+        {
+            memcpy(data,QOI_MAGIC,4);
+
+            data[ 4]=uint8(header.width>>24);
+            data[ 5]=uint8(header.width>>16);
+            data[ 6]=uint8(header.width>>8);
+            data[ 7]=uint8(header.width);
+            data[ 8]=uint8(header.height>>24);
+            data[ 9]=uint8(header.height>>16);
+            data[10]=uint8(header.height>>8);
+            data[11]=uint8(header.height);
+            data[12]=header.channels;
+            data[13]=header.colorspace;
+        }
+    }//namespace imgfmt
+}//namespace hgl
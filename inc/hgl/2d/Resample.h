@@ -0,0 +1,212 @@
+#pragma once
+
+#include<hgl/2d/Bitmap.h>
+#include<vector>
+
+/**
+ * 位图缩放
+ *
+ * 缩放分为水平与垂直两遍一维滤波，每个目标象素的源象素范围与权重预先计算一次。
+ * 权重以RESAMPLE_WEIGHT_BITS位定点数存放，所有实现(含SIMD)使用相同的整数运算，结果逐位一致。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        class TaskPool;
+
+        enum class ResampleFilter
+        {
+            Box,                                                                ///<区域平均，缩小时每个源象素按覆盖面积计入
+            Bilinear,                                                           ///<三角滤波，缩小时范围随比例扩大
+            Lanczos3,                                                           ///<a=3的Lanczos滤波，最清晰，开销最大
+        };//enum class ResampleFilter
+
+        constexpr uint RESAMPLE_WEIGHT_BITS=14;                                 ///<定点权重小数位数
+
+        /**
+         * 一维缩放权重<br>
+         * 每个目标象素使用从start开始的taps个连续源象素，不足taps个的部分权重为0。
+         */
+        struct ResampleWeights
+        {
+            uint src_size=0;
+            uint dst_size=0;
+            uint taps=0;
+
+            std::vector<int> start;                                             ///<每个目标象素的第一个源象素
+            std::vector<int16> weights;                                         ///<dst_size*taps个，每组之和为1<<RESAMPLE_WEIGHT_BITS
+
+        public:
+
+            bool Compute(const uint src,const uint dst,const ResampleFilter filter);
+        };//struct ResampleWeights
+
+        struct ResampleOption
+        {
+            ResampleFilter filter=ResampleFilter::Bilinear;
+
+            TaskPool *task_pool=nullptr;                                        ///<按目标行带并行处理所用的任务池，为nullptr时在当前线程处理
+            uint band_rows=0;                                                   ///<每个任务处理的目标行数，为0时自动决定
+
+            bool box_prereduce=false;                                           ///<缩小超过4倍时先反复以2x2平均缩小一半，适合大批量生成缩略图
+        };//struct ResampleOption
+
+        /**
+         * 缩放象素数据，支持每通道8/16/32位整数，8位时使用SIMD
+         * @param dst_line_bytes 目标每行跨度字节数，为0时表示各行连续存放
+         * @param src_line_bytes 源每行跨度字节数，为0时表示各行连续存放
+         */
+        bool ResampleBitmap(void *dst,uint dst_width,uint dst_height,uint dst_line_bytes,
+                            const void *src,uint src_width,uint src_height,uint src_line_bytes,
+                            const uint channels,const uint channel_bits,const ResampleOption &option=ResampleOption());
+
+        /**
+         * 缩放位图，两者都按内存中的行序处理，所以方向相同时无需翻转
+         */
+        template<typename T,uint C>
+        inline bool ResampleBitmap(BitmapView<T,C> *dst,const BitmapView<T,C> *src,const ResampleOption &option=ResampleOption())
+        {
+            if(!dst||!src||dst->IsEmpty()||src->IsEmpty())
+                return(false);
+
+            if(!ResampleBitmap(dst->GetMemory(),dst->GetWidth(),dst->GetHeight(),dst->GetLineBytes(),
+                               src->GetMemory(),src->GetWidth(),src->GetHeight(),src->GetLineBytes(),
+                               C,dst->GetChannelBits(),option))
+                return(false);
+
+            //方向不同时按内存行序缩放的结果是上下颠倒的
+            if(dst->IsBottomUp()!=src->IsBottomUp())
+                dst->Flip();
+
+            return(true);
+        }
+
+        /**
+         * 创建指定尺寸的位图并将src缩放到其中，dst的方向与src相同
+         */
+        template<typename T,uint C>
+        inline bool ResizeBitmap(Bitmap<T,C> *dst,const BitmapView<T,C> *src,const uint width,const uint height,const ResampleOption &option=ResampleOption())
+        {
+            if(!dst||!src||src->IsEmpty())
+                return(false);
+
+            if(!dst->Create(width,height))
+                return(false);
+
+            dst->SetBottomUp(src->IsBottomUp());
+
+            return ResampleBitmap(dst,src,option);
+        }
+
+        /**
+         * 以2x2平均缩小一半，即(a+b+c+d+2)>>2<br>
+         * 源数据须至少有(dst_width*2)x(dst_height*2)个象素。
+         */
+        void DownsampleBox2x(void *dst,uint dst_line_bytes,const void *src,uint src_line_bytes,
+                             const uint dst_width,const uint dst_height,const uint channels,const uint channel_bits,TaskPool *pool=nullptr);
+
+        /**
+         * 将位图缩小一半，尺寸为(w/2,h/2)，为1的边保持为1，dst的方向与src相同
+         */
+        template<typename T,uint C>
+        inline bool DownsampleBitmapBox2x(Bitmap<T,C> *dst,const BitmapView<T,C> *src,TaskPool *pool=nullptr)
+        {
+            if(!dst||!src||src->IsEmpty())
+                return(false);
+
+            const uint sw=src->GetWidth();
+            const uint sh=src->GetHeight();
+
+            if(sw==1&&sh==1)
+                return(false);
+
+            const uint dw=(sw>1?sw>>1:1);
+            const uint dh=(sh>1?sh>>1:1);
+
+            if(!dst->Create(dw,dh))
+                return(false);
+
+            dst->SetBottomUp(src->IsBottomUp());
+
+            const uint uw=(dw*2>sw?sw:dw*2);
+            const uint uh=(dh*2>sh?sh:dh*2);
+
+            //只使用上面uh行，从下往上存放时它们在内存中从第uh-1行开始
+            const T *sp=src->IsBottomUp()?src->GetLine(uh-1):src->GetData();
+
+            //只有1列或1行时2x2平均退化为两个象素平均，与Box滤波结果一致
+            if(sw==1||sh==1)
+            {
+                ResampleOption option;
+
+                option.filter=ResampleFilter::Box;
+                option.task_pool=pool;
+
+                return ResampleBitmap(dst->GetMemory(),dw,dh,dst->GetLineBytes(),
+                                      sp,uw,uh,src->GetLineBytes(),C,dst->GetChannelBits(),option);
+            }
+
+            DownsampleBox2x(dst->GetMemory(),dst->GetLineBytes(),sp,src->GetLineBytes(),dw,dh,C,dst->GetChannelBits(),pool);
+            return(true);
+        }
+
+        /**
+         * 生成mipmap链
+         * @param mips 依次存放1/2,1/4...直到1x1的各级位图(不含原图)，原有内容被清除
+         * @param src 原图
+         * @param filter 为Box时使用2x2平均，其它滤波器由上一级缩放一半得到
+         * @param pool 并行处理所用的任务池，可为nullptr
+         * @param max_levels 最多生成的级数，为0时不限
+         * @return 生成的级数
+         */
+        template<typename T,uint C>
+        inline uint GenerateMipChain(std::vector<Bitmap<T,C>> &mips,const BitmapView<T,C> *src,const ResampleFilter filter=ResampleFilter::Box,TaskPool *pool=nullptr,const uint max_levels=0)
+        {
+            mips.clear();
+
+            if(!src||src->IsEmpty())
+                return(0);
+
+            uint count=0;
+            int w=src->GetWidth();
+            int h=src->GetHeight();
+
+            while((w>1||h>1)&&(!max_levels||count<max_levels))
+            {
+                w=(w>1?w>>1:1);
+                h=(h>1?h>>1:1);
+                ++count;
+            }
+
+            mips.resize(count);
+
+            ResampleOption option;
+
+            option.filter=filter;
+            option.task_pool=pool;
+
+            const BitmapView<T,C> *prev=src;
+
+            for(uint i=0;i<count;i++)
+            {
+                bool result;
+
+                if(filter==ResampleFilter::Box)
+                    result=DownsampleBitmapBox2x(&mips[i],prev,pool);
+                else
+                    result=ResizeBitmap(&mips[i],prev,prev->GetWidth()>1?prev->GetWidth()>>1:1,prev->GetHeight()>1?prev->GetHeight()>>1:1,option);
+
+                if(!result)
+                {
+                    mips.resize(i);
+                    return(i);
+                }
+
+                prev=&mips[i];
+            }
+
+            return count;
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -9,6 +9,14 @@ namespace hgl
         constexpr const uint TGA_IMAGE_TYPE_TRUE_COLOR  =2;
         constexpr const uint TGA_IMAGE_TYPE_GRAYSCALE   =3;
 
+        constexpr const uint TGA_IMAGE_TYPE_RLE_FLAG    =8;                 ///<加上此值即为对应的RLE压缩格式
+
+        constexpr const uint TGA_IMAGE_TYPE_RLE_COLOR_MAP   =TGA_IMAGE_TYPE_COLOR_MAP   +TGA_IMAGE_TYPE_RLE_FLAG;
+        constexpr const uint TGA_IMAGE_TYPE_RLE_TRUE_COLOR  =TGA_IMAGE_TYPE_TRUE_COLOR  +TGA_IMAGE_TYPE_RLE_FLAG;
+        constexpr const uint TGA_IMAGE_TYPE_RLE_GRAYSCALE   =TGA_IMAGE_TYPE_GRAYSCALE   +TGA_IMAGE_TYPE_RLE_FLAG;
+
+        constexpr const uint TGA_RLE_MAX_PACKET_PIXELS  =128;
+
         constexpr const uint TGA_DIRECTION_LOWER_LEFT   =0;
         constexpr const uint TGA_DIRECTION_UPPER_LEFT   =1;
 
@@ -46,6 +54,46 @@ namespace hgl
 
         constexpr size_t TGAHeaderSize=sizeof(TGAHeader);
 
-        bool FillTGAHeader(TGAHeader *header,const uint16 width,const uint16 height,const uint8 channels,const uint8 single_channel_bits=8);
+        bool FillTGAHeader(TGAHeader *header,const uint16 width,const uint16 height,const uint8 channels,const uint8 single_channel_bits=8,const bool rle=false,const bool bottom_up=false);
+
+        /**
+         * 检查文件头是否像一个有效的TGA文件头<br>
+         * TGA没有文件标识，只能根据各字段的取值范围判断，所以应在其它格式都不匹配时再使用。
+         */
+        bool CheckTGAHeader(const TGAHeader *header);
+
+        /**
+         * 计算文件中调色板的字节数，不使用调色板时为0<br>
+         * 调色板每项按整字节存放，所以15位的每项同样占2字节。
+         */
+        inline const uint GetTGAColorMapBytes(const TGAHeader *header)
+        {
+            if(!header->color_map_type)return(0);
+
+            return uint(header->color_map_length)*((header->color_map_size+7)>>3);
+        }
+
+        /**
+         * 计算count个象素RLE压缩后最多可能的字节数
+         */
+        inline const uint GetTGARLEMaxBytes(const uint count,const uint pixel_bytes)
+        {
+            return count*pixel_bytes+(count+TGA_RLE_MAX_PACKET_PIXELS-1)/TGA_RLE_MAX_PACKET_PIXELS;
+        }
+
+        /**
+         * 以TGA的RLE格式压缩一段象素(通常为一行，TGA要求数据包不跨行)
+         * @param dst 输出缓冲区，至少GetTGARLEMaxBytes(count,pixel_bytes)字节
+         * @param src 象素数据
+         * @param count 象素数量
+         * @param pixel_bytes 每象素字节数(1-4)
+         * @return 输出的字节数
+         */
+        uint EncodeTGARLE(uint8 *dst,const uint8 *src,const uint count,const uint pixel_bytes);
+
+        /**
+         * 将一个象素重复填充count次
+         */
+        void FillTGAPixels(uint8 *dst,const uint8 *pixel,const uint pixel_bytes,const uint count);
     }//namespace imgfmt
 }//namespace hgl
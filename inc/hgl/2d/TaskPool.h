@@ -0,0 +1,115 @@
+#pragma once
+
+#include<hgl/type/DataType.h>
+#include<atomic>
+#include<condition_variable>
+#include<deque>
+#include<functional>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        /**
+         * 工作窃取式任务池<br>
+         * 每个线程拥有自己的任务队列，自己的队列为空时从其它线程队列的另一端窃取任务。<br>
+         * 调用Run的线程也参与执行。在任务内部再次调用Run时将直接串行执行。
+         */
+        class TaskPool
+        {
+            struct WorkQueue
+            {
+                std::mutex lock;
+                std::deque<uint> tasks;
+            };
+
+            std::vector<std::thread> workers;
+            std::vector<WorkQueue *> queues;                                    ///<[0]为调用线程使用，其余依次对应workers
+
+            std::mutex run_lock;                                                ///<同一时间只允许一批任务
+
+            std::mutex state_lock;
+            std::condition_variable start_cv;
+            std::condition_variable done_cv;
+
+            const std::function<void(uint)> *job;
+            std::atomic<uint> remaining;
+            uint64 generation;
+            bool quit;
+
+        private:
+
+            bool PopTask(const uint self,uint &task);
+            void Execute(const uint self);
+            void WorkerProc(const uint self);
+
+        public:
+
+            /**
+             * @param thread_count 工作线程数量(不含调用线程)，为0时为CPU核心数-1
+             */
+            TaskPool(uint thread_count=0);
+            ~TaskPool();
+
+            const uint GetThreadCount()const{return uint(workers.size())+1;}   ///<取得参与执行的线程数量(包含调用线程)
+
+            /**
+             * 并行执行count个任务，直到全部完成后返回
+             * @param count 任务数量
+             * @param func 任务函数，参数为任务序号[0,count)
+             */
+            void Run(const uint count,const std::function<void(uint)> &func);
+        };//class TaskPool
+
+        /**
+         * 创建CM2D全局任务池，已有的会先被关闭<br>
+         * 未创建或thread_count为1时全局任务池为nullptr，所有使用它的操作都在调用线程串行执行。
+         * @param thread_count 参与执行的线程数量(包含调用线程)，为0时为CPU核心数
+         */
+        void InitGlobalTaskPool(const uint thread_count=0);
+
+        /**
+         * 关闭全局任务池，调用时不能有正在使用它的操作
+         */
+        void CloseGlobalTaskPool();
+
+        /**
+         * 取得全局任务池，未创建时返回nullptr
+         */
+        TaskPool *GetGlobalTaskPool();
+
+        constexpr size_t TASK_BAND_BYTES        =256*1024;                      ///<并行处理时每个行带的目标字节数(约为L2缓存大小)
+        constexpr size_t TASK_PARALLEL_MIN_BYTES=1024*1024;                     ///<总数据量小于此值时不并行
+
+        /**
+         * 将[0,height)按每行row_bytes字节分为缓存大小的行带，有任务池且数据量足够大时并行处理
+         * @param func 处理函数，参数为行带范围[y0,y1)
+         */
+        template<typename F> void ForEachRowBand(TaskPool *pool,const uint height,const size_t row_bytes,const F &func)
+        {
+            if(!height)return;
+
+            if(!pool||pool->GetThreadCount()<=1||size_t(height)*row_bytes<TASK_PARALLEL_MIN_BYTES)
+            {
+                func(0,height);
+                return;
+            }
+
+            uint band_rows=row_bytes?uint(TASK_BAND_BYTES/row_bytes):height;
+
+            if(band_rows<1)band_rows=1;
+
+            const uint band_count=(height+band_rows-1)/band_rows;
+
+            pool->Run(band_count,[&func,band_rows,height](const uint index)
+            {
+                const uint y=index*band_rows;
+
+                func(y,(y+band_rows<height)?y+band_rows:height);
+            });
+        }
+    }//namespace bitmap
+}//namespace hgl
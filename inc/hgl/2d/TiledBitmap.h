@@ -0,0 +1,655 @@
+#pragma once
+
+#include<hgl/2d/BitmapView.h>
+#include<hgl/2d/BitmapAllocator.h>
+#include<hgl/2d/Resample.h>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        constexpr uint TILED_BITMAP_TILE_SHIFT  =6;
+        constexpr int  TILED_BITMAP_TILE_SIZE   =1<<TILED_BITMAP_TILE_SHIFT;   ///<分块边长(象素)
+
+        /**
+         * 将16位整数的各位分散到偶数位上
+         */
+        inline const uint32 MortonSpread16(uint32 v)
+        {
+            v&=0xFFFF;
+            v=(v|(v<<8))&0x00FF00FF;
+            v=(v|(v<<4))&0x0F0F0F0F;
+            v=(v|(v<<2))&0x33333333;
+            v=(v|(v<<1))&0x55555555;
+
+            return v;
+        }
+
+        /**
+         * 计算二维坐标的Morton(Z序)编号，相邻的坐标编号也相近
+         */
+        inline const uint32 MortonEncode2D(const uint x,const uint y)
+        {
+            return MortonSpread16(x)|(MortonSpread16(y)<<1);
+        }
+
+        /**
+         * 分块位图<br>
+         * 图片被切分为TILED_BITMAP_TILE_SIZE见方的分块，每块内部按行存放。分块按Morton顺序编号，
+         * 边长为较短方向分块数(取整到2的幂)的正方形依次沿较长方向排列，所以细长的图片编号也不会稀疏。<br>
+         * 分块在第一次写入时才分配，未分配的分块视为全部为清除色，适合超大且只有部分区域会被访问的图片。<br>
+         * 可选的mipmap各级同样分块存放，在读取时才由上一级生成，上一级被写入后对应的各级分块自动失效。<br>
+         * 本类不能被多个线程同时使用。
+         */
+        template<typename T,uint C> class TiledBitmap
+        {
+        public:
+
+            using PixelType=T;
+            using TileView=BitmapView<T,C>;
+
+            static constexpr uint CHANNELS=C;
+            static constexpr uint CHANNEL_BITS=(sizeof(T)/C)<<3;
+
+            static constexpr int  TILE_SIZE=TILED_BITMAP_TILE_SIZE;
+            static constexpr uint TILE_PIXELS=TILE_SIZE*TILE_SIZE;
+            static constexpr size_t TILE_BYTES=TILE_PIXELS*sizeof(T);
+
+        protected:
+
+            struct TileLevel
+            {
+                int width=0,height=0;
+                int cols=0,rows=0;                                              ///<分块列数与行数
+
+                uint square_shift=0;                                            ///<Morton正方形边长(分块数)的log2
+
+                std::vector<T *> tiles;                                         ///<按GetIndex编号存放，未分配的为nullptr
+                std::vector<uint8> stale;                                       ///<mipmap分块是否需要重新生成
+
+                /**
+                 * 设置分块数并求出Morton正方形的边长，返回编号总数
+                 */
+                size_t SetTileCount(const int c,const int r)
+                {
+                    cols=c;
+                    rows=r;
+
+                    const int short_side=(cols<rows?cols:rows);
+
+                    square_shift=0;
+
+                    while((1<<square_shift)<short_side)
+                        ++square_shift;
+
+                    //编号在各方向上单调递增，所以右下角分块的编号最大
+                    return size_t(GetIndex(cols-1,rows-1))+1;
+                }
+
+                /**
+                 * 计算分块编号，正方形的序号在高位，正方形内为Morton编号
+                 */
+                const size_t GetIndex(const int tx,const int ty)const
+                {
+                    const uint mask=(1u<<square_shift)-1;
+                    const size_t square=(cols>=rows?tx:ty)>>square_shift;
+
+                    return (square<<(square_shift*2))|MortonEncode2D(tx&mask,ty&mask);
+                }
+            };
+
+            std::vector<TileLevel> levels;
+
+            T clear_color;
+
+            uint resident_tiles;
+
+            BitmapAllocator *allocator;
+
+        protected:
+
+            T *AllocTile()
+            {
+                T *tile=(T *)allocator->Alloc(TILE_BYTES);
+
+                if(tile)
+                {
+                    FillPixels<T>(tile,clear_color,TILE_PIXELS);
+                    ++resident_tiles;
+                }
+
+                return tile;
+            }
+
+            void FreeTile(T *&tile)
+            {
+                if(!tile)return;
+
+                allocator->Free(tile,TILE_BYTES);
+                tile=nullptr;
+                --resident_tiles;
+            }
+
+            /**
+             * 位于(tx,ty)的分块被写入，使各级mipmap中包含它的分块失效
+             */
+            void InvalidateMips(int tx,int ty)
+            {
+                for(size_t i=1;i<levels.size();i++)
+                {
+                    tx>>=1;
+                    ty>>=1;
+
+                    TileLevel &lv=levels[i];
+
+                    if(tx>=lv.cols||ty>=lv.rows)break;
+
+                    uint8 &s=lv.stale[lv.GetIndex(tx,ty)];
+
+                    if(s)break;                                                 //更高级别必然也已失效
+
+                    s=1;
+                }
+            }
+
+            /**
+             * 由上一级生成mipmap分块
+             */
+            T *UpdateMipTile(const uint level,const int tx,const int ty)
+            {
+                TileLevel &lv=levels[level];
+                const size_t index=lv.GetIndex(tx,ty);
+
+                if(!lv.stale[index])
+                    return lv.tiles[index];
+
+                const T *src[4];
+                bool any=false;
+
+                for(int i=0;i<4;i++)
+                {
+                    src[i]=GetMipTile(level-1,tx*2+(i&1),ty*2+(i>>1));
+
+                    if(src[i])any=true;
+                }
+
+                T *&tile=lv.tiles[index];
+
+                lv.stale[index]=0;
+
+                if(!any)                                                        //上一级全部为清除色
+                {
+                    FreeTile(tile);
+                    return(nullptr);
+                }
+
+                if(!tile)
+                {
+                    tile=AllocTile();
+
+                    if(!tile)
+                    {
+                        lv.stale[index]=1;
+                        return(nullptr);
+                    }
+                }
+
+                constexpr int HALF=TILE_SIZE/2;
+
+                //上一级只有1列或1行时，把它复制到图片外相邻的位置，使2x2平均的结果等于原值
+                const TileLevel &prev=levels[level-1];
+
+                if(prev.width==1||prev.height==1)
+                {
+                    for(int i=0;i<4;i++)
+                    {
+                        T *s=(T *)src[i];
+
+                        if(!s)continue;
+
+                        if(prev.width==1)
+                            for(int y=0;y<TILE_SIZE;y++)
+                                s[y*TILE_SIZE+1]=s[y*TILE_SIZE];
+
+                        if(prev.height==1)
+                            memcpy(s+TILE_SIZE,s,TILE_SIZE*sizeof(T));
+                    }
+                }
+
+                for(int i=0;i<4;i++)
+                {
+                    T *dst=tile+(i>>1)*HALF*TILE_SIZE+(i&1)*HALF;
+
+                    if(src[i])
+                    {
+                        DownsampleBox2x(dst,TILE_SIZE*sizeof(T),src[i],TILE_SIZE*sizeof(T),HALF,HALF,C,CHANNEL_BITS);
+                    }
+                    else
+                    {
+                        for(int y=0;y<HALF;y++)
+                            FillPixels<T>(dst+y*TILE_SIZE,clear_color,HALF);
+                    }
+                }
+
+                return tile;
+            }
+
+        public:
+
+            TiledBitmap(BitmapAllocator *ba=nullptr)
+            {
+                hgl_zero(clear_color);
+                resident_tiles=0;
+                allocator=ba?ba:GetDefaultBitmapAllocator();
+            }
+
+            TiledBitmap(const TiledBitmap &)=delete;
+            TiledBitmap &operator=(const TiledBitmap &)=delete;
+
+            ~TiledBitmap()
+            {
+                Clear();
+            }
+
+            /**
+             * 创建分块位图，不分配任何分块
+             * @param w 宽
+             * @param h 高
+             * @param cc 清除色，未分配的分块视为此颜色
+             * @param mipmap 是否带有mipmap(直到1x1)
+             */
+            bool Create(const uint w,const uint h,const T &cc,const bool mipmap=false)
+            {
+                Clear();
+
+                if(!w||!h)return(false);
+
+                const uint max_tiles=(1<<16);
+
+                if(((w+TILE_SIZE-1)>>TILED_BITMAP_TILE_SHIFT)>max_tiles
+                 ||((h+TILE_SIZE-1)>>TILED_BITMAP_TILE_SHIFT)>max_tiles)
+                    return(false);
+
+                clear_color=cc;
+
+                int lw=w,lh=h;
+
+                for(;;)
+                {
+                    TileLevel lv;
+
+                    lv.width=lw;
+                    lv.height=lh;
+
+                    const size_t count=lv.SetTileCount((lw+TILE_SIZE-1)>>TILED_BITMAP_TILE_SHIFT,
+                                                       (lh+TILE_SIZE-1)>>TILED_BITMAP_TILE_SHIFT);
+
+                    lv.tiles.resize(count,nullptr);
+                    lv.stale.resize(count,0);
+
+                    levels.push_back(std::move(lv));
+
+                    if(!mipmap||(lw==1&&lh==1))
+                        break;
+
+                    lw=(lw>1?lw>>1:1);
+                    lh=(lh>1?lh>>1:1);
+                }
+
+                return(true);
+            }
+
+            void Clear()
+            {
+                for(TileLevel &lv:levels)
+                    for(T *&tile:lv.tiles)
+                        FreeTile(tile);
+
+                levels.clear();
+            }
+
+            const bool  IsEmpty         ()const{return levels.empty();}
+
+            const uint  GetChannels     ()const{return C;}
+            const uint  GetChannelBits  ()const{return CHANNEL_BITS;}
+
+            const int   GetWidth        (const uint level=0)const{return level<levels.size()?levels[level].width:0;}
+            const int   GetHeight       (const uint level=0)const{return level<levels.size()?levels[level].height:0;}
+            const int   GetTileCols     (const uint level=0)const{return level<levels.size()?levels[level].cols:0;}
+            const int   GetTileRows     (const uint level=0)const{return level<levels.size()?levels[level].rows:0;}
+            const uint  GetLevelCount   ()const{return uint(levels.size());}
+
+            const T &   GetClearColor   ()const{return clear_color;}
+
+            const uint  GetResidentTileCount()const{return resident_tiles;}                     ///<已分配的分块数量(含mipmap)
+            const size_t GetResidentBytes   ()const{return size_t(resident_tiles)*TILE_BYTES;}  ///<已分配的象素内存字节数
+
+            /**
+             * 取得已分配的分块，未分配时返回nullptr(表示全部为清除色)
+             */
+            const T *GetTile(const int tx,const int ty)const
+            {
+                if(levels.empty())return(nullptr);
+
+                const TileLevel &lv=levels[0];
+
+                if(tx<0||ty<0||tx>=lv.cols||ty>=lv.rows)return(nullptr);
+
+                return lv.tiles[lv.GetIndex(tx,ty)];
+            }
+
+            /**
+             * 取得要写入的分块，未分配时分配之<br>
+             * 调用后即认为此分块已被修改，包含它的各级mipmap分块将在下次读取时重新生成。
+             */
+            T *AcquireTile(const int tx,const int ty)
+            {
+                if(levels.empty())return(nullptr);
+
+                TileLevel &lv=levels[0];
+
+                if(tx<0||ty<0||tx>=lv.cols||ty>=lv.rows)return(nullptr);
+
+                T *&tile=lv.tiles[lv.GetIndex(tx,ty)];
+
+                if(!tile)
+                {
+                    tile=AllocTile();
+
+                    if(!tile)return(nullptr);
+                }
+
+                InvalidateMips(tx,ty);
+                return tile;
+            }
+
+            /**
+             * 释放一个分块，此后它视为全部为清除色
+             */
+            void ReleaseTile(const int tx,const int ty)
+            {
+                if(levels.empty())return;
+
+                TileLevel &lv=levels[0];
+
+                if(tx<0||ty<0||tx>=lv.cols||ty>=lv.rows)return;
+
+                T *&tile=lv.tiles[lv.GetIndex(tx,ty)];
+
+                if(!tile)return;
+
+                FreeTile(tile);
+                InvalidateMips(tx,ty);
+            }
+
+            /**
+             * 取得分块的可写视图，视图宽高已按图片边界裁剪
+             */
+            bool GetTileView(const int tx,const int ty,TileView *view)
+            {
+                if(!view)return(false);
+
+                T *tile=AcquireTile(tx,ty);
+
+                if(!tile)return(false);
+
+                const TileLevel &lv=levels[0];
+
+                const int w=lv.width -(tx<<TILED_BITMAP_TILE_SHIFT);
+                const int h=lv.height-(ty<<TILED_BITMAP_TILE_SHIFT);
+
+                *view=TileView(tile,w<TILE_SIZE?w:TILE_SIZE,h<TILE_SIZE?h:TILE_SIZE,TILE_SIZE);
+                return(true);
+            }
+
+            /**
+             * 取得指定级别mipmap的分块，需要时由上一级生成
+             * @return 全部为清除色时返回nullptr
+             */
+            const T *GetMipTile(const uint level,const int tx,const int ty)
+            {
+                if(level>=levels.size())return(nullptr);
+
+                const TileLevel &lv=levels[level];
+
+                if(tx<0||ty<0||tx>=lv.cols||ty>=lv.rows)return(nullptr);
+
+                if(level==0)
+                    return lv.tiles[lv.GetIndex(tx,ty)];
+
+                return UpdateMipTile(level,tx,ty);
+            }
+
+            const T GetPixel(const int x,const int y)const
+            {
+                if(levels.empty()
+                 ||x<0||y<0||x>=levels[0].width||y>=levels[0].height)
+                    return clear_color;
+
+                const T *tile=GetTile(x>>TILED_BITMAP_TILE_SHIFT,y>>TILED_BITMAP_TILE_SHIFT);
+
+                if(!tile)return clear_color;
+
+                return tile[(y&(TILE_SIZE-1))*TILE_SIZE+(x&(TILE_SIZE-1))];
+            }
+
+            /**
+             * 取得指定级别mipmap中的象素，需要时生成对应分块
+             */
+            const T GetMipPixel(const uint level,const int x,const int y)
+            {
+                if(level>=levels.size()
+                 ||x<0||y<0||x>=levels[level].width||y>=levels[level].height)
+                    return clear_color;
+
+                const T *tile=GetMipTile(level,x>>TILED_BITMAP_TILE_SHIFT,y>>TILED_BITMAP_TILE_SHIFT);
+
+                if(!tile)return clear_color;
+
+                return tile[(y&(TILE_SIZE-1))*TILE_SIZE+(x&(TILE_SIZE-1))];
+            }
+
+            /**
+             * 取得可写入的象素地址，所在分块未分配时分配之
+             */
+            T *GetData(const int x,const int y)
+            {
+                if(levels.empty()
+                 ||x<0||y<0||x>=levels[0].width||y>=levels[0].height)
+                    return(nullptr);
+
+                T *tile=AcquireTile(x>>TILED_BITMAP_TILE_SHIFT,y>>TILED_BITMAP_TILE_SHIFT);
+
+                if(!tile)return(nullptr);
+
+                return tile+(y&(TILE_SIZE-1))*TILE_SIZE+(x&(TILE_SIZE-1));
+            }
+
+            /**
+             * 对区域所覆盖的每个分块调用func，分块在调用前分配
+             * @param func 形如func(TileView &view,int left,int top)，view为分块中位于区域内的部分，left/top为view左上角在整个图片中的坐标
+             * @return 调用的分块数量
+             */
+            template<typename F>
+            uint ForEachTile(int l,int t,int w,int h,F func)
+            {
+                if(levels.empty())return(0);
+
+                const TileLevel &lv=levels[0];
+
+                if(l<0){w+=l;l=0;}
+                if(t<0){h+=t;t=0;}
+                if(l+w>lv.width)w=lv.width-l;
+                if(t+h>lv.height)h=lv.height-t;
+
+                if(w<=0||h<=0)return(0);
+
+                const int r=l+w;
+                const int b=t+h;
+
+                uint count=0;
+                TileView tile_view;
+
+                for(int ty=t>>TILED_BITMAP_TILE_SHIFT;ty<=(b-1)>>TILED_BITMAP_TILE_SHIFT;ty++)
+                    for(int tx=l>>TILED_BITMAP_TILE_SHIFT;tx<=(r-1)>>TILED_BITMAP_TILE_SHIFT;tx++)
+                    {
+                        if(!GetTileView(tx,ty,&tile_view))
+                            continue;
+
+                        const int tl=tx<<TILED_BITMAP_TILE_SHIFT;
+                        const int tt=ty<<TILED_BITMAP_TILE_SHIFT;
+
+                        const int vl=(l>tl?l:tl);
+                        const int vt=(t>tt?t:tt);
+
+                        TileView view=tile_view.GetSubView(vl-tl,vt-tt,r-vl,b-vt);
+
+                        func(view,vl,vt);
+                        ++count;
+                    }
+
+                return count;
+            }
+
+            /**
+             * 将一块象素写入图片
+             * @param left 写入位置
+             * @param top 写入位置
+             */
+            bool CopyFrom(const BitmapView<T,C> *src,const int left,const int top)
+            {
+                if(!src||src->IsEmpty())return(false);
+
+                return ForEachTile(left,top,src->GetWidth(),src->GetHeight(),[src,left,top](TileView &view,const int vl,const int vt)
+                {
+                    const int w=view.GetWidth();
+
+                    for(int y=0;y<view.GetHeight();y++)
+                        memcpy(view.GetLine(y),src->GetData(vl-left,vt-top+y),w*sizeof(T));
+                });
+            }
+
+            /**
+             * 从指定级别读出一块象素，图片以外的部分填充清除色
+             * @param dst 目标，尺寸即为读取的区域大小
+             * @param left 读取位置
+             * @param top 读取位置
+             * @param level mipmap级别
+             */
+            bool CopyTo(BitmapView<T,C> *dst,const int left,const int top,const uint level=0)
+            {
+                if(!dst||dst->IsEmpty()||level>=levels.size())return(false);
+
+                const TileLevel &lv=levels[level];
+
+                const int w=dst->GetWidth();
+                const int h=dst->GetHeight();
+
+                for(int y=0;y<h;y++)
+                {
+                    T *p=dst->GetLine(y);
+                    const int sy=top+y;
+
+                    if(sy<0||sy>=lv.height)
+                    {
+                        FillPixels<T>(p,clear_color,w);
+                        continue;
+                    }
+
+                    int x=0;
+
+                    while(x<w)
+                    {
+                        const int sx=left+x;
+
+                        if(sx<0||sx>=lv.width)
+                        {
+                            p[x++]=clear_color;
+                            continue;
+                        }
+
+                        //复制到当前分块的右边界
+                        int n=TILE_SIZE-(sx&(TILE_SIZE-1));
+
+                        if(n>w-x)n=w-x;
+                        if(n>lv.width-sx)n=lv.width-sx;
+
+                        const T *tile=GetMipTile(level,sx>>TILED_BITMAP_TILE_SHIFT,sy>>TILED_BITMAP_TILE_SHIFT);
+
+                        if(tile)
+                            memcpy(p+x,tile+(sy&(TILE_SIZE-1))*TILE_SIZE+(sx&(TILE_SIZE-1)),n*sizeof(T));
+                        else
+                            FillPixels<T>(p+x,clear_color,n);
+
+                        x+=n;
+                    }
+                }
+
+                return(true);
+            }
+        };//template<typename T,uint C> class TiledBitmap
+
+        using TiledBitmapGrey8=TiledBitmap<uint8,1>;
+        using TiledBitmapRG8=TiledBitmap<Vector2u8,2>;
+        using TiledBitmapRGB8=TiledBitmap<Vector3u8,3>;
+        using TiledBitmapRGBA8=TiledBitmap<Vector4u8,4>;
+
+        using TiledBitmapU16=TiledBitmap<uint16,1>;
+        using TiledBitmapU32=TiledBitmap<uint32,1>;
+
+        /**
+         * 在分块位图的一个区域内使用DrawGeometry绘制<br>
+         * dg会依次指向区域内的每个分块，并以区域作为裁剪范围，func中以分块内的坐标绘制，即整图坐标减去ox,oy。<br>
+         * 完成后dg恢复原来的绘制目标，裁剪区域被关闭。
+         * @param dg DrawGeometry<T,BitmapView<T,C>,...>
+         * @param func 形如func(DG &dg,int ox,int oy)
+         */
+        template<typename T,uint C,typename DG,typename F>
+        inline uint DrawTiled(TiledBitmap<T,C> *tb,DG *dg,const int l,const int t,const int w,const int h,F func)
+        {
+            if(!tb||!dg)return(0);
+
+            auto *old_bitmap=dg->GetBitmap();
+
+            const uint count=tb->ForEachTile(l,t,w,h,[dg,&func](BitmapView<T,C> &view,const int vl,const int vt)
+            {
+                const int ox=vl&~(TILED_BITMAP_TILE_SIZE-1);
+                const int oy=vt&~(TILED_BITMAP_TILE_SIZE-1);
+
+                //view已裁剪到区域内，但func使用的是分块坐标，所以以分块为目标并把view作为裁剪区域
+                BitmapView<T,C> tile(view.GetData()-((vt-oy)*TILED_BITMAP_TILE_SIZE+(vl-ox)),
+                                     (vl-ox)+view.GetWidth(),
+                                     (vt-oy)+view.GetHeight(),
+                                     TILED_BITMAP_TILE_SIZE);
+
+                dg->SetBitmap(&tile);
+                dg->SetClipRect(vl-ox,vt-oy,view.GetWidth(),view.GetHeight());
+
+                func(*dg,ox,oy);
+            });
+
+            dg->CloseClipRect();
+            dg->SetBitmap(old_bitmap);
+
+            return count;
+        }
+
+        /**
+         * 将一张位图混合到分块位图上
+         * @param blend 位图混合器，如BlendBitmapRGBA8toRGBA8
+         */
+        template<typename ST,uint SC,typename T,uint C,typename BB>
+        inline bool BlendBitmapToTiled(TiledBitmap<T,C> *dst,const int left,const int top,const BitmapView<ST,SC> *src,const float alpha,const BB &blend)
+        {
+            if(!dst||!src||src->IsEmpty())return(false);
+
+            return dst->ForEachTile(left,top,src->GetWidth(),src->GetHeight(),[&](BitmapView<T,C> &view,const int vl,const int vt)
+            {
+                const BitmapView<ST,SC> sub=src->GetSubView(vl-left,vt-top,view.GetWidth(),view.GetHeight());
+
+                blend(&sub,&view,alpha);
+            });
+        }
+    }//namespace bitmap
+}//namespace hgl
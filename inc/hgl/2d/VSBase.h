@@ -1,6 +1,12 @@
 ﻿#ifndef HGL_VSBASE_INCLUDE
 #define HGL_VSBASE_INCLUDE
 
+#include<hgl/type/DataType.h>
+#include<hgl/2d/BitmapView.h>
+#include<hgl/2d/BitmapAllocator.h>
+#include<hgl/2d/DirtyRegion.h>
+#include<vector>
+
 namespace hgl
 {
     namespace vs
@@ -15,26 +21,118 @@ namespace hgl
             F32,F64,
         };
 
+        /**
+         * 取得指定数据格式单个成份的字节数
+         */
+        inline const uint GetDataFormatBytes(const DataFormat df)
+        {
+            switch(df)
+            {
+                case DataFormat::U8:
+                case DataFormat::S8:    return 1;
+                case DataFormat::U16:
+                case DataFormat::S16:   return 2;
+                case DataFormat::U32:
+                case DataFormat::S32:
+                case DataFormat::F32:   return 4;
+                case DataFormat::F64:   return 8;
+                default:                return 0;
+            }
+        }
+
         struct VSDataSource
         {
             void *pixel_data=nullptr;                                           ///<象素数据
+            uint line_bytes=0;                                                  ///<每一行象素数据的字节数
 
         public:
 
-            virtual ~VSDataSource()=0;
+            virtual ~VSDataSource()=default;
         };//class VSDataSource
 
+        /**
+         * 引用外部内存的数据源，不负责释放
+         */
         struct VSDataSourceRef:public VSDataSource
         {
         public:
 
+            VSDataSourceRef(void *pd,const uint lb)
+            {
+                pixel_data=pd;
+                line_bytes=lb;
+            }
+
+            /**
+             * 数据源只支持从上往下存放，从下往上存放的视图按内存行序引用，看到的图像是上下颠倒的
+             */
+            template<typename T,uint C>
+            VSDataSourceRef(bitmap::BitmapView<T,C> &bv)
+            {
+                pixel_data=bv.GetMemory();
+                line_bytes=bv.GetLineBytes();
+            }
+
             ~VSDataSourceRef() override {}
-        };//
+        };//struct VSDataSourceRef
+
+        /**
+         * 自行分配内存的数据源
+         */
+        struct VSDataSourceCreate:public VSDataSource
+        {
+        public:
+
+            VSDataSourceCreate(const uint lb,const uint height)
+            {
+                line_bytes=lb;
+                pixel_data=bitmap::AlignedAlloc(size_t(lb)*height);
+            }
+
+            ~VSDataSourceCreate() override
+            {
+                bitmap::AlignedFree(pixel_data);
+            }
+        };//struct VSDataSourceCreate
+
+        /**
+         * 多成份数据的存放方式
+         */
+        enum class VSLayout
+        {
+            Interleaved,                                                        ///<交错(AoS)，各成份依次存放在同一象素内
+            Planar,                                                             ///<平面(SoA)，每个成份单独存放为一个平面
+        };
 
-        class VSDataSourceCreate
+        constexpr uint VS_LINE_ALIGN=64;                                        ///<自行分配数据时每行(平面布局时为每个平面的每行)按缓存行对齐，并取整到整数个象素
 
         /**
-         * 虚拟屏幕数据源
+         * 一个成份的访问方式，交错与平面布局都可以此描述
+         */
+        struct VSChannel
+        {
+            uint8 *data=nullptr;                                                ///<第0行第0个象素的此成份
+            uint width=0,height=0;
+            uint line_bytes=0;                                                  ///<相邻两行之间的字节数
+            uint pixel_stride=0;                                                ///<相邻两个象素之间的字节数
+            DataFormat format=DataFormat::U8;
+
+        public:
+
+            const bool IsEmpty()const{return !data;}
+
+            /**
+             * 同一行中的成份是否连续存放(平面布局或单成份)
+             */
+            const bool IsContinuous()const{return pixel_stride==GetDataFormatBytes(format);}
+
+            uint8 *GetLine(const uint row)const{return data+size_t(row)*line_bytes;}
+        };//struct VSChannel
+
+        /**
+         * 虚拟屏幕数据源<br>
+         * 每个成份可以有不同的数据格式。平面布局时各平面在数据源中依次存放，
+         * 每个平面每行占width*成份字节数按VS_LINE_ALIGN与成份字节数的最小公倍数对齐后的字节，数据源的line_bytes须不小于各平面每行字节数之和。
          */
         class VSData
         {
@@ -43,24 +141,116 @@ namespace hgl
             uint width,height;                                                  ///<尺寸
             uint color_component;                                               ///<颜色成份数量(1-4)
             DataFormat data_format[4];                                          ///<数据格式
+            VSLayout layout;                                                    ///<存放方式
 
-            uint pixel_bytes;                                                   ///<每象素字节数
-            uint line_bytes;                                                    ///<每一行象素数据的字节数
+            uint pixel_bytes;                                                   ///<每象素字节数(各成份字节数之和)
+            uint line_bytes;                                                    ///<每一行象素数据的字节数(平面布局时为各平面之和)
+
+            uint component_offset[4];                                           ///<交错布局时为成份在象素内的偏移，平面布局时为平面的起始偏移
+            uint plane_line_bytes[4];                                           ///<每个平面每行的字节数(交错布局时均为line_bytes)
+
+            VSDataSource *source;                                               ///<数据源(由VSData负责删除)
+            void *pixel_data;
 
         public:
 
             VSData()
             {
+                width=height=0;
+                color_component=0;
+                layout=VSLayout::Interleaved;
+                pixel_bytes=line_bytes=0;
+                source=nullptr;
                 pixel_data=nullptr;
+
+                for(uint i=0;i<4;i++)
+                {
+                    data_format[i]=DataFormat::U8;
+                    component_offset[i]=0;
+                    plane_line_bytes[i]=0;
+                }
+            }
+
+            virtual ~VSData()
+            {
+                delete source;
             }
 
-            virtual ~VSData()=0;
+            /**
+             * 求出自行分配数据时每行所需的字节数(平面布局时为各平面之和)
+             * @return 参数错误时返回0
+             */
+            static uint ComputeLineBytes(const uint w,const uint cc,const DataFormat *df,const VSLayout layout);
+
+            /**
+             * 设置数据源
+             * @param src 数据源，将由本对象负责删除，失败时不删除
+             * @param w 宽
+             * @param h 高
+             * @param cc 颜色成份数量(1-4)
+             * @param df 各成份的数据格式(cc个)
+             * @param layout 存放方式
+             */
+            bool SetSource(VSDataSource *src,const uint w,const uint h,const uint cc,const DataFormat *df,const VSLayout layout=VSLayout::Interleaved);
+
+            bool SetSource(VSDataSource *src,const uint w,const uint h,const uint cc,const DataFormat df,const VSLayout layout=VSLayout::Interleaved)
+            {
+                const DataFormat fmt[4]={df,df,df,df};
+
+                return SetSource(src,w,h,cc,fmt,layout);
+            }
+
+            /**
+             * 分配数据并清零
+             */
+            bool Create(const uint w,const uint h,const uint cc,const DataFormat *df,const VSLayout layout=VSLayout::Interleaved);
+
+            bool Create(const uint w,const uint h,const uint cc,const DataFormat df,const VSLayout layout=VSLayout::Interleaved)
+            {
+                const DataFormat fmt[4]={df,df,df,df};
+
+                return Create(w,h,cc,fmt,layout);
+            }
+
+            const uint GetWidth()const{return width;}
+            const uint GetHeight()const{return height;}
+            const uint GetColorComponent()const{return color_component;}
+            const VSLayout GetLayout()const{return layout;}
+            const bool IsPlanar()const{return layout==VSLayout::Planar;}
+            const uint GetPixelBytes()const{return pixel_bytes;}
+            const uint GetLineBytes()const{return line_bytes;}
+
+            const DataFormat GetDataFormat(const uint index=0)const{return data_format[index<4?index:0];}
+
+            /**
+             * 取得一个成份的访问方式，序号无效时返回空
+             */
+            VSChannel GetChannel(const uint index)const
+            {
+                VSChannel ch;
+
+                if(!pixel_data||index>=color_component)
+                    return ch;
+
+                ch.data=((uint8 *)pixel_data)+component_offset[index];
+                ch.width=width;
+                ch.height=height;
+                ch.line_bytes=plane_line_bytes[index];
+                ch.pixel_stride=(layout==VSLayout::Planar?GetDataFormatBytes(data_format[index]):pixel_bytes);
+                ch.format=data_format[index];
+
+                return ch;
+            }
 
             void *GetPointer(){return pixel_data;}
+            const void *GetPointer()const{return pixel_data;}
 
+            /**
+             * 取得一行的起始地址，平面布局时返回nullptr，须使用GetChannel
+             */
             void *GetPointer(uint row)
             {
-                if(row>=height)return(nullptr);
+                if(row>=height||layout!=VSLayout::Interleaved)return(nullptr);
 
                 return ((uint8 *)pixel_data)+row*line_bytes;
             }
@@ -69,16 +259,180 @@ namespace hgl
             {
                 if(col>=width)return(nullptr);
                 if(row>=height)return(nullptr);
+                if(layout!=VSLayout::Interleaved)return(nullptr);
 
                 return ((uint8 *)pixel_data)+row*line_bytes+col*pixel_bytes;
             }
+
+            const void *GetPointer(uint col,uint row)const
+            {
+                return const_cast<VSData *>(this)->GetPointer(col,row);
+            }
+
+            /**
+             * 是否与另一个数据源尺寸、成份、格式与存放方式完全相同
+             */
+            const bool IsSameFormat(const VSData *vd)const
+            {
+                if(!vd)return(false);
+
+                if(width!=vd->width||height!=vd->height)return(false);
+                if(color_component!=vd->color_component||pixel_bytes!=vd->pixel_bytes)return(false);
+                if(layout!=vd->layout)return(false);
+
+                for(uint i=0;i<color_component;i++)
+                    if(data_format[i]!=vd->data_format[i])
+                        return(false);
+
+                return(true);
+            }
+
+            /**
+             * 以指定类型的位图视图访问交错布局的数据，象素尺寸或行跨度不符时返回空视图
+             */
+            template<typename T,uint C> bitmap::BitmapView<T,C> GetBitmapView()
+            {
+                if(!pixel_data||layout!=VSLayout::Interleaved||C!=color_component||sizeof(T)!=pixel_bytes||line_bytes%sizeof(T))
+                    return bitmap::BitmapView<T,C>();
+
+                return bitmap::BitmapView<T,C>((T *)pixel_data,width,height,line_bytes/sizeof(T));
+            }
+
+            /**
+             * 以单通道位图视图访问一个连续存放的成份(平面布局或只有一个成份)
+             */
+            template<typename T> bitmap::BitmapView<T,1> GetChannelView(const uint index)
+            {
+                const VSChannel ch=GetChannel(index);
+
+                if(ch.IsEmpty()||!ch.IsContinuous()||sizeof(T)!=ch.pixel_stride||ch.line_bytes%sizeof(T))
+                    return bitmap::BitmapView<T,1>();
+
+                return bitmap::BitmapView<T,1>((T *)ch.data,width,height,ch.line_bytes/sizeof(T));
+            }
         };//class VSData
 
+        using bitmap::ClipRect;
+        using bitmap::DirtyRegion;
+
+        constexpr uint VS_MAX_BUFFER_AGE=4;                                     ///<保留历史脏区域的帧数
+
         /**
-         * 虚拟屏幕基类
+         * 将src中指定范围的数据复制到dst，两者格式须相同
+         */
+        bool CopyRegion(VSData *dst,const VSData *src,const ClipRect &rect);
+
+        /**
+         * 仅将脏区域内的数据从src复制到dst，两者格式须相同
+         * @return 复制的矩形数量
+         */
+        uint CopyDirtyRegion(VSData *dst,const VSData *src,const DirtyRegion &dirty);
+
+        /**
+         * 虚拟屏幕基类<br>
+         * 持有若干相同尺寸的表面，所有表面共用一个脏区域。绘制时将脏区域交给DrawGeometry::SetDirtyRegion，
+         * Present时只将脏区域交给OnPresent输出或编码，之后清空脏区域，并保留最近几帧的记录，供多缓冲输出时求出每个缓冲区需要更新的范围。
          */
         class VSBase
         {
+        protected:
+
+            uint width,height;
+
+            std::vector<VSData *> surface_list;                                 ///<表面(由VSBase负责删除)
+
+            DirtyRegion dirty;                                                  ///<自上一次Present以来修改过的范围
+            DirtyRegion history[VS_MAX_BUFFER_AGE];                             ///<之前几帧的脏区域，[0]为最近一帧
+            uint history_count;
+
+            uint64 frame_count;
+
+        protected:
+
+            /**
+             * 输出本帧，派生类在此将脏区域内的数据送往显示设备或编码器
+             * @param vs_dirty 本帧的脏区域，不会为空
+             */
+            virtual bool OnPresent(const DirtyRegion &vs_dirty){return(true);}
+
+        public:
+
+            VSBase();
+            virtual ~VSBase();
+
+            /**
+             * 设置虚拟屏幕尺寸，原有表面全部删除，整个屏幕标记为脏
+             */
+            bool Create(const uint w,const uint h);
+
+            void ClearSurface();                                                ///<删除所有表面
+
+            const uint GetWidth()const{return width;}
+            const uint GetHeight()const{return height;}
+            const uint64 GetFrameCount()const{return frame_count;}
+
+            /**
+             * 创建一个新表面，内容清零
+             * @param cc 颜色成份数量(1-4)
+             * @param df 各成份的数据格式(cc个)
+             * @param layout 存放方式
+             * @return 表面序号，失败返回-1
+             */
+            int AddSurface(const uint cc,const DataFormat *df,const VSLayout layout=VSLayout::Interleaved);
+
+            int AddSurface(const uint cc,const DataFormat df,const VSLayout layout=VSLayout::Interleaved)
+            {
+                const DataFormat fmt[4]={df,df,df,df};
+
+                return AddSurface(cc,fmt,layout);
+            }
+
+            /**
+             * 添加一个使用外部数据源的表面(如映射的帧缓冲区)
+             * @param src 数据源，将由VSBase负责删除，失败时也会被删除
+             * @return 表面序号，失败返回-1
+             */
+            int AddSurface(VSDataSource *src,const uint cc,const DataFormat df,const VSLayout layout=VSLayout::Interleaved);
+
+            const uint GetSurfaceCount()const{return uint(surface_list.size());}
+
+            VSData *GetSurface(const uint index=0)const
+            {
+                return index<surface_list.size()?surface_list[index]:nullptr;
+            }
+
+            template<typename T,uint C> bitmap::BitmapView<T,C> GetBitmapView(const uint index=0)const
+            {
+                VSData *vd=GetSurface(index);
+
+                return vd?vd->GetBitmapView<T,C>():bitmap::BitmapView<T,C>();
+            }
+
+            DirtyRegion *GetDirtyRegion(){return &dirty;}                       ///<取得脏区域，交给DrawGeometry::SetDirtyRegion使用
+            const DirtyRegion &GetDirtyRegion()const{return dirty;}
+
+            const bool IsDirty()const{return !dirty.IsEmpty();}
+
+            void Invalidate(){dirty.AddAll();}                                  ///<将整个屏幕标记为脏
+            void Invalidate(const ClipRect &rect){dirty.Add(rect);}
+            void Invalidate(const int left,const int top,const int w,const int h){dirty.Add(left,top,left+w,top+h);}
+
+            /**
+             * 求出一个缓冲区需要更新的范围
+             * @param damage 输出的范围
+             * @param age 缓冲区中的内容是几帧之前的(1为上一帧)，为0或超出保留的历史时为整个屏幕
+             */
+            void GetDamage(DirtyRegion *damage,const uint age)const;
+
+            /**
+             * 没有脏区域时直接返回，否则调用OnPresent输出，成功后结束本帧
+             */
+            bool Present();
+
+            /**
+             * 结束本帧：本帧的脏区域存入历史，然后清空
+             */
+            void EndFrame();
         };//class VSBase
 
 
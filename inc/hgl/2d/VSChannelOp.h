@@ -0,0 +1,52 @@
+#pragma once
+
+#include<hgl/2d/VSBase.h>
+
+/**
+ * 按成份处理虚拟屏幕数据
+ *
+ * 所有函数都逐个成份处理，对平面布局(或单成份)连续存放的常用格式组合使用SIMD，
+ * 交错布局按象素跨度逐个处理。转换为整数格式时四舍五入(偶数优先)并饱和到该格式的范围，NaN转换为最小值。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        class TaskPool;
+    }//namespace bitmap
+
+    namespace vs
+    {
+        /**
+         * 以同一个值填充一个成份
+         * @param value 填充值，按成份格式转换
+         * @param pool 按行带并行处理所用的任务池，可为nullptr
+         */
+        bool FillChannel(const VSChannel &ch,const double value,bitmap::TaskPool *pool=nullptr);
+
+        /**
+         * 转换一个成份的数据:dst=src*scale+bias<br>
+         * 两者尺寸须相同，格式可以不同。dst与src可以是同一个成份。
+         */
+        bool ConvertChannel(const VSChannel &dst,const VSChannel &src,const double scale=1,const double bias=0,bitmap::TaskPool *pool=nullptr);
+
+        /**
+         * 缩放一个成份的数据:v=v*scale+bias
+         */
+        inline bool ScaleChannel(const VSChannel &ch,const double scale,const double bias=0,bitmap::TaskPool *pool=nullptr)
+        {
+            return ConvertChannel(ch,ch,scale,bias,pool);
+        }
+
+        /**
+         * 以各成份的值填充整个数据源
+         * @param value 每个成份的填充值(color_component个)
+         */
+        bool FillSurface(VSData *vd,const double *value,bitmap::TaskPool *pool=nullptr);
+
+        /**
+         * 逐个成份转换整个数据源，两者尺寸和成份数量须相同，格式与存放方式可以不同(如平面F32转交错U8用于显示)
+         */
+        bool ConvertSurface(VSData *dst,const VSData *src,const double scale=1,const double bias=0,bitmap::TaskPool *pool=nullptr);
+    }//namespace vs
+}//namespace hgl
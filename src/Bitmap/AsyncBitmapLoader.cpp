@@ -0,0 +1,161 @@
+#include<hgl/2d/AsyncBitmapLoader.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        AsyncBatchLoader::AsyncBatchLoader(uint thread_count,const uint64 max_bytes_in_flight)
+        {
+            next_job=0;
+            finished_count=0;
+            cancel=false;
+            quit=false;
+
+            max_bytes=max_bytes_in_flight;
+            bytes_in_flight=0;
+
+            if(thread_count==0)
+            {
+                thread_count=std::thread::hardware_concurrency();
+
+                if(thread_count==0)
+                    thread_count=1;
+            }
+
+            for(uint i=0;i<thread_count;i++)
+                workers.emplace_back(&AsyncBatchLoader::WorkerProc,this);
+        }
+
+        AsyncBatchLoader::~AsyncBatchLoader()
+        {
+            StopWorkers();
+        }
+
+        void AsyncBatchLoader::StopWorkers()
+        {
+            if(workers.empty())return;
+
+            {
+                std::lock_guard<std::mutex> lg(lock);
+                quit=true;
+                cancel=true;
+            }
+
+            job_cv.notify_all();
+            bytes_cv.notify_all();
+
+            for(std::thread &t:workers)
+                t.join();
+
+            workers.clear();
+        }
+
+        void AsyncBatchLoader::WorkerProc()
+        {
+            for(;;)
+            {
+                uint index;
+                OSString filename;
+                bool skip;
+
+                {
+                    std::unique_lock<std::mutex> ul(lock);
+
+                    job_cv.wait(ul,[&]{return quit||next_job<filename_list.size();});
+
+                    if(quit)return;
+
+                    index=next_job++;
+                    filename=filename_list[index];
+                    skip=cancel;
+                }
+
+                //取消时不再载入，但仍计入完成数量，保证Wait可以返回
+                if(!skip)
+                    LoadFile(index,filename);
+
+                std::lock_guard<std::mutex> lg(lock);
+
+                if(++finished_count>=filename_list.size())
+                    done_cv.notify_all();
+            }
+        }
+
+        bool AsyncBatchLoader::AcquireBytes(const uint64 bytes)
+        {
+            std::unique_lock<std::mutex> ul(lock);
+
+            bytes_cv.wait(ul,[&]{return cancel||bytes_in_flight==0||bytes_in_flight+bytes<=max_bytes;});
+
+            if(cancel)return(false);
+
+            bytes_in_flight+=bytes;
+            return(true);
+        }
+
+        void AsyncBatchLoader::ReleaseBytes(const uint64 bytes)
+        {
+            {
+                std::lock_guard<std::mutex> lg(lock);
+
+                bytes_in_flight-=(bytes<bytes_in_flight?bytes:bytes_in_flight);
+            }
+
+            bytes_cv.notify_all();
+        }
+
+        bool AsyncBatchLoader::Start(const std::vector<OSString> &filenames)
+        {
+            if(filenames.empty()||workers.empty())
+                return(false);
+
+            {
+                std::lock_guard<std::mutex> lg(lock);
+
+                if(finished_count<filename_list.size())
+                    return(false);
+
+                filename_list=filenames;
+                next_job=0;
+                finished_count=0;
+                cancel=false;
+            }
+
+            job_cv.notify_all();
+            return(true);
+        }
+
+        void AsyncBatchLoader::Wait()
+        {
+            std::unique_lock<std::mutex> ul(lock);
+
+            done_cv.wait(ul,[&]{return finished_count>=filename_list.size();});
+        }
+
+        void AsyncBatchLoader::Cancel()
+        {
+            {
+                std::lock_guard<std::mutex> lg(lock);
+                cancel=true;
+            }
+
+            bytes_cv.notify_all();
+
+            Wait();
+        }
+
+        const bool AsyncBatchLoader::IsFinished()const
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            return finished_count>=filename_list.size();
+        }
+
+        const uint AsyncBatchLoader::GetFinishedCount()const
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            return finished_count;
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,128 @@
+#include<hgl/2d/AsyncBitmapSaver.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        AsyncTGASaver::AsyncTGASaver(const TGASaveOption &opt,const uint mp,const Callback &cb)
+        {
+            option=opt;
+            callback=cb;
+            max_pending=mp;
+            busy=false;
+            quit=false;
+            saved_count=0;
+            failed_count=0;
+
+            worker=std::thread(&AsyncTGASaver::WorkerProc,this);
+        }
+
+        AsyncTGASaver::~AsyncTGASaver()
+        {
+            {
+                std::lock_guard<std::mutex> lg(lock);
+                quit=true;
+            }
+
+            job_cv.notify_all();
+            worker.join();
+        }
+
+        void AsyncTGASaver::Push(Job &&job)
+        {
+            {
+                std::unique_lock<std::mutex> ul(lock);
+
+                if(max_pending)
+                    done_cv.wait(ul,[&]{return job_list.size()+(busy?1:0)<max_pending;});
+
+                job_list.push_back(std::move(job));
+            }
+
+            job_cv.notify_one();
+        }
+
+        bool AsyncTGASaver::SaveJob(const Job &job)
+        {
+            io::OpenFileOutputStream fos(job.filename,io::FileOpenMode::CreateTrunc);
+
+            if(!fos)
+                return(false);
+
+            TGASaveOption job_option=option;
+
+            job_option.bottom_up=job.bottom_up;
+
+            return SaveBitmapToTGA(&fos,job.data,job.width,job.height,job.channels,job.channel_bits,job.line_bytes,job_option);
+        }
+
+        void AsyncTGASaver::WorkerProc()
+        {
+            for(;;)
+            {
+                Job job;
+
+                {
+                    std::unique_lock<std::mutex> ul(lock);
+
+                    //退出前先保存完所有已提交的图片
+                    job_cv.wait(ul,[&]{return quit||!job_list.empty();});
+
+                    if(job_list.empty())return;
+
+                    job=std::move(job_list.front());
+                    job_list.pop_front();
+                    busy=true;
+                }
+
+                const bool result=SaveJob(job);
+
+                job.allocator->Free(job.data,job.data_bytes);
+
+                if(callback)
+                    callback(job.filename,result);
+
+                {
+                    std::lock_guard<std::mutex> lg(lock);
+
+                    busy=false;
+
+                    if(result)
+                        ++saved_count;
+                    else
+                        ++failed_count;
+                }
+
+                done_cv.notify_all();
+            }
+        }
+
+        void AsyncTGASaver::Flush()
+        {
+            std::unique_lock<std::mutex> ul(lock);
+
+            done_cv.wait(ul,[&]{return job_list.empty()&&!busy;});
+        }
+
+        const uint AsyncTGASaver::GetPendingCount()const
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            return uint(job_list.size())+(busy?1:0);
+        }
+
+        const uint AsyncTGASaver::GetSavedCount()const
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            return saved_count;
+        }
+
+        const uint AsyncTGASaver::GetFailedCount()const
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            return failed_count;
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,147 @@
+#include<hgl/2d/AtlasPacker.h>
+#include<cstdint>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        void SkylinePacker::Init(const int w,const int h)
+        {
+            width =(w>0?w:0);
+            height=(h>0?h:0);
+
+            Reset();
+        }
+
+        void SkylinePacker::Reset()
+        {
+            skyline.clear();
+
+            if(width>0)
+                skyline.push_back(Segment{0,0,width});
+
+            used_area=0;
+            rect_count=0;
+        }
+
+        /**
+         * 检查矩形左边与第index段对齐时能否放下
+         * @param y 返回矩形上边位置
+         * @param waste 返回矩形下方无法再使用的面积
+         */
+        bool SkylinePacker::Fit(const size_t index,const int w,const int h,int *y,uint64 *waste)const
+        {
+            const int x=skyline[index].x;
+
+            if(x+w>width)return(false);
+
+            int top=0;
+            int remain=w;
+
+            for(size_t i=index;remain>0;i++)
+            {
+                if(skyline[i].y>top)
+                    top=skyline[i].y;
+
+                if(top+h>height)return(false);
+
+                remain-=skyline[i].width;
+            }
+
+            uint64 lost=0;
+
+            remain=w;
+
+            for(size_t i=index;remain>0;i++)
+            {
+                const int sw=(skyline[i].width<remain?skyline[i].width:remain);
+
+                lost+=uint64(top-skyline[i].y)*uint64(sw);
+                remain-=sw;
+            }
+
+            *y=top;
+            *waste=lost;
+            return(true);
+        }
+
+        void SkylinePacker::Place(const size_t index,const int x,const int y,const int w,const int h)
+        {
+            skyline.insert(skyline.begin()+index,Segment{x,y+h,w});
+
+            //被新段覆盖的部分截掉
+            const int right=x+w;
+
+            for(size_t i=index+1;i<skyline.size();)
+            {
+                Segment &seg=skyline[i];
+
+                if(seg.x>=right)break;
+
+                const int cut=right-seg.x;
+
+                if(seg.width<=cut)
+                {
+                    skyline.erase(skyline.begin()+i);
+                    continue;
+                }
+
+                seg.x+=cut;
+                seg.width-=cut;
+                break;
+            }
+
+            //合并高度相同的相邻段
+            for(size_t i=0;i+1<skyline.size();)
+            {
+                if(skyline[i].y==skyline[i+1].y)
+                {
+                    skyline[i].width+=skyline[i+1].width;
+                    skyline.erase(skyline.begin()+i+1);
+                }
+                else
+                    ++i;
+            }
+        }
+
+        bool SkylinePacker::Insert(const int w,const int h,int *x,int *y)
+        {
+            if(!x||!y)return(false);
+            if(w<=0||h<=0||w>width||h>height)return(false);
+
+            size_t best_index=0;
+            int best_bottom=INT32_MAX;
+            uint64 best_waste=UINT64_MAX;
+
+            for(size_t i=0;i<skyline.size();i++)
+            {
+                int top;
+                uint64 waste;
+
+                if(!Fit(i,w,h,&top,&waste))
+                    continue;
+
+                if(top+h<best_bottom
+                 ||(top+h==best_bottom&&waste<best_waste))
+                {
+                    best_index=i;
+                    best_bottom=top+h;
+                    best_waste=waste;
+                }
+            }
+
+            if(best_bottom==INT32_MAX)
+                return(false);
+
+            *x=skyline[best_index].x;
+            *y=best_bottom-h;
+
+            Place(best_index,*x,*y,w,h);
+
+            used_area+=uint64(w)*uint64(h);
+            ++rect_count;
+
+            return(true);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,153 @@
+#include<hgl/2d/BitmapAllocator.h>
+#include<stdlib.h>
+
+#ifdef _MSC_VER
+#include<malloc.h>
+#endif//_MSC_VER
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        void *AlignedAlloc(const size_t bytes,const size_t alignment)
+        {
+            if(!bytes)return(nullptr);
+
+#ifdef _MSC_VER
+            return _aligned_malloc(bytes,alignment);
+#else
+            void *ptr;
+
+            if(posix_memalign(&ptr,alignment,bytes))
+                return(nullptr);
+
+            return ptr;
+#endif//_MSC_VER
+        }
+
+        void AlignedFree(void *ptr)
+        {
+            if(!ptr)return;
+
+#ifdef _MSC_VER
+            _aligned_free(ptr);
+#else
+            free(ptr);
+#endif//_MSC_VER
+        }
+
+        namespace
+        {
+            struct DefaultBitmapAllocator:public BitmapAllocator
+            {
+                void *Alloc(const size_t bytes) override
+                {
+                    return AlignedAlloc(bytes);
+                }
+
+                void Free(void *ptr,const size_t) override
+                {
+                    AlignedFree(ptr);
+                }
+            };//struct DefaultBitmapAllocator
+        }//namespace
+
+        BitmapAllocator *GetDefaultBitmapAllocator()
+        {
+            static DefaultBitmapAllocator default_allocator;
+
+            return &default_allocator;
+        }
+
+        BitmapPool::BitmapPool(const size_t max_bytes)
+        {
+            max_cache_bytes=max_bytes;
+            cache_bytes=0;
+            hit_count=0;
+            miss_count=0;
+        }
+
+        BitmapPool::~BitmapPool()
+        {
+            Trim();
+        }
+
+        void *BitmapPool::Alloc(const size_t bytes)
+        {
+            if(!bytes)return(nullptr);
+
+            {
+                std::lock_guard<std::mutex> lg(lock);
+
+                auto it=free_blocks.find(bytes);
+
+                if(it!=free_blocks.end()&&!it->second.empty())
+                {
+                    void *ptr=it->second.back();
+
+                    it->second.pop_back();
+                    cache_bytes-=bytes;
+                    ++hit_count;
+
+                    return ptr;
+                }
+
+                ++miss_count;
+            }
+
+            return AlignedAlloc(bytes);
+        }
+
+        void BitmapPool::Free(void *ptr,const size_t bytes)
+        {
+            if(!ptr)return;
+
+            {
+                std::lock_guard<std::mutex> lg(lock);
+
+                if(cache_bytes+bytes<=max_cache_bytes)
+                {
+                    free_blocks[bytes].push_back(ptr);
+                    cache_bytes+=bytes;
+                    return;
+                }
+            }
+
+            AlignedFree(ptr);
+        }
+
+        void BitmapPool::Trim()
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            for(auto &fb:free_blocks)
+                for(void *ptr:fb.second)
+                    AlignedFree(ptr);
+
+            free_blocks.clear();
+            cache_bytes=0;
+        }
+
+        void BitmapPool::SetMaxCacheBytes(const size_t max_bytes)
+        {
+            std::lock_guard<std::mutex> lg(lock);
+
+            max_cache_bytes=max_bytes;
+
+            //超出部分从大块开始释放
+            auto it=free_blocks.end();
+
+            while(cache_bytes>max_cache_bytes&&it!=free_blocks.begin())
+            {
+                --it;
+
+                while(cache_bytes>max_cache_bytes&&!it->second.empty())
+                {
+                    AlignedFree(it->second.back());
+                    it->second.pop_back();
+                    cache_bytes-=it->first;
+                }
+            }
+        }
+    }//namespace bitmap
+}//namespace hgl
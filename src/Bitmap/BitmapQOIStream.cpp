@@ -0,0 +1,453 @@
+#include<hgl/2d/BitmapLoad.h>
+#include<hgl/2d/BitmapSave.h>
+#include<hgl/2d/QOI.h>
+#include<hgl/io/InputStream.h>
+#include<hgl/io/OutputStream.h>
+#include<string.h>
+#include<vector>
+
+/**
+ * QOI格式读写
+ *
+ * 为了与TGA载入的位图通用，内存中的象素与TGA一样按B,G,R(,A)顺序存放，读写时与QOI的R,G,B,A顺序相互转换。
+ */
+namespace hgl
+{
+    using namespace io;
+    using namespace imgfmt;
+
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint QOI_IO_BUFFER_SIZE=64*1024;
+
+            /**
+             * 带缓冲的字节读取
+             */
+            class QOIReader
+            {
+                InputStream *is;
+
+                std::vector<uint8> buffer;
+                uint pos,size;
+
+            public:
+
+                QOIReader(InputStream *s)
+                {
+                    is=s;
+                    buffer.resize(QOI_IO_BUFFER_SIZE);
+                    pos=size=0;
+                }
+
+                /**
+                 * 保证缓冲区中至少还有n个字节
+                 */
+                bool Need(const uint n)
+                {
+                    if(size-pos>=n)return(true);
+
+                    memmove(buffer.data(),buffer.data()+pos,size-pos);
+                    size-=pos;
+                    pos=0;
+
+                    while(size<n)
+                    {
+                        const int64 result=is->Read(buffer.data()+size,buffer.size()-size);
+
+                        if(result<=0)return(false);
+
+                        size+=uint(result);
+                    }
+
+                    return(true);
+                }
+
+                uint8 Get(){return buffer[pos++];}
+            };//class QOIReader
+
+            /**
+             * QOI解码器，运行长度与索引表在行之间保留
+             */
+            class QOIDecoder
+            {
+                QOIReader reader;
+
+                uint8 index[64][4];
+                uint8 px[4];                                                    ///<R,G,B,A
+                uint run;
+
+            public:
+
+                QOIDecoder(InputStream *is):reader(is)
+                {
+                    memset(index,0,sizeof(index));
+
+                    px[0]=px[1]=px[2]=0;
+                    px[3]=255;
+                    run=0;
+                }
+
+                /**
+                 * 解码count个象素
+                 * @param pixel_bytes 输出象素字节数，3为BGR，4为BGRA
+                 */
+                bool Decode(uint8 *dst,uint count,const uint pixel_bytes)
+                {
+                    while(count--)
+                    {
+                        if(run)
+                        {
+                            --run;
+                        }
+                        else
+                        {
+                            if(!reader.Need(1))return(false);
+
+                            const uint8 b1=reader.Get();
+
+                            if(b1==QOI_OP_RGB)
+                            {
+                                if(!reader.Need(3))return(false);
+
+                                px[0]=reader.Get();
+                                px[1]=reader.Get();
+                                px[2]=reader.Get();
+                            }
+                            else
+                            if(b1==QOI_OP_RGBA)
+                            {
+                                if(!reader.Need(4))return(false);
+
+                                px[0]=reader.Get();
+                                px[1]=reader.Get();
+                                px[2]=reader.Get();
+                                px[3]=reader.Get();
+                            }
+                            else
+                            switch(b1&QOI_MASK_2)
+                            {
+                                case QOI_OP_INDEX:  memcpy(px,index[b1],4);
+                                                    break;
+
+                                case QOI_OP_DIFF:   px[0]+=((b1>>4)&3)-2;
+                                                    px[1]+=((b1>>2)&3)-2;
+                                                    px[2]+=( b1    &3)-2;
+                                                    break;
+
+                                case QOI_OP_LUMA:   {
+                                                        if(!reader.Need(1))return(false);
+
+                                                        const uint8 b2=reader.Get();
+                                                        const int vg=(b1&0x3F)-32;
+
+                                                        px[0]+=vg-8+((b2>>4)&0x0F);
+                                                        px[1]+=vg;
+                                                        px[2]+=vg-8+( b2    &0x0F);
+                                                    }
+                                                    break;
+
+                                default:            run=b1&0x3F;                //QOI_OP_RUN，本象素之外还要重复的次数
+                                                    break;
+                            }
+
+                            memcpy(index[QOIColorHash(px[0],px[1],px[2],px[3])],px,4);
+                        }
+
+                        dst[0]=px[2];
+                        dst[1]=px[1];
+                        dst[2]=px[0];
+
+                        if(pixel_bytes==4)
+                            dst[3]=px[3];
+
+                        dst+=pixel_bytes;
+                    }
+
+                    return(true);
+                }
+            };//class QOIDecoder
+
+            /**
+             * QOI编码器，输出攒满缓冲区后写出
+             */
+            class QOIEncoder
+            {
+                OutputStream *os;
+
+                std::vector<uint8> buffer;
+                uint pos;
+
+                uint8 index[64][4];
+                uint8 prev[4];                                                  ///<R,G,B,A
+                uint run;
+
+            private:
+
+                bool Reserve(const uint n)
+                {
+                    if(pos+n<=buffer.size())return(true);
+
+                    return Flush();
+                }
+
+                void EmitRun()
+                {
+                    buffer[pos++]=uint8(QOI_OP_RUN|(run-1));
+                    run=0;
+                }
+
+            public:
+
+                QOIEncoder(OutputStream *s)
+                {
+                    os=s;
+                    buffer.resize(QOI_IO_BUFFER_SIZE);
+                    pos=0;
+
+                    memset(index,0,sizeof(index));
+
+                    prev[0]=prev[1]=prev[2]=0;
+                    prev[3]=255;
+                    run=0;
+                }
+
+                bool Flush()
+                {
+                    if(!pos)return(true);
+
+                    const int64 bytes=pos;
+
+                    pos=0;
+                    return(os->Write(buffer.data(),bytes)==bytes);
+                }
+
+                bool Write(const void *data,const uint size)
+                {
+                    if(!Reserve(size))return(false);
+
+                    memcpy(buffer.data()+pos,data,size);
+                    pos+=size;
+                    return(true);
+                }
+
+                /**
+                 * 编码count个象素
+                 * @param pixel_bytes 输入象素字节数，3为BGR，4为BGRA
+                 */
+                bool Encode(const uint8 *src,uint count,const uint pixel_bytes)
+                {
+                    uint8 px[4];
+
+                    px[3]=255;
+
+                    while(count--)
+                    {
+                        //每个象素最多输出1字节的运行长度加5字节的数据
+                        if(!Reserve(6))return(false);
+
+                        px[0]=src[2];
+                        px[1]=src[1];
+                        px[2]=src[0];
+
+                        if(pixel_bytes==4)
+                            px[3]=src[3];
+
+                        src+=pixel_bytes;
+
+                        if(memcmp(px,prev,4)==0)
+                        {
+                            if(++run==QOI_MAX_RUN)
+                                EmitRun();
+
+                            continue;
+                        }
+
+                        if(run)
+                            EmitRun();
+
+                        const uint hash=QOIColorHash(px[0],px[1],px[2],px[3]);
+
+                        if(memcmp(index[hash],px,4)==0)
+                        {
+                            buffer[pos++]=uint8(QOI_OP_INDEX|hash);
+                        }
+                        else
+                        {
+                            memcpy(index[hash],px,4);
+
+                            if(px[3]==prev[3])
+                            {
+                                const int8 vr=int8(px[0]-prev[0]);
+                                const int8 vg=int8(px[1]-prev[1]);
+                                const int8 vb=int8(px[2]-prev[2]);
+
+                                const int8 vg_r=int8(vr-vg);
+                                const int8 vg_b=int8(vb-vg);
+
+                                if(vr>-3&&vr<2
+                                 &&vg>-3&&vg<2
+                                 &&vb>-3&&vb<2)
+                                {
+                                    buffer[pos++]=uint8(QOI_OP_DIFF|((vr+2)<<4)|((vg+2)<<2)|(vb+2));
+                                }
+                                else
+                                if(vg_r>-9&&vg_r<8
+                                 &&vg  >-33&&vg<32
+                                 &&vg_b>-9&&vg_b<8)
+                                {
+                                    buffer[pos++]=uint8(QOI_OP_LUMA|(vg+32));
+                                    buffer[pos++]=uint8(((vg_r+8)<<4)|(vg_b+8));
+                                }
+                                else
+                                {
+                                    buffer[pos++]=QOI_OP_RGB;
+                                    buffer[pos++]=px[0];
+                                    buffer[pos++]=px[1];
+                                    buffer[pos++]=px[2];
+                                }
+                            }
+                            else
+                            {
+                                buffer[pos++]=QOI_OP_RGBA;
+                                buffer[pos++]=px[0];
+                                buffer[pos++]=px[1];
+                                buffer[pos++]=px[2];
+                                buffer[pos++]=px[3];
+                            }
+                        }
+
+                        memcpy(prev,px,4);
+                    }
+
+                    return(true);
+                }
+
+                /**
+                 * 输出剩余的运行长度与结束标记
+                 */
+                bool Finish()
+                {
+                    constexpr uint8 end_marker[QOI_END_MARKER_SIZE]={0,0,0,0,0,0,0,1};
+
+                    if(!Reserve(1))return(false);
+
+                    if(run)
+                        EmitRun();
+
+                    if(!Write(end_marker,QOI_END_MARKER_SIZE))
+                        return(false);
+
+                    return Flush();
+                }
+            };//class QOIEncoder
+        }//namespace
+
+        bool LoadBitmapFromQOIStream(io::InputStream *is,BitmapLoader *bl)
+        {
+            if(!is||!bl)return(false);
+
+            uint8 header_data[QOI_HEADER_SIZE];
+            QOIHeader header;
+
+            if(is->Read(header_data,QOI_HEADER_SIZE)!=QOI_HEADER_SIZE)
+                return(false);
+
+            if(!ParseQOIHeader(&header,header_data,QOI_HEADER_SIZE))
+                return(false);
+
+            if(bl->OnChannelBits()!=8)
+                return(false);
+
+            const uint pixel_bytes=bl->OnChannels();
+
+            if(pixel_bytes!=3&&pixel_bytes!=4)
+                return(false);
+
+            const uint width=header.width;
+            const uint height=header.height;
+
+            if(!bl->OnRecvBitmap(width,height))
+            {
+                bl->OnLoadFailed();
+                return(false);
+            }
+
+            std::vector<uint8> row_buffer;
+            QOIDecoder decoder(is);
+
+            for(uint y=0;y<height;y++)
+            {
+                uint8 *row=(uint8 *)bl->OnRowBuffer(y);
+
+                if(!row)
+                {
+                    row_buffer.resize(width*pixel_bytes);
+                    row=row_buffer.data();
+                }
+
+                if(!decoder.Decode(row,width,pixel_bytes)
+                 ||!bl->OnRecvRow(y,row))
+                {
+                    bl->OnLoadFailed();
+                    return(false);
+                }
+            }
+
+            return(true);
+        }
+
+        bool SaveBitmapToQOI(io::OutputStream *os,const void *data,uint width,uint height,uint channels,uint line_bytes,bool linear,bool bottom_up)
+        {
+            if(!os||!data||!width||!height)
+                return(false);
+
+            if(channels!=3&&channels!=4)
+                return(false);
+
+            if(uint64(width)*height>QOI_MAX_PIXELS)
+                return(false);
+
+            const uint row_bytes=width*channels;
+
+            if(line_bytes<row_bytes)
+                line_bytes=row_bytes;
+
+            QOIHeader header;
+            uint8 header_data[QOI_HEADER_SIZE];
+
+            header.width=width;
+            header.height=height;
+            header.channels=uint8(channels);
+            header.colorspace=linear?QOI_LINEAR:QOI_SRGB;
+
+            WriteQOIHeader(header_data,header);
+
+            QOIEncoder encoder(os);
+
+            if(!encoder.Write(header_data,QOI_HEADER_SIZE))
+                return(false);
+
+            const uint8 *p=(const uint8 *)data;
+            ptrdiff_t step=line_bytes;
+
+            if(bottom_up)
+            {
+                p+=size_t(line_bytes)*(height-1);
+                step=-step;
+            }
+
+            //运行长度可以跨行，所以各行连续编码
+            for(uint y=0;y<height;y++)
+            {
+                if(!encoder.Encode(p,width,channels))
+                    return(false);
+
+                p+=step;
+            }
+
+            return encoder.Finish();
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,54 @@
+#include<hgl/2d/MappedBitmap.h>
+#include<hgl/2d/TGA.h>
+
+namespace hgl
+{
+    using namespace imgfmt;
+
+    namespace bitmap
+    {
+        const void *GetTGAPixelData(const void *tga_data,const int64 tga_size,const uint pixel_bits,uint &width,uint &height,bool *bottom_up)
+        {
+            if(!tga_data||tga_size<(int64)TGAHeaderSize)
+                return(nullptr);
+
+            const TGAHeader *tga_header=(const TGAHeader *)tga_data;
+
+            if(tga_header->image_type!=TGA_IMAGE_TYPE_TRUE_COLOR
+             &&tga_header->image_type!=TGA_IMAGE_TYPE_GRAYSCALE)
+                return(nullptr);
+
+            if(tga_header->bit!=pixel_bits)
+                return(nullptr);
+
+            if(!tga_header->width||!tga_header->height)
+                return(nullptr);
+
+            TGAImageDesc tga_desc;
+
+            tga_desc.image_desc=tga_header->image_desc;
+
+            const bool lower_left=(tga_desc.direction==TGA_DIRECTION_LOWER_LEFT);
+
+            if(lower_left&&!bottom_up)                                          //调用者不处理从下往上存放的数据
+                return(nullptr);
+
+            const int64 offset=TGAHeaderSize
+                              +tga_header->id
+                              +GetTGAColorMapBytes(tga_header);
+
+            const int64 total_bytes=(int64(tga_header->width)*tga_header->height*tga_header->bit)>>3;
+
+            if(offset+total_bytes>tga_size)
+                return(nullptr);
+
+            width=tga_header->width;
+            height=tga_header->height;
+
+            if(bottom_up)
+                *bottom_up=lower_left;
+
+            return ((const uint8 *)tga_data)+offset;
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,212 @@
+#include<hgl/2d/BitmapSave.h>
+#include<hgl/2d/TaskPool.h>
+#include<hgl/2d/TGA.h>
+#include<hgl/2d/Instrument.h>
+#include<hgl/io/OutputStream.h>
+#include<algorithm>
+#include<string.h>
+#include<vector>
+
+namespace hgl
+{
+    using namespace io;
+    using namespace imgfmt;
+
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint TGA_SAVE_MIN_BAND_ROWS   =16;                        ///<自动分带时每带最少行数
+            constexpr uint TGA_SAVE_BANDS_PER_THREAD=4;                         ///<自动分带时每个线程平均分到的行带数
+
+            /**
+             * 合并写入缓冲区<br>
+             * 小块数据攒满后一次写出，不小于缓冲区的数据直接写出，减少对流的调用次数。
+             */
+            class WriteBuffer
+            {
+                OutputStream *os;
+
+                uint8 *buffer;
+                uint size;
+                uint pos;
+
+            public:
+
+                WriteBuffer(OutputStream *s,const uint buffer_bytes)
+                {
+                    os=s;
+                    pos=0;
+
+                    buffer=buffer_bytes?(uint8 *)AlignedAlloc(buffer_bytes):nullptr;
+                    size=buffer?buffer_bytes:0;
+                }
+
+                ~WriteBuffer()
+                {
+                    if(buffer)
+                        AlignedFree(buffer);
+                }
+
+                bool Flush()
+                {
+                    if(!pos)return(true);
+
+                    const int64 bytes=pos;
+
+                    pos=0;
+                    return(os->Write(buffer,bytes)==bytes);
+                }
+
+                bool Write(const void *data,const size_t bytes)
+                {
+                    if(bytes>=size)
+                    {
+                        if(!Flush())
+                            return(false);
+
+                        return(os->Write(data,int64(bytes))==int64(bytes));
+                    }
+
+                    if(pos+bytes>size&&!Flush())
+                        return(false);
+
+                    memcpy(buffer+pos,data,bytes);
+                    pos+=uint(bytes);
+                    return(true);
+                }
+            };//class WriteBuffer
+
+            /**
+             * 一个行带的RLE压缩结果
+             */
+            struct TGABand
+            {
+                std::vector<uint8> data;
+                size_t size=0;
+            };
+
+            void EncodeTGABand(TGABand &band,const uint8 *src,const uint rows,const uint width,const uint pixel_bytes,const uint line_bytes)
+            {
+                band.data.resize(size_t(GetTGARLEMaxBytes(width,pixel_bytes))*rows);
+
+                uint8 *out=band.data.data();
+
+                for(uint y=0;y<rows;y++)
+                {
+                    out+=EncodeTGARLE(out,src,width,pixel_bytes);
+                    src+=line_bytes;
+                }
+
+                band.size=out-band.data.data();
+            }
+        }//namespace
+
+        bool SaveBitmapToTGA(io::OutputStream *os,const void *data,uint width,uint height,uint channels,uint single_channel_bits,uint line_bytes,const TGASaveOption &option)
+        {
+            CM2D_INSTRUMENT_SCOPE(TGASave);
+
+            if(!os||!data||width<=0||height<=0||channels<=0||single_channel_bits<=0)
+                return(false);
+
+            TGAHeader tga_header;
+
+            const uint pixel_bytes=(channels*single_channel_bits)>>3;
+            const uint row_bytes=width*pixel_bytes;
+
+            if(line_bytes<row_bytes)
+                line_bytes=row_bytes;
+
+            bool rle=option.rle;
+
+            if(rle&&(pixel_bytes<1||pixel_bytes>4))
+                rle=false;
+
+            if(!FillTGAHeader(&tga_header,width,height,channels,single_channel_bits,rle,option.bottom_up))
+                return(false);
+
+            CM2D_INSTRUMENT_PIXELS(uint64(width)*height);
+            CM2D_INSTRUMENT_BYTES(uint64(row_bytes)*height);
+
+            WriteBuffer wb(os,option.write_buffer_bytes);
+
+            if(!wb.Write(&tga_header,TGAHeaderSize))
+                return(false);
+
+            const uint8 *p=(const uint8 *)data;
+
+            if(!rle)
+            {
+                if(line_bytes==row_bytes)
+                {
+                    if(!wb.Write(p,size_t(row_bytes)*height))
+                        return(false);
+                }
+                else
+                {
+                    //行尾有填充时逐行合并写入
+                    for(uint y=0;y<height;y++)
+                    {
+                        if(!wb.Write(p,row_bytes))
+                            return(false);
+
+                        p+=line_bytes;
+                    }
+                }
+
+                return wb.Flush();
+            }
+
+            //TGA的RLE数据包不跨行，所以各行带可以独立压缩，按顺序拼接即为完整数据
+            TaskPool *pool=option.task_pool;
+
+            const uint thread_count=pool?pool->GetThreadCount():1;
+
+            uint band_rows=option.band_rows;
+
+            if(!band_rows)
+            {
+                const uint band_target=thread_count*TGA_SAVE_BANDS_PER_THREAD;
+
+                band_rows=(height+band_target-1)/band_target;
+
+                if(band_rows<TGA_SAVE_MIN_BAND_ROWS)
+                    band_rows=TGA_SAVE_MIN_BAND_ROWS;
+            }
+
+            if(band_rows>height)
+                band_rows=height;
+
+            const uint band_count=(height+band_rows-1)/band_rows;
+
+            //每批并行压缩的行带数，压缩完一批后按顺序写出，限制占用的内存
+            const uint batch=(pool&&band_count>1)?std::min(band_count,thread_count*2):1;
+
+            std::vector<TGABand> bands(batch);
+
+            const auto encode=[&](const uint first,const uint index)
+            {
+                const uint y=(first+index)*band_rows;
+                const uint rows=std::min(band_rows,height-y);
+
+                EncodeTGABand(bands[index],p+size_t(line_bytes)*y,rows,width,pixel_bytes,line_bytes);
+            };
+
+            for(uint first=0;first<band_count;first+=batch)
+            {
+                const uint count=std::min(batch,band_count-first);
+
+                if(count>1)
+                    pool->Run(count,[&](uint index){encode(first,index);});
+                else
+                    encode(first,0);
+
+                for(uint i=0;i<count;i++)
+                    if(!wb.Write(bands[i].data.data(),bands[i].size))
+                        return(false);
+            }
+
+            return wb.Flush();
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -1,7 +1,9 @@
 #include<hgl/2d/BitmapLoad.h>
 #include<hgl/2d/TGA.h>
+#include<hgl/2d/Instrument.h>
 #include<hgl/io/InputStream.h>
-#include<hgl/io/OutputStream.h>
+#include<string.h>
+#include<vector>
 
 namespace hgl
 {
@@ -10,8 +12,192 @@ namespace hgl
 
     namespace bitmap
     {
+        namespace
+        {
+            constexpr uint TGA_READ_BUFFER_SIZE=64*1024;
+
+            /**
+             * RLE数据解码器<br>
+             * 数据包可以跨行，所以未用完的包在行之间保留。
+             */
+            class TGARLEDecoder
+            {
+                InputStream *is;
+
+                std::vector<uint8> buffer;
+                uint buf_pos,buf_size;
+
+                uint pixel_bytes;
+
+                uint packet_left;                                               ///<当前数据包剩余象素数
+                bool packet_repeat;                                             ///<当前数据包是否为重复包
+                uint8 repeat_pixel[4];
+
+            private:
+
+                bool Fill()
+                {
+                    if(buf_pos<buf_size)return(true);
+
+                    const int64 size=is->Read(buffer.data(),buffer.size());
+
+                    if(size<=0)return(false);
+
+                    buf_pos=0;
+                    buf_size=uint(size);
+                    return(true);
+                }
+
+                bool ReadBytes(uint8 *dst,uint size)
+                {
+                    while(size)
+                    {
+                        if(!Fill())return(false);
+
+                        uint n=buf_size-buf_pos;
+
+                        if(n>size)n=size;
+
+                        memcpy(dst,buffer.data()+buf_pos,n);
+                        buf_pos+=n;
+                        dst+=n;
+                        size-=n;
+                    }
+
+                    return(true);
+                }
+
+            public:
+
+                TGARLEDecoder(InputStream *s,const uint pb)
+                {
+                    is=s;
+                    buffer.resize(TGA_READ_BUFFER_SIZE);
+                    buf_pos=buf_size=0;
+                    pixel_bytes=pb;
+                    packet_left=0;
+                    packet_repeat=false;
+                }
+
+                bool Decode(uint8 *dst,uint count)
+                {
+                    while(count)
+                    {
+                        if(!packet_left)
+                        {
+                            uint8 packet_head;
+
+                            if(!ReadBytes(&packet_head,1))return(false);
+
+                            packet_left=(packet_head&0x7F)+1;
+                            packet_repeat=(packet_head&0x80);
+
+                            if(packet_repeat&&!ReadBytes(repeat_pixel,pixel_bytes))
+                                return(false);
+                        }
+
+                        const uint n=(packet_left<count?packet_left:count);
+
+                        if(packet_repeat)
+                            FillTGAPixels(dst,repeat_pixel,pixel_bytes,n);
+                        else
+                        if(!ReadBytes(dst,n*pixel_bytes))
+                            return(false);
+
+                        dst+=n*pixel_bytes;
+                        count-=n;
+                        packet_left-=n;
+                    }
+
+                    return(true);
+                }
+            };//class TGARLEDecoder
+
+            /**
+             * 将调色板转换为目标象素格式(保持TGA的BGR/BGRA字节顺序)
+             * @param palette 输出，每项pixel_bytes字节
+             * @param src 调色板原始数据
+             * @param count 调色板项数
+             * @param entry_bits 调色板每项位数(15/16/24/32)
+             * @param pixel_bytes 目标每象素字节数(3/4)
+             * @param alpha_bits 文件头描述的alpha位数，为0时16位调色板项的最高位不作为alpha
+             */
+            bool ConvertPalette(std::vector<uint8> &palette,const uint8 *src,const uint count,const uint entry_bits,const uint pixel_bytes,const uint alpha_bits)
+            {
+                if(pixel_bytes!=3&&pixel_bytes!=4)return(false);
+
+                palette.resize(count*pixel_bytes);
+
+                uint8 *p=palette.data();
+
+                for(uint i=0;i<count;i++,p+=pixel_bytes)
+                {
+                    uint8 b,g,r,a=255;
+
+                    if(entry_bits==15||entry_bits==16)
+                    {
+                        const uint16 c=src[0]|(src[1]<<8);
+
+                        b=uint8(( c     &0x1F)*255/31);
+                        g=uint8(((c>>5) &0x1F)*255/31);
+                        r=uint8(((c>>10)&0x1F)*255/31);
+
+                        if(entry_bits==16&&alpha_bits&&!(c&0x8000))
+                            a=0;
+
+                        src+=2;
+                    }
+                    else
+                    if(entry_bits==24||entry_bits==32)
+                    {
+                        b=src[0];
+                        g=src[1];
+                        r=src[2];
+
+                        if(entry_bits==32)
+                            a=src[3];
+
+                        src+=entry_bits>>3;
+                    }
+                    else
+                        return(false);
+
+                    p[0]=b;
+                    p[1]=g;
+                    p[2]=r;
+
+                    if(pixel_bytes==4)
+                        p[3]=a;
+                }
+
+                return(true);
+            }
+
+            /**
+             * 将一行调色板索引展开为象素
+             */
+            void ExpandIndexRow(uint8 *dst,const uint8 *index,const uint width,const uint index_bytes,const uint first,const std::vector<uint8> &palette,const uint pixel_bytes)
+            {
+                const uint count=uint(palette.size()/pixel_bytes);
+
+                for(uint x=0;x<width;x++,dst+=pixel_bytes)
+                {
+                    uint i=(index_bytes==1)?index[x]:(index[x*2]|(index[x*2+1]<<8));
+
+                    i-=first;
+
+                    if(i<count)
+                        memcpy(dst,palette.data()+i*pixel_bytes,pixel_bytes);
+                    else
+                        memset(dst,0,pixel_bytes);
+                }
+            }
+        }//namespace
+
         bool LoadBitmapFromTGAStream(io::InputStream *is,BitmapLoader *bl)
         {
+            CM2D_INSTRUMENT_SCOPE(TGALoad);
+
             if(!is||!bl)return(false);
 
             TGAHeader tga_header;
@@ -20,51 +206,156 @@ namespace hgl
             if(is->Read(&tga_header,TGAHeaderSize)!=TGAHeaderSize)
                 return(false);
 
-            if(tga_header.image_type!=TGA_IMAGE_TYPE_TRUE_COLOR)
+            const uint image_type=tga_header.image_type;
+            const bool rle=(image_type&TGA_IMAGE_TYPE_RLE_FLAG);
+            const uint base_type=image_type&~TGA_IMAGE_TYPE_RLE_FLAG;
+
+            if(image_type>TGA_IMAGE_TYPE_RLE_GRAYSCALE)
+                return(false);
+
+            if(base_type!=TGA_IMAGE_TYPE_COLOR_MAP
+             &&base_type!=TGA_IMAGE_TYPE_TRUE_COLOR
+             &&base_type!=TGA_IMAGE_TYPE_GRAYSCALE)
                 return(false);
 
-            if(tga_header.bit!=bl->OnPixelBits())
+            if(!tga_header.width||!tga_header.height)
+                return(false);
+
+            const uint pixel_bits=bl->OnPixelBits();
+            const bool color_map=(base_type==TGA_IMAGE_TYPE_COLOR_MAP);
+
+            if(color_map)
+            {
+                if(!tga_header.color_map_type)return(false);
+                if(tga_header.bit!=8&&tga_header.bit!=16)return(false);
+            }
+            else
+            if(tga_header.bit!=pixel_bits)
+                return(false);
+
+            if(tga_header.id&&is->Skip(tga_header.id)!=tga_header.id)
                 return(false);
 
             tga_desc.image_desc=tga_header.image_desc;
 
-            void *bmp=bl->OnRecvBitmap(tga_header.width,tga_header.height);
+            //读入调色板，不使用调色板时跳过
+            std::vector<uint8> palette;
+
+            if(tga_header.color_map_type)
+            {
+                const uint palette_bytes=GetTGAColorMapBytes(&tga_header);
+
+                if(color_map)
+                {
+                    std::vector<uint8> src(palette_bytes);
+
+                    if(is->Read(src.data(),palette_bytes)!=palette_bytes)
+                        return(false);
 
-            const uint total_bytes=(tga_header.width*tga_header.height*tga_header.bit)>>3;
+                    if(!ConvertPalette(palette,src.data(),tga_header.color_map_length,tga_header.color_map_size,pixel_bits>>3,tga_desc.alpha_depth))
+                        return(false);
+                }
+                else
+                if(palette_bytes&&is->Skip(palette_bytes)!=palette_bytes)
+                    return(false);
+            }
 
-            if(is->Read(bmp,total_bytes)!=total_bytes)
+            const uint width=tga_header.width;
+            const uint height=tga_header.height;
+            const bool bottom_up=(tga_desc.direction==TGA_DIRECTION_LOWER_LEFT);
+
+            bl->OnRowOrder(bottom_up);
+
+            if(!bl->OnRecvBitmap(width,height))
             {
                 bl->OnLoadFailed();
                 return(false);
             }
 
-            if(tga_desc.direction==TGA_DIRECTION_LOWER_LEFT)
-               bl->OnFlip();
+            const uint file_pixel_bytes=tga_header.bit>>3;
+            const uint file_row_bytes=width*file_pixel_bytes;
+            const uint row_bytes=(width*pixel_bits)>>3;
 
-            return(true);
-        }
-    
-        /**
-        * 以TGA格式保存Bitmap数据到流
-        */
-        bool SaveBitmapToTGA(io::OutputStream *os,void *data,uint width,uint height,uint channels,uint single_channel_bits)
-        {
-            if(!os||!data||width<=0||height<=0||channels<=0||single_channel_bits<=0)
-                return(false);
+            CM2D_INSTRUMENT_PIXELS(uint64(width)*height);
+            CM2D_INSTRUMENT_BYTES(uint64(row_bytes)*height);
 
-            TGAHeader tga_header;
+            //未压缩且目标各行按文件中的行序连续存放时，一次读入全部数据
+            if(!rle&&!color_map)
+            {
+                const uint first_y=bottom_up?height-1:0;
+                const uint last_y =bottom_up?0:height-1;
 
-            const uint total_bytes=(width*height*channels*single_channel_bits)>>3;
+                uint8 *first=(uint8 *)bl->OnRowBuffer(first_y);
 
-            FillTGAHeader(&tga_header,width,height,channels,single_channel_bits);
+                if(first&&(height==1||(uint8 *)bl->OnRowBuffer(last_y)==first+size_t(row_bytes)*(height-1)))
+                {
+                    const int64 total_bytes=int64(row_bytes)*height;
 
-            if(os->Write(&tga_header,TGAHeaderSize)!=TGAHeaderSize)
-                return(false);
+                    if(is->Read(first,total_bytes)!=total_bytes)
+                    {
+                        bl->OnLoadFailed();
+                        return(false);
+                    }
 
-            if(os->Write(data,total_bytes)!=total_bytes)
-                return(false);
+                    for(uint i=0;i<height;i++)
+                        if(!bl->OnRecvRow(bottom_up?height-1-i:i,first+size_t(row_bytes)*i))
+                        {
+                            bl->OnLoadFailed();
+                            return(false);
+                        }
+
+                    return(true);
+                }
+            }
+
+            //逐行解码到最终位置
+            std::vector<uint8> row_buffer;
+            std::vector<uint8> index_row;
+
+            TGARLEDecoder *decoder=rle?new TGARLEDecoder(is,file_pixel_bytes):nullptr;
+
+            if(color_map)
+                index_row.resize(file_row_bytes);
+
+            bool result=true;
+
+            for(uint i=0;i<height;i++)
+            {
+                const uint y=bottom_up?height-1-i:i;
+
+                uint8 *row=(uint8 *)bl->OnRowBuffer(y);
+
+                if(!row)
+                {
+                    row_buffer.resize(row_bytes);
+                    row=row_buffer.data();
+                }
+
+                uint8 *file_row=color_map?index_row.data():row;
+
+                if(decoder)
+                    result=decoder->Decode(file_row,width);
+                else
+                    result=(is->Read(file_row,file_row_bytes)==file_row_bytes);
+
+                if(!result)break;
+
+                if(color_map)
+                    ExpandIndexRow(row,file_row,width,file_pixel_bytes,tga_header.color_map_first,palette,pixel_bits>>3);
+
+                if(!bl->OnRecvRow(y,row))
+                {
+                    result=false;
+                    break;
+                }
+            }
+
+            delete decoder;
+
+            if(!result)
+                bl->OnLoadFailed();
 
-            return(true);
+            return(result);
         }
     }//namespace bitmap
 }//namespace hgl
@@ -0,0 +1,121 @@
+#include<hgl/2d/FileMapping.h>
+
+#ifdef _WIN32
+#include<windows.h>
+#else
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif//_WIN32
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        FileMapping::FileMapping()
+        {
+            data=nullptr;
+            size=0;
+
+#ifdef _WIN32
+            file_handle=INVALID_HANDLE_VALUE;
+            map_handle=nullptr;
+#endif//_WIN32
+        }
+
+#ifdef _WIN32
+        bool FileMapping::Open(const OSString &filename)
+        {
+            Close();
+
+            file_handle=CreateFileW(filename.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+
+            if(file_handle==INVALID_HANDLE_VALUE)
+                return(false);
+
+            LARGE_INTEGER file_size;
+
+            if(!GetFileSizeEx(file_handle,&file_size)||file_size.QuadPart<=0)
+            {
+                Close();
+                return(false);
+            }
+
+            map_handle=CreateFileMappingW(file_handle,nullptr,PAGE_READONLY,0,0,nullptr);
+
+            if(!map_handle)
+            {
+                Close();
+                return(false);
+            }
+
+            data=MapViewOfFile(map_handle,FILE_MAP_READ,0,0,0);
+
+            if(!data)
+            {
+                Close();
+                return(false);
+            }
+
+            size=file_size.QuadPart;
+            return(true);
+        }
+
+        void FileMapping::Close()
+        {
+            if(data)
+                UnmapViewOfFile(data);
+
+            if(map_handle)
+                CloseHandle(map_handle);
+
+            if(file_handle!=INVALID_HANDLE_VALUE)
+                CloseHandle(file_handle);
+
+            data=nullptr;
+            size=0;
+            map_handle=nullptr;
+            file_handle=INVALID_HANDLE_VALUE;
+        }
+#else
+        bool FileMapping::Open(const OSString &filename)
+        {
+            Close();
+
+            const int fd=open(filename.c_str(),O_RDONLY);
+
+            if(fd==-1)
+                return(false);
+
+            struct stat st;
+
+            if(fstat(fd,&st)||st.st_size<=0)
+            {
+                close(fd);
+                return(false);
+            }
+
+            void *ptr=mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+
+            close(fd);                  //映射建立后即可关闭文件
+
+            if(ptr==MAP_FAILED)
+                return(false);
+
+            data=ptr;
+            size=st.st_size;
+            return(true);
+        }
+
+        void FileMapping::Close()
+        {
+            if(data)
+                munmap((void *)data,size);
+
+            data=nullptr;
+            size=0;
+        }
+#endif//_WIN32
+    }//namespace bitmap
+}//namespace hgl
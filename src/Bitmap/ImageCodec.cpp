@@ -0,0 +1,356 @@
+#include<hgl/2d/ImageCodec.h>
+#include<hgl/2d/TGA.h>
+#include<hgl/2d/QOI.h>
+#include<hgl/io/InputStream.h>
+#include<mutex>
+#include<vector>
+#include<ctype.h>
+#include<string.h>
+
+namespace hgl
+{
+    using namespace io;
+    using namespace imgfmt;
+
+    namespace bitmap
+    {
+        namespace
+        {
+            class TGACodec:public ImageCodec
+            {
+            public:
+
+                const char *GetName()const override{return "TGA";}
+                const char *GetExtName()const override{return "tga";}
+                const uint GetHeaderBytes()const override{return TGAHeaderSize;}
+
+                bool CheckHeader(const uint8 *header,const uint size)const override
+                {
+                    if(size<TGAHeaderSize)return(false);
+
+                    TGAHeader tga_header;
+
+                    memcpy(&tga_header,header,TGAHeaderSize);
+
+                    return CheckTGAHeader(&tga_header);
+                }
+
+                bool Probe(const uint8 *header,const uint size,ImageInfo *info)const override
+                {
+                    if(!CheckHeader(header,size))return(false);
+
+                    TGAHeader tga_header;
+                    TGAImageDesc tga_desc;
+
+                    memcpy(&tga_header,header,TGAHeaderSize);
+
+                    tga_desc.image_desc=tga_header.image_desc;
+
+                    const uint base_type=tga_header.image_type&~TGA_IMAGE_TYPE_RLE_FLAG;
+
+                    const bool color_map=(base_type==TGA_IMAGE_TYPE_COLOR_MAP);
+
+                    info->width         =tga_header.width;
+                    info->height        =tga_header.height;
+                    info->file_pixel_bits=tga_header.bit;
+                    info->bottom_up     =(tga_desc.direction==TGA_DIRECTION_LOWER_LEFT);
+                    info->compressed    =(tga_header.image_type&TGA_IMAGE_TYPE_RLE_FLAG);
+                    info->color_map     =color_map;
+
+                    if(color_map)
+                    {
+                        //调色板图片展开为BGR或BGRA，调色板项有Alpha时为4通道
+                        info->channels=(tga_header.color_map_size==16||tga_header.color_map_size==32)?4:3;
+                        info->channel_bits=8;
+                    }
+                    else
+                    if(base_type==TGA_IMAGE_TYPE_TRUE_COLOR&&tga_header.bit<24)
+                    {
+                        //A1R5G5B5按原样载入，视为一个16位通道
+                        info->channels=1;
+                        info->channel_bits=16;
+                    }
+                    else
+                    {
+                        info->channels=tga_header.bit/8;
+                        info->channel_bits=8;
+                    }
+
+                    return(true);
+                }
+
+                bool Load(InputStream *is,BitmapLoader *bl)const override
+                {
+                    return LoadBitmapFromTGAStream(is,bl);
+                }
+
+                bool CanSave(const uint channels,const uint channel_bits)const override
+                {
+                    return (channels==1||channels==3||channels==4)&&channel_bits==8;
+                }
+
+                bool Save(OutputStream *os,const void *data,uint width,uint height,uint channels,uint channel_bits,uint line_bytes,bool bottom_up)const override
+                {
+                    TGASaveOption option;
+
+                    option.bottom_up=bottom_up;
+
+                    return SaveBitmapToTGA(os,data,width,height,channels,channel_bits,line_bytes,option);
+                }
+            };//class TGACodec
+
+            class QOICodec:public ImageCodec
+            {
+            public:
+
+                const char *GetName()const override{return "QOI";}
+                const char *GetExtName()const override{return "qoi";}
+                const uint GetHeaderBytes()const override{return QOI_HEADER_SIZE;}
+
+                bool CheckHeader(const uint8 *header,const uint size)const override
+                {
+                    QOIHeader qoi_header;
+
+                    return ParseQOIHeader(&qoi_header,header,size);
+                }
+
+                bool Probe(const uint8 *header,const uint size,ImageInfo *info)const override
+                {
+                    QOIHeader qoi_header;
+
+                    if(!ParseQOIHeader(&qoi_header,header,size))
+                        return(false);
+
+                    info->width         =qoi_header.width;
+                    info->height        =qoi_header.height;
+                    info->channels      =qoi_header.channels;
+                    info->channel_bits  =8;
+                    info->file_pixel_bits=qoi_header.channels*8;
+                    info->bottom_up     =false;
+                    info->compressed    =true;
+                    info->color_map     =false;
+
+                    return(true);
+                }
+
+                bool Load(InputStream *is,BitmapLoader *bl)const override
+                {
+                    return LoadBitmapFromQOIStream(is,bl);
+                }
+
+                bool CanSave(const uint channels,const uint channel_bits)const override
+                {
+                    return (channels==3||channels==4)&&channel_bits==8;
+                }
+
+                bool Save(OutputStream *os,const void *data,uint width,uint height,uint channels,uint channel_bits,uint line_bytes,bool bottom_up)const override
+                {
+                    if(channel_bits!=8)return(false);
+
+                    return SaveBitmapToQOI(os,data,width,height,channels,line_bytes,false,bottom_up);
+                }
+            };//class QOICodec
+
+            /**
+             * 编解码器列表，识别时从后往前查找
+             */
+            struct ImageCodecRegistry
+            {
+                std::mutex lock;
+                std::vector<const ImageCodec *> codec_list;
+
+                TGACodec tga;
+                QOICodec qoi;
+
+            public:
+
+                ImageCodecRegistry()
+                {
+                    //TGA没有文件标识，放在最前面最后识别
+                    codec_list.push_back(&tga);
+                    codec_list.push_back(&qoi);
+                }
+            };//struct ImageCodecRegistry
+
+            ImageCodecRegistry &GetRegistry()
+            {
+                static ImageCodecRegistry registry;
+
+                return registry;
+            }
+
+            bool SameName(const char *a,const char *b)
+            {
+                while(*a&&*b)
+                {
+                    if(tolower((uint8)*a)!=tolower((uint8)*b))
+                        return(false);
+
+                    ++a;
+                    ++b;
+                }
+
+                return(*a==*b);
+            }
+
+            /**
+             * 读取文件头，管道、网络等流一次可能只返回一部分，所以一直读到size字节或流结束
+             * @return 读取的字节数，一个字节也没有读到且出错时返回-1
+             */
+            int64 ReadHeader(InputStream *is,uint8 *header,const uint size)
+            {
+                int64 total=0;
+
+                while(total<size)
+                {
+                    const int64 result=is->Read(header+total,size-total);
+
+                    if(result<=0)
+                    {
+                        if(result<0&&!total)
+                            return(-1);
+
+                        break;
+                    }
+
+                    total+=result;
+                }
+
+                return total;
+            }
+
+            /**
+             * 读取流开头的数据，之后恢复读取位置
+             */
+            int64 PeekHeader(InputStream *is,uint8 *header,const uint size)
+            {
+                if(is->CanPeek())
+                    return is->Peek(header,size);
+
+                if(!is->CanSeek())
+                    return(-1);
+
+                const int64 result=ReadHeader(is,header,size);
+
+                if(result>0&&is->Seek(-result,soCurrent)<0)
+                    return(-1);
+
+                return result;
+            }
+        }//namespace
+
+        void RegisterImageCodec(const ImageCodec *codec)
+        {
+            if(!codec)return;
+
+            ImageCodecRegistry &reg=GetRegistry();
+            std::lock_guard<std::mutex> lg(reg.lock);
+
+            for(const ImageCodec *c:reg.codec_list)
+                if(c==codec)
+                    return;
+
+            reg.codec_list.push_back(codec);
+        }
+
+        const ImageCodec *GetImageCodec(const char *name)
+        {
+            if(!name||!*name)return(nullptr);
+
+            if(*name=='.')
+                ++name;
+
+            ImageCodecRegistry &reg=GetRegistry();
+            std::lock_guard<std::mutex> lg(reg.lock);
+
+            for(auto it=reg.codec_list.rbegin();it!=reg.codec_list.rend();++it)
+                if(SameName((*it)->GetName(),name)
+                 ||SameName((*it)->GetExtName(),name))
+                    return *it;
+
+            return(nullptr);
+        }
+
+        const ImageCodec *DetectImageCodec(const uint8 *header,const uint size)
+        {
+            if(!header||!size)return(nullptr);
+
+            ImageCodecRegistry &reg=GetRegistry();
+            std::lock_guard<std::mutex> lg(reg.lock);
+
+            for(auto it=reg.codec_list.rbegin();it!=reg.codec_list.rend();++it)
+                if((*it)->CheckHeader(header,size))
+                    return *it;
+
+            return(nullptr);
+        }
+
+        const ImageCodec *DetectImageCodec(io::InputStream *is)
+        {
+            if(!is)return(nullptr);
+
+            uint8 header[IMAGE_CODEC_MAX_HEADER_BYTES];
+
+            const int64 size=PeekHeader(is,header,IMAGE_CODEC_MAX_HEADER_BYTES);
+
+            if(size<=0)
+                return(nullptr);
+
+            return DetectImageCodec(header,uint(size));
+        }
+
+        bool ProbeImage(io::InputStream *is,ImageInfo *info)
+        {
+            if(!is||!info)return(false);
+
+            uint8 header[IMAGE_CODEC_MAX_HEADER_BYTES];
+
+            int64 size=PeekHeader(is,header,IMAGE_CODEC_MAX_HEADER_BYTES);
+
+            //不能恢复读取位置的流直接读取
+            if(size<0)
+                size=ReadHeader(is,header,IMAGE_CODEC_MAX_HEADER_BYTES);
+
+            if(size<=0)
+                return(false);
+
+            const ImageCodec *codec=DetectImageCodec(header,uint(size));
+
+            if(!codec)
+                return(false);
+
+            *info=ImageInfo();
+
+            if(!codec->Probe(header,uint(size),info))
+                return(false);
+
+            info->codec=codec;
+            return(true);
+        }
+
+        bool ProbeImage(const OSString &filename,ImageInfo *info)
+        {
+            if(filename.IsEmpty()||!info)
+                return(false);
+
+            io::OpenFileInputStream fis(filename);
+
+            if(!fis)
+                return(false);
+
+            return ProbeImage(&fis,info);
+        }
+
+        bool LoadBitmapFromStream(io::InputStream *is,BitmapLoader *bl)
+        {
+            if(!is||!bl)return(false);
+
+            const ImageCodec *codec=DetectImageCodec(is);
+
+            if(!codec)
+                return(false);
+
+            return codec->Load(is,bl);
+        }
+    }//namespace bitmap
+}//namespace hgl
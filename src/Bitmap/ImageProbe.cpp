@@ -0,0 +1,83 @@
+#include<hgl/2d/ImageCodec.h>
+#include<hgl/2d/TaskPool.h>
+#include<filesystem>
+#include<vector>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            namespace fs=std::filesystem;
+
+            /**
+             * 列出目录中的所有文件，出错的项目直接跳过
+             */
+            template<typename IT>
+            void ListFiles(std::vector<OSString> &file_list,const fs::path &folder)
+            {
+                std::error_code ec;
+
+                IT it(folder,fs::directory_options::skip_permission_denied,ec);
+
+                if(ec)return;
+
+                for(;it!=IT();it.increment(ec))
+                {
+                    if(ec)break;
+
+                    if(!it->is_regular_file(ec)||ec)
+                        continue;
+
+                    file_list.push_back(OSString(it->path().c_str()));
+                }
+            }
+        }//namespace
+
+        uint ProbeImageFolder(const OSString &folder,std::vector<ImageFileInfo> &result,const bool recursive,TaskPool *pool)
+        {
+            if(folder.IsEmpty())
+                return(0);
+
+            std::vector<OSString> file_list;
+
+            if(recursive)
+                ListFiles<fs::recursive_directory_iterator>(file_list,fs::path(folder.c_str()));
+            else
+                ListFiles<fs::directory_iterator>(file_list,fs::path(folder.c_str()));
+
+            const uint count=uint(file_list.size());
+
+            if(!count)
+                return(0);
+
+            std::vector<ImageInfo> info_list(count);
+            std::vector<uint8> ok_list(count,0);
+
+            //每个文件只读取文件头，耗时主要在打开文件，所以按文件并行
+            const auto probe=[&](const uint index)
+            {
+                ok_list[index]=ProbeImage(file_list[index],&info_list[index]);
+            };
+
+            if(pool&&count>1)
+                pool->Run(count,probe);
+            else
+                for(uint i=0;i<count;i++)
+                    probe(i);
+
+            uint found=0;
+
+            for(uint i=0;i<count;i++)
+            {
+                if(!ok_list[i])continue;
+
+                result.push_back({file_list[i],info_list[i]});
+                ++found;
+            }
+
+            return found;
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,208 @@
+#include<hgl/2d/Instrument.h>
+#include<atomic>
+#include<chrono>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            struct InstrumentCounter
+            {
+                std::atomic<uint64> count{0};
+                std::atomic<uint64> pixels{0};
+                std::atomic<uint64> bytes{0};
+
+                std::atomic<uint64> sampled_count{0};
+                std::atomic<uint64> sampled_ns{0};
+                std::atomic<uint64> max_ns{0};
+            };
+
+            InstrumentCounter instrument_counter[INSTRUMENT_OP_COUNT];
+
+            std::atomic<uint> sample_interval{INSTRUMENT_DEFAULT_SAMPLE_INTERVAL};
+
+            InstrumentTrace instrument_trace;
+
+            const char *instrument_op_name[INSTRUMENT_OP_COUNT]=
+            {
+                "PutPixel",
+                "HLine",
+                "VLine",
+                "Bar",
+                "Line",
+                "WireCircle",
+                "SolidCircle",
+                "Sector",
+                "SolidSector",
+                "AALine",
+                "AAPolygon",
+                "AASolidCircle",
+                "AAWireCircle",
+                "SolidPolygon",
+                "SolidTriangle",
+                "Glyph",
+                "BlendBitmap",
+                "Blit",
+                "TGALoad",
+                "TGASave",
+            };
+
+#ifdef CM2D_INSTRUMENT
+            /**
+             * 当前线程最外层操作的状态
+             */
+            struct InstrumentThreadState
+            {
+                int depth=0;
+
+                InstrumentOp op=InstrumentOp::PutPixel;
+                uint64 pixels=0;
+                uint64 bytes=0;
+
+                uint sample_tick=0;
+                bool timed=false;
+                std::chrono::steady_clock::time_point start;
+            };
+
+            thread_local InstrumentThreadState thread_state;
+#endif//CM2D_INSTRUMENT
+        }//namespace
+
+        const char *GetInstrumentOpName(const InstrumentOp op)
+        {
+            return uint(op)<INSTRUMENT_OP_COUNT?instrument_op_name[uint(op)]:"";
+        }
+
+        InstrumentStats GetInstrumentStats(const InstrumentOp op)
+        {
+            InstrumentStats stats;
+
+            if(uint(op)>=INSTRUMENT_OP_COUNT)
+                return stats;
+
+            const InstrumentCounter &c=instrument_counter[uint(op)];
+
+            stats.count         =c.count.load(std::memory_order_relaxed);
+            stats.pixels        =c.pixels.load(std::memory_order_relaxed);
+            stats.bytes         =c.bytes.load(std::memory_order_relaxed);
+            stats.sampled_count =c.sampled_count.load(std::memory_order_relaxed);
+            stats.sampled_ns    =c.sampled_ns.load(std::memory_order_relaxed);
+            stats.max_ns        =c.max_ns.load(std::memory_order_relaxed);
+
+            return stats;
+        }
+
+        void GetInstrumentStats(InstrumentStats *stats)
+        {
+            if(!stats)return;
+
+            for(uint i=0;i<INSTRUMENT_OP_COUNT;i++)
+                stats[i]=GetInstrumentStats(InstrumentOp(i));
+        }
+
+        void ResetInstrumentStats()
+        {
+            for(InstrumentCounter &c:instrument_counter)
+            {
+                c.count.store(0,std::memory_order_relaxed);
+                c.pixels.store(0,std::memory_order_relaxed);
+                c.bytes.store(0,std::memory_order_relaxed);
+                c.sampled_count.store(0,std::memory_order_relaxed);
+                c.sampled_ns.store(0,std::memory_order_relaxed);
+                c.max_ns.store(0,std::memory_order_relaxed);
+            }
+        }
+
+        void SetInstrumentSampleInterval(const uint interval)
+        {
+            sample_interval.store(interval,std::memory_order_relaxed);
+        }
+
+        void SetInstrumentTrace(const InstrumentTrace *trace)
+        {
+            instrument_trace=trace?*trace:InstrumentTrace();
+        }
+
+#ifdef CM2D_INSTRUMENT
+        InstrumentScope::InstrumentScope(const InstrumentOp op)
+        {
+            InstrumentThreadState &ts=thread_state;
+
+            outer=(ts.depth++==0);
+
+            if(!outer)return;
+
+            ts.op=op;
+            ts.pixels=0;
+            ts.bytes=0;
+
+            const uint interval=sample_interval.load(std::memory_order_relaxed);
+
+            ts.timed=false;
+
+            if(interval&&++ts.sample_tick>=interval)
+            {
+                ts.sample_tick=0;
+                ts.timed=true;
+            }
+
+            if(instrument_trace.begin)
+                instrument_trace.begin(op,instrument_trace.user_data);
+
+            if(ts.timed)
+                ts.start=std::chrono::steady_clock::now();
+        }
+
+        InstrumentScope::~InstrumentScope()
+        {
+            InstrumentThreadState &ts=thread_state;
+
+            --ts.depth;
+
+            if(!outer)return;
+
+            uint64 ns=0;
+
+            if(ts.timed)
+                ns=uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-ts.start).count());
+
+            if(instrument_trace.end)
+                instrument_trace.end(ts.op,ts.pixels,instrument_trace.user_data);
+
+            InstrumentCounter &c=instrument_counter[uint(ts.op)];
+
+            c.count.fetch_add(1,std::memory_order_relaxed);
+
+            if(ts.pixels)c.pixels.fetch_add(ts.pixels,std::memory_order_relaxed);
+            if(ts.bytes )c.bytes .fetch_add(ts.bytes ,std::memory_order_relaxed);
+
+            if(!ts.timed)return;
+
+            c.sampled_count.fetch_add(1,std::memory_order_relaxed);
+            c.sampled_ns.fetch_add(ns,std::memory_order_relaxed);
+
+            uint64 cur=c.max_ns.load(std::memory_order_relaxed);
+
+            while(ns>cur&&!c.max_ns.compare_exchange_weak(cur,ns,std::memory_order_relaxed));
+        }
+
+        void InstrumentAddPixels(const uint64 pixels)
+        {
+            InstrumentThreadState &ts=thread_state;
+
+            if(ts.depth)
+                ts.pixels+=pixels;
+        }
+
+        void InstrumentAddBytes(const uint64 bytes)
+        {
+            InstrumentThreadState &ts=thread_state;
+
+            if(ts.depth)
+                ts.bytes+=bytes;
+        }
+#endif//CM2D_INSTRUMENT
+    }//namespace bitmap
+}//namespace hgl
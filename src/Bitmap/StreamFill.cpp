@@ -0,0 +1,102 @@
+#include<hgl/2d/BitmapParallel.h>
+#include<hgl/2d/CPUFeature.h>
+#include<string.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#endif//
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint STREAM_BLOCK_BYTES=48;                               ///<1/2/3/4/6/8/12/16字节象素的公倍数，也是16的倍数
+
+            /**
+             * 普通方式填充
+             */
+            void FillBytes(uint8 *dst,const uint8 *pixel,const uint pixel_bytes,size_t count)
+            {
+                if(!count)return;
+
+                memcpy(dst,pixel,pixel_bytes);
+
+                //每次复制已填充的部分，使复制量倍增
+                size_t filled=1;
+
+                while(filled<count)
+                {
+                    const size_t n=(filled<count-filled)?filled:count-filled;
+
+                    memcpy(dst+filled*pixel_bytes,dst,n*pixel_bytes);
+                    filled+=n;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 void StreamFill_SSE2(uint8 *dst,const uint8 *pixel,const uint pixel_bytes,const size_t count)
+            {
+                size_t bytes=size_t(pixel_bytes)*count;
+
+                //对齐到16字节前的部分按普通方式写入
+                size_t head=(16-(size_t(dst)&15))&15;
+
+                if(head>bytes)head=bytes;
+
+                for(size_t i=0;i<head;i++)
+                    dst[i]=pixel[i%pixel_bytes];
+
+                const uint phase=uint(head%pixel_bytes);
+
+                dst+=head;
+                bytes-=head;
+
+                alignas(16) uint8 block[STREAM_BLOCK_BYTES];
+
+                for(uint i=0;i<STREAM_BLOCK_BYTES;i++)
+                    block[i]=pixel[(phase+i)%pixel_bytes];
+
+                const __m128i v0=_mm_load_si128((const __m128i *)block);
+                const __m128i v1=_mm_load_si128((const __m128i *)(block+16));
+                const __m128i v2=_mm_load_si128((const __m128i *)(block+32));
+
+                while(bytes>=STREAM_BLOCK_BYTES)
+                {
+                    _mm_stream_si128((__m128i *) dst    ,v0);
+                    _mm_stream_si128((__m128i *)(dst+16),v1);
+                    _mm_stream_si128((__m128i *)(dst+32),v2);
+
+                    dst+=STREAM_BLOCK_BYTES;
+                    bytes-=STREAM_BLOCK_BYTES;
+                }
+
+                _mm_sfence();
+
+                //最后不足一块的部分按普通方式写入
+                for(size_t i=0;i<bytes;i++)
+                    dst[i]=block[i];
+            }
+#endif//CM2D_SIMD_X86
+        }//namespace
+
+        void StreamFillPixels(void *dst,const void *pixel,const uint pixel_bytes,const size_t count)
+        {
+            if(!dst||!pixel||!pixel_bytes||!count)return;
+
+#if defined(CM2D_SIMD_X86)
+            if(STREAM_BLOCK_BYTES%pixel_bytes==0
+             &&size_t(pixel_bytes)*count>=STREAM_BLOCK_BYTES*2
+             &&GetCPUFeature().sse2)
+            {
+                StreamFill_SSE2((uint8 *)dst,(const uint8 *)pixel,pixel_bytes,count);
+                return;
+            }
+#endif//CM2D_SIMD_X86
+
+            //其它平台没有可移植的非临时写入指令
+            FillBytes((uint8 *)dst,(const uint8 *)pixel,pixel_bytes,count);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,137 @@
+#include<hgl/2d/BitmapView.h>
+#include<hgl/2d/CPUFeature.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * 交换两块内存的内容
+ *
+ * SIMD版本把两边的数据读入寄存器后交叉写回，不需要临时缓冲区；其余部分经由栈上的固定缓冲区分块交换。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            using SwapMemoryFunc=void(*)(uint8 *,uint8 *,size_t);
+
+            constexpr size_t SWAP_BUFFER_BYTES=256;
+
+            void SwapMemory_Scalar(uint8 *a,uint8 *b,size_t bytes)
+            {
+                uint8 temp[SWAP_BUFFER_BYTES];
+
+                while(bytes)
+                {
+                    const size_t n=(bytes<SWAP_BUFFER_BYTES?bytes:SWAP_BUFFER_BYTES);
+
+                    memcpy(temp,a,n);
+                    memcpy(a,b,n);
+                    memcpy(b,temp,n);
+
+                    a+=n;
+                    b+=n;
+                    bytes-=n;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 void SwapMemory_SSE2(uint8 *a,uint8 *b,size_t bytes)
+            {
+                while(bytes>=32)
+                {
+                    const __m128i a0=_mm_loadu_si128((const __m128i *) a);
+                    const __m128i a1=_mm_loadu_si128((const __m128i *)(a+16));
+                    const __m128i b0=_mm_loadu_si128((const __m128i *) b);
+                    const __m128i b1=_mm_loadu_si128((const __m128i *)(b+16));
+
+                    _mm_storeu_si128((__m128i *) a    ,b0);
+                    _mm_storeu_si128((__m128i *)(a+16),b1);
+                    _mm_storeu_si128((__m128i *) b    ,a0);
+                    _mm_storeu_si128((__m128i *)(b+16),a1);
+
+                    a+=32;
+                    b+=32;
+                    bytes-=32;
+                }
+
+                SwapMemory_Scalar(a,b,bytes);
+            }
+
+            CM2D_TARGET_AVX2 void SwapMemory_AVX2(uint8 *a,uint8 *b,size_t bytes)
+            {
+                while(bytes>=64)
+                {
+                    const __m256i a0=_mm256_loadu_si256((const __m256i *) a);
+                    const __m256i a1=_mm256_loadu_si256((const __m256i *)(a+32));
+                    const __m256i b0=_mm256_loadu_si256((const __m256i *) b);
+                    const __m256i b1=_mm256_loadu_si256((const __m256i *)(b+32));
+
+                    _mm256_storeu_si256((__m256i *) a    ,b0);
+                    _mm256_storeu_si256((__m256i *)(a+32),b1);
+                    _mm256_storeu_si256((__m256i *) b    ,a0);
+                    _mm256_storeu_si256((__m256i *)(b+32),a1);
+
+                    a+=64;
+                    b+=64;
+                    bytes-=64;
+                }
+
+                SwapMemory_Scalar(a,b,bytes);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            void SwapMemory_NEON(uint8 *a,uint8 *b,size_t bytes)
+            {
+                while(bytes>=32)
+                {
+                    const uint8x16_t a0=vld1q_u8(a);
+                    const uint8x16_t a1=vld1q_u8(a+16);
+                    const uint8x16_t b0=vld1q_u8(b);
+                    const uint8x16_t b1=vld1q_u8(b+16);
+
+                    vst1q_u8(a   ,b0);
+                    vst1q_u8(a+16,b1);
+                    vst1q_u8(b   ,a0);
+                    vst1q_u8(b+16,a1);
+
+                    a+=32;
+                    b+=32;
+                    bytes-=32;
+                }
+
+                SwapMemory_Scalar(a,b,bytes);
+            }
+#endif//CM2D_SIMD_NEON
+
+            SwapMemoryFunc SelectSwapMemory()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.avx2)return SwapMemory_AVX2;
+                if(cf.sse2)return SwapMemory_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return SwapMemory_NEON;
+#endif//
+
+                return SwapMemory_Scalar;
+            }
+        }//namespace
+
+        void SwapMemory(void *a,void *b,const size_t bytes)
+        {
+            static const SwapMemoryFunc func=SelectSwapMemory();
+
+            if(!a||!b||a==b||!bytes)return;
+
+            func((uint8 *)a,(uint8 *)b,bytes);
+        }
+    }//namespace bitmap
+}//namespace hgl
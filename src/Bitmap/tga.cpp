@@ -1,10 +1,11 @@
 #include<hgl/2d/TGA.h>
+#include<string.h>
 
 namespace hgl
 {
     namespace imgfmt
     {   
-        bool FillTGAHeader(TGAHeader *header,const uint16 width,const uint16 height,const uint8 channels,const uint8 single_channel_bits)
+        bool FillTGAHeader(TGAHeader *header,const uint16 width,const uint16 height,const uint8 channels,const uint8 single_channel_bits,const bool rle,const bool bottom_up)
         {
             if(!header)return(false);
             if(!width||!height)return(false);
@@ -36,10 +37,138 @@ namespace hgl
                     desc.alpha_depth=single_channel_bits;
             }
 
-            desc.direction=TGA_DIRECTION_UPPER_LEFT;
+            if(rle)
+                header->image_type+=TGA_IMAGE_TYPE_RLE_FLAG;
+
+            desc.direction=bottom_up?TGA_DIRECTION_LOWER_LEFT:TGA_DIRECTION_UPPER_LEFT;
 
             header->image_desc=desc.image_desc;
             return(true);
         }
+
+        bool CheckTGAHeader(const TGAHeader *header)
+        {
+            if(!header)return(false);
+            if(!header->width||!header->height)return(false);
+            if(header->color_map_type>1)return(false);
+
+            const uint base_type=header->image_type&~TGA_IMAGE_TYPE_RLE_FLAG;
+
+            if(header->image_type>TGA_IMAGE_TYPE_RLE_GRAYSCALE)return(false);
+
+            if(header->color_map_type)
+            {
+                if(header->color_map_size!=15
+                 &&header->color_map_size!=16
+                 &&header->color_map_size!=24
+                 &&header->color_map_size!=32)return(false);
+            }
+
+            switch(base_type)
+            {
+                case TGA_IMAGE_TYPE_COLOR_MAP:  return header->color_map_type&&(header->bit==8||header->bit==16);
+                case TGA_IMAGE_TYPE_TRUE_COLOR: return header->bit==15||header->bit==16||header->bit==24||header->bit==32;
+                case TGA_IMAGE_TYPE_GRAYSCALE:  return header->bit==8||header->bit==16;
+                default:                        return(false);
+            }
+        }
+
+        void FillTGAPixels(uint8 *dst,const uint8 *pixel,const uint pixel_bytes,const uint count)
+        {
+            if(!count)return;
+
+            if(pixel_bytes==1)
+            {
+                memset(dst,*pixel,count);
+                return;
+            }
+
+            const size_t total=size_t(pixel_bytes)*count;
+
+            memcpy(dst,pixel,pixel_bytes);
+
+            //每次复制已填充的部分，长度翻倍，大段数据由memcpy以宽指令写入
+            size_t filled=pixel_bytes;
+
+            while(filled<total)
+            {
+                const size_t n=(filled<total-filled)?filled:total-filled;
+
+                memcpy(dst+filled,dst,n);
+                filled+=n;
+            }
+        }
+
+        namespace
+        {
+            inline bool SamePixel(const uint8 *a,const uint8 *b,const uint pixel_bytes)
+            {
+                switch(pixel_bytes)
+                {
+                    case 1: return a[0]==b[0];
+                    case 2: return a[0]==b[0]&&a[1]==b[1];
+                    case 3: return a[0]==b[0]&&a[1]==b[1]&&a[2]==b[2];
+                    default:return memcmp(a,b,pixel_bytes)==0;
+                }
+            }
+        }//namespace
+
+        uint EncodeTGARLE(uint8 *dst,const uint8 *src,const uint count,const uint pixel_bytes)
+        {
+            if(!dst||!src||!count||!pixel_bytes)return 0;
+
+            //单字节象素时，2个相同象素用重复包并不比原始包小
+            const uint min_run=(pixel_bytes==1?3:2);
+
+            uint8 *p=dst;
+            uint raw_start=0;
+            uint i=0;
+
+            const auto flush_raw=[&](const uint end)
+            {
+                while(raw_start<end)
+                {
+                    uint n=end-raw_start;
+
+                    if(n>TGA_RLE_MAX_PACKET_PIXELS)n=TGA_RLE_MAX_PACKET_PIXELS;
+
+                    *p++=uint8(n-1);
+                    memcpy(p,src+raw_start*pixel_bytes,n*pixel_bytes);
+                    p+=n*pixel_bytes;
+                    raw_start+=n;
+                }
+            };
+
+            while(i<count)
+            {
+                const uint8 *cur=src+i*pixel_bytes;
+
+                uint run=1;
+
+                while(i+run<count
+                    &&run<TGA_RLE_MAX_PACKET_PIXELS
+                    &&SamePixel(cur,cur+run*pixel_bytes,pixel_bytes))
+                    ++run;
+
+                if(run<min_run)
+                {
+                    ++i;
+                    continue;
+                }
+
+                flush_raw(i);
+
+                *p++=uint8(0x80|(run-1));
+                memcpy(p,cur,pixel_bytes);
+                p+=pixel_bytes;
+
+                i+=run;
+                raw_start=i;
+            }
+
+            flush_raw(count);
+
+            return uint(p-dst);
+        }
     }//namespace imgfmt
 }//namespace hgl
\ No newline at end of file
@@ -0,0 +1,604 @@
+#include<hgl/2d/Blend.h>
+#include<hgl/2d/CPUFeature.h>
+#include<hgl/2d/Instrument.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * RGBA8混合计算
+ *
+ * 所有实现均使用相同的整数公式:
+ *
+ *      a  =(src.a*alpha+127)/255
+ *      na =255-a
+ *      dst=(src*a+dst*na+127)/255
+ *
+ * 其中(x+127)/255在SIMD中以 y=x+128; (y+(y>>8))>>8 计算，在0-255*255范围内与除法结果完全相同。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        static_assert(sizeof(Vector3u8)==3,"Vector3u8 must be tightly packed");
+        static_assert(sizeof(Vector4u8)==4,"Vector4u8 must be tightly packed");
+
+        namespace
+        {
+            using BlendRGBA8toRGB8Func  =void(*)(Vector3u8 *,const Vector4u8 *,uint,const uint);
+            using BlendRGBA8toRGBA8Func =void(*)(Vector4u8 *,const Vector4u8 *,uint,const uint);
+            using BlendCoverageRGBA8Func=void(*)(Vector4u8 *,const Vector4u8 &,const uint8 *,uint,const uint);
+
+            void BlendRGBA8toRGB8_Scalar(Vector3u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                uint a,na;
+
+                while(count--)
+                {
+                    a=DivideBy255(src->a*alpha);
+                    na=255-a;
+
+                    dst->r=DivideBy255(src->r*a+dst->r*na);
+                    dst->g=DivideBy255(src->g*a+dst->g*na);
+                    dst->b=DivideBy255(src->b*a+dst->b*na);
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            void BlendRGBA8toRGBA8_Scalar(Vector4u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                uint a,na;
+
+                while(count--)
+                {
+                    a=DivideBy255(src->a*alpha);
+                    na=255-a;
+
+                    dst->r=DivideBy255(src->r*a+dst->r*na);
+                    dst->g=DivideBy255(src->g*a+dst->g*na);
+                    dst->b=DivideBy255(src->b*a+dst->b*na);
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            /**
+             * 覆盖率混合等同于以(color.rgb,coverage)为源象素、以color.a*alpha为整体alpha的逐象素混合
+             * @param alpha 已乘上color.a的整体alpha(0-255)
+             */
+            void BlendCoverageRGBA8_Scalar(Vector4u8 *dst,const Vector4u8 &color,const uint8 *coverage,uint count,const uint alpha)
+            {
+                uint a,na;
+
+                while(count--)
+                {
+                    a=DivideBy255(alpha**coverage);
+                    na=255-a;
+
+                    dst->r=DivideBy255(color.r*a+dst->r*na);
+                    dst->g=DivideBy255(color.g*a+dst->g*na);
+                    dst->b=DivideBy255(color.b*a+dst->b*na);
+
+                    ++dst;
+                    ++coverage;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 inline __m128i DivideBy255_SSE2(__m128i x)
+            {
+                x=_mm_add_epi16(x,_mm_set1_epi16(128));
+
+                return _mm_srli_epi16(_mm_add_epi16(x,_mm_srli_epi16(x,8)),8);
+            }
+
+            /**
+             * 混合2个象素(每通道16位)，第4通道alpha视为0，即保持dst原值
+             */
+            CM2D_TARGET_SSE2 inline __m128i Blend2Pixels_SSE2(const __m128i s,const __m128i d,const __m128i alpha)
+            {
+                const __m128i rgb_mask=_mm_set_epi16(0,-1,-1,-1,0,-1,-1,-1);
+
+                __m128i a=_mm_shufflehi_epi16(_mm_shufflelo_epi16(s,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+
+                a=_mm_and_si128(DivideBy255_SSE2(_mm_mullo_epi16(a,alpha)),rgb_mask);
+
+                const __m128i na=_mm_sub_epi16(_mm_set1_epi16(255),a);
+
+                return DivideBy255_SSE2(_mm_add_epi16(_mm_mullo_epi16(s,a),_mm_mullo_epi16(d,na)));
+            }
+
+            /**
+             * 混合4个象素，s为RGBA，d为RGBX(X通道原样保留)
+             */
+            CM2D_TARGET_SSE2 inline __m128i Blend4Pixels_SSE2(const __m128i s,const __m128i d,const __m128i alpha)
+            {
+                const __m128i zero=_mm_setzero_si128();
+
+                const __m128i lo=Blend2Pixels_SSE2(_mm_unpacklo_epi8(s,zero),_mm_unpacklo_epi8(d,zero),alpha);
+                const __m128i hi=Blend2Pixels_SSE2(_mm_unpackhi_epi8(s,zero),_mm_unpackhi_epi8(d,zero),alpha);
+
+                return _mm_packus_epi16(lo,hi);
+            }
+
+            CM2D_TARGET_SSE2 void BlendRGBA8toRGB8_SSE2(Vector3u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                const __m128i va=_mm_set1_epi16(short(alpha));
+
+                uint8 *dp=(uint8 *)dst;
+                uint32 px[4];
+
+                //每次按4字节读写一个RGB象素，多出的1字节是下一象素的R，计算中保持原值。
+                //所以第5个象素必须存在，才能安全读写第4个象素的多余字节
+                while(count>=5)
+                {
+                    memcpy(px+0,dp+0,4);
+                    memcpy(px+1,dp+3,4);
+                    memcpy(px+2,dp+6,4);
+                    memcpy(px+3,dp+9,4);
+
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+                    const __m128i d=_mm_loadu_si128((const __m128i *)px);
+
+                    _mm_storeu_si128((__m128i *)px,Blend4Pixels_SSE2(s,d,va));
+
+                    memcpy(dp+0,px+0,4);
+                    memcpy(dp+3,px+1,4);
+                    memcpy(dp+6,px+2,4);
+                    memcpy(dp+9,px+3,4);
+
+                    dp+=12;
+                    src+=4;
+                    count-=4;
+                }
+
+                BlendRGBA8toRGB8_Scalar((Vector3u8 *)dp,src,count,alpha);
+            }
+
+            CM2D_TARGET_SSE2 void BlendRGBA8toRGBA8_SSE2(Vector4u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                const __m128i va=_mm_set1_epi16(short(alpha));
+
+                while(count>=4)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+                    const __m128i d=_mm_loadu_si128((const __m128i *)dst);
+
+                    _mm_storeu_si128((__m128i *)dst,Blend4Pixels_SSE2(s,d,va));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                BlendRGBA8toRGBA8_Scalar(dst,src,count,alpha);
+            }
+
+            /**
+             * 取得颜色的RGB部分(alpha字节为0)
+             */
+            inline uint32 GetColorRGB(const Vector4u8 &color)
+            {
+                const Vector4u8 rgb(color.r,color.g,color.b,0);
+                uint32 result;
+
+                memcpy(&result,&rgb,4);
+                return result;
+            }
+
+            CM2D_TARGET_SSE2 void BlendCoverageRGBA8_SSE2(Vector4u8 *dst,const Vector4u8 &color,const uint8 *coverage,uint count,const uint alpha)
+            {
+                const __m128i va=_mm_set1_epi16(short(alpha));
+                const __m128i rgb=_mm_set1_epi32(int(GetColorRGB(color)));
+                const __m128i zero=_mm_setzero_si128();
+
+                uint32 c4;
+
+                while(count>=4)
+                {
+                    memcpy(&c4,coverage,4);
+
+                    if(c4)                                                      //字形中大量覆盖率为0的象素可直接跳过
+                    {
+                        const __m128i cv=_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(c4)),zero),zero);
+                        const __m128i s=_mm_or_si128(rgb,_mm_slli_epi32(cv,24));
+                        const __m128i d=_mm_loadu_si128((const __m128i *)dst);
+
+                        _mm_storeu_si128((__m128i *)dst,Blend4Pixels_SSE2(s,d,va));
+                    }
+
+                    dst+=4;
+                    coverage+=4;
+                    count-=4;
+                }
+
+                BlendCoverageRGBA8_Scalar(dst,color,coverage,count,alpha);
+            }
+
+            CM2D_TARGET_AVX2 inline __m256i DivideBy255_AVX2(__m256i x)
+            {
+                x=_mm256_add_epi16(x,_mm256_set1_epi16(128));
+
+                return _mm256_srli_epi16(_mm256_add_epi16(x,_mm256_srli_epi16(x,8)),8);
+            }
+
+            CM2D_TARGET_AVX2 inline __m256i Blend4Pixels_AVX2(const __m256i s,const __m256i d,const __m256i alpha)
+            {
+                const __m256i rgb_mask=_mm256_set_epi16(0,-1,-1,-1,0,-1,-1,-1,0,-1,-1,-1,0,-1,-1,-1);
+
+                __m256i a=_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+
+                a=_mm256_and_si256(DivideBy255_AVX2(_mm256_mullo_epi16(a,alpha)),rgb_mask);
+
+                const __m256i na=_mm256_sub_epi16(_mm256_set1_epi16(255),a);
+
+                return DivideBy255_AVX2(_mm256_add_epi16(_mm256_mullo_epi16(s,a),_mm256_mullo_epi16(d,na)));
+            }
+
+            /**
+             * 混合8个象素，s为RGBA，d为RGBX(X通道原样保留)
+             */
+            CM2D_TARGET_AVX2 inline __m256i Blend8Pixels_AVX2(const __m256i s,const __m256i d,const __m256i alpha)
+            {
+                const __m256i zero=_mm256_setzero_si256();
+
+                const __m256i lo=Blend4Pixels_AVX2(_mm256_unpacklo_epi8(s,zero),_mm256_unpacklo_epi8(d,zero),alpha);
+                const __m256i hi=Blend4Pixels_AVX2(_mm256_unpackhi_epi8(s,zero),_mm256_unpackhi_epi8(d,zero),alpha);
+
+                return _mm256_packus_epi16(lo,hi);
+            }
+
+            CM2D_TARGET_AVX2 void BlendRGBA8toRGB8_AVX2(Vector3u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                const __m256i va=_mm256_set1_epi16(short(alpha));
+
+                //每个128位通道处理4个RGB象素(12字节)，与RGBX相互转换
+                const __m256i expand=_mm256_setr_epi8(0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11,-1,
+                                                      0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11,-1);
+                const __m256i pack  =_mm256_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1,
+                                                      0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+                const __m256i tail  =_mm256_setr_epi8(0,0,0,0,0,0,0,0,0,0,0,0,-1,-1,-1,-1,
+                                                      0,0,0,0,0,0,0,0,0,0,0,0,-1,-1,-1,-1);
+
+                uint8 *dp=(uint8 *)dst;
+
+                //第二个128位读写会越过8个象素4个字节，所以至少要有10个象素
+                while(count>=10)
+                {
+                    const __m256i s=_mm256_loadu_si256((const __m256i *)src);
+                    const __m256i d=_mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dp)),
+                                                            _mm_loadu_si128((const __m128i *)(dp+12)),1);
+
+                    __m256i r=Blend8Pixels_AVX2(s,_mm256_shuffle_epi8(d,expand),va);
+
+                    r=_mm256_blendv_epi8(_mm256_shuffle_epi8(r,pack),d,tail);
+
+                    //必须先写低半部分，其尾部4字节原值会被高半部分覆盖
+                    _mm_storeu_si128((__m128i *)dp,_mm256_castsi256_si128(r));
+                    _mm_storeu_si128((__m128i *)(dp+12),_mm256_extracti128_si256(r,1));
+
+                    dp+=24;
+                    src+=8;
+                    count-=8;
+                }
+
+                BlendRGBA8toRGB8_SSE2((Vector3u8 *)dp,src,count,alpha);
+            }
+
+            CM2D_TARGET_AVX2 void BlendRGBA8toRGBA8_AVX2(Vector4u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                const __m256i va=_mm256_set1_epi16(short(alpha));
+
+                while(count>=8)
+                {
+                    const __m256i s=_mm256_loadu_si256((const __m256i *)src);
+                    const __m256i d=_mm256_loadu_si256((const __m256i *)dst);
+
+                    _mm256_storeu_si256((__m256i *)dst,Blend8Pixels_AVX2(s,d,va));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                BlendRGBA8toRGBA8_SSE2(dst,src,count,alpha);
+            }
+
+            CM2D_TARGET_AVX2 void BlendCoverageRGBA8_AVX2(Vector4u8 *dst,const Vector4u8 &color,const uint8 *coverage,uint count,const uint alpha)
+            {
+                if(count<16)                                                    //短的一段(如字形的一行)在使用任何AVX指令之前转入SSE2实现更快
+                {
+                    BlendCoverageRGBA8_SSE2(dst,color,coverage,count,alpha);
+                    return;
+                }
+
+                const __m256i va=_mm256_set1_epi16(short(alpha));
+                const __m256i rgb=_mm256_set1_epi32(int(GetColorRGB(color)));
+
+                uint64 c8;
+
+                while(count>=8)
+                {
+                    memcpy(&c8,coverage,8);
+
+                    if(c8)
+                    {
+                        const __m256i cv=_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)coverage));
+                        const __m256i s=_mm256_or_si256(rgb,_mm256_slli_epi32(cv,24));
+                        const __m256i d=_mm256_loadu_si256((const __m256i *)dst);
+
+                        _mm256_storeu_si256((__m256i *)dst,Blend8Pixels_AVX2(s,d,va));
+                    }
+
+                    dst+=8;
+                    coverage+=8;
+                    count-=8;
+                }
+
+                //字形每行通常只有十几个象素，尾部不转入SSE2函数(AVX与SSE指令切换代价很大)，以掩码读写补齐到8个象素处理
+                if(count)
+                {
+                    uint8 cv[8]={};
+
+                    for(uint i=0;i<count;i++)
+                        cv[i]=coverage[i];
+
+                    const __m256i mask=_mm256_cmpgt_epi32(_mm256_set1_epi32(int(count)),_mm256_setr_epi32(0,1,2,3,4,5,6,7));
+                    const __m256i s=_mm256_or_si256(rgb,_mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)cv)),24));
+                    const __m256i d=_mm256_maskload_epi32((const int *)dst,mask);
+
+                    _mm256_maskstore_epi32((int *)dst,mask,Blend8Pixels_AVX2(s,d,va));
+                }
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            inline uint8x8_t DivideBy255_NEON(const uint16x8_t x)
+            {
+                //(x+((x+128)>>8)+128)>>8
+                return vrshrn_n_u16(vrsraq_n_u16(x,x,8),8);
+            }
+
+            inline uint8x8_t BlendChannel_NEON(const uint8x8_t s,const uint8x8_t d,const uint8x8_t a,const uint8x8_t na)
+            {
+                return DivideBy255_NEON(vmlal_u8(vmull_u8(s,a),d,na));
+            }
+
+            void BlendRGBA8toRGB8_NEON(Vector3u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                const uint8x8_t va=vdup_n_u8(uint8(alpha));
+                const uint8x8_t v255=vdup_n_u8(255);
+
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=8)
+                {
+                    const uint8x8x4_t s=vld4_u8(sp);
+                          uint8x8x3_t d=vld3_u8(dp);
+
+                    const uint8x8_t a=DivideBy255_NEON(vmull_u8(s.val[3],va));
+                    const uint8x8_t na=vsub_u8(v255,a);
+
+                    d.val[0]=BlendChannel_NEON(s.val[0],d.val[0],a,na);
+                    d.val[1]=BlendChannel_NEON(s.val[1],d.val[1],a,na);
+                    d.val[2]=BlendChannel_NEON(s.val[2],d.val[2],a,na);
+
+                    vst3_u8(dp,d);
+
+                    dp+=24;
+                    sp+=32;
+                    count-=8;
+                }
+
+                BlendRGBA8toRGB8_Scalar((Vector3u8 *)dp,(const Vector4u8 *)sp,count,alpha);
+            }
+
+            void BlendRGBA8toRGBA8_NEON(Vector4u8 *dst,const Vector4u8 *src,uint count,const uint alpha)
+            {
+                const uint8x8_t va=vdup_n_u8(uint8(alpha));
+                const uint8x8_t v255=vdup_n_u8(255);
+
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=8)
+                {
+                    const uint8x8x4_t s=vld4_u8(sp);
+                          uint8x8x4_t d=vld4_u8(dp);
+
+                    const uint8x8_t a=DivideBy255_NEON(vmull_u8(s.val[3],va));
+                    const uint8x8_t na=vsub_u8(v255,a);
+
+                    d.val[0]=BlendChannel_NEON(s.val[0],d.val[0],a,na);
+                    d.val[1]=BlendChannel_NEON(s.val[1],d.val[1],a,na);
+                    d.val[2]=BlendChannel_NEON(s.val[2],d.val[2],a,na);
+
+                    vst4_u8(dp,d);
+
+                    dp+=32;
+                    sp+=32;
+                    count-=8;
+                }
+
+                BlendRGBA8toRGBA8_Scalar((Vector4u8 *)dp,(const Vector4u8 *)sp,count,alpha);
+            }
+
+            void BlendCoverageRGBA8_NEON(Vector4u8 *dst,const Vector4u8 &color,const uint8 *coverage,uint count,const uint alpha)
+            {
+                const uint8x8_t va=vdup_n_u8(uint8(alpha));
+                const uint8x8_t v255=vdup_n_u8(255);
+                const uint8x8_t cr=vdup_n_u8(color.r);
+                const uint8x8_t cg=vdup_n_u8(color.g);
+                const uint8x8_t cb=vdup_n_u8(color.b);
+
+                uint8 *dp=(uint8 *)dst;
+
+                while(count>=8)
+                {
+                    const uint8x8_t cv=vld1_u8(coverage);
+
+                    if(vget_lane_u64(vreinterpret_u64_u8(cv),0))
+                    {
+                        uint8x8x4_t d=vld4_u8(dp);
+
+                        const uint8x8_t a=DivideBy255_NEON(vmull_u8(cv,va));
+                        const uint8x8_t na=vsub_u8(v255,a);
+
+                        d.val[0]=BlendChannel_NEON(cr,d.val[0],a,na);
+                        d.val[1]=BlendChannel_NEON(cg,d.val[1],a,na);
+                        d.val[2]=BlendChannel_NEON(cb,d.val[2],a,na);
+
+                        vst4_u8(dp,d);
+                    }
+
+                    dp+=32;
+                    coverage+=8;
+                    count-=8;
+                }
+
+                BlendCoverageRGBA8_Scalar((Vector4u8 *)dp,color,coverage,count,alpha);
+            }
+#endif//CM2D_SIMD_NEON
+
+            BlendRGBA8toRGB8Func SelectBlendRGBA8toRGB8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.avx2)return BlendRGBA8toRGB8_AVX2;
+                if(cf.sse2)return BlendRGBA8toRGB8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return BlendRGBA8toRGB8_NEON;
+#endif//
+
+                return BlendRGBA8toRGB8_Scalar;
+            }
+
+            BlendRGBA8toRGBA8Func SelectBlendRGBA8toRGBA8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.avx2)return BlendRGBA8toRGBA8_AVX2;
+                if(cf.sse2)return BlendRGBA8toRGBA8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return BlendRGBA8toRGBA8_NEON;
+#endif//
+
+                return BlendRGBA8toRGBA8_Scalar;
+            }
+
+            BlendCoverageRGBA8Func SelectBlendCoverageRGBA8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.avx2)return BlendCoverageRGBA8_AVX2;
+                if(cf.sse2)return BlendCoverageRGBA8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return BlendCoverageRGBA8_NEON;
+#endif//
+
+                return BlendCoverageRGBA8_Scalar;
+            }
+        }//namespace
+
+        void BlendRGBA8toRGB8(Vector3u8 *dst,const Vector4u8 *src,const uint count,const float alpha)
+        {
+            static const BlendRGBA8toRGB8Func func=SelectBlendRGBA8toRGB8();
+
+            if(!dst||!src||!count||alpha<=0)return;
+
+            func(dst,src,count,AlphaToU8(alpha));
+        }
+
+        void BlendRGBA8toRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count,const float alpha)
+        {
+            static const BlendRGBA8toRGBA8Func func=SelectBlendRGBA8toRGBA8();
+
+            if(!dst||!src||!count||alpha<=0)return;
+
+            func(dst,src,count,AlphaToU8(alpha));
+        }
+
+        void BlendCoverageRGBA8(Vector4u8 *dst,const Vector4u8 &color,const uint8 *coverage,const uint count,const float alpha)
+        {
+            static const BlendCoverageRGBA8Func func=SelectBlendCoverageRGBA8();
+
+            if(!dst||!coverage||!count)return;
+
+            const uint ca=DivideBy255(color.a*AlphaToU8(alpha));
+
+            if(!ca)return;
+
+            func(dst,color,coverage,count,ca);
+        }
+
+        template<> void BlendBitmap<BitmapViewRGBA8,BitmapViewRGB8>::operator()(const BitmapViewRGBA8 *src_bitmap,BitmapViewRGB8 *dst_bitmap,const float alpha)const
+        {
+            CM2D_INSTRUMENT_SCOPE(BlendBitmap);
+
+            if(!src_bitmap||!dst_bitmap||alpha<=0)return;
+
+            if(src_bitmap->GetWidth()!=dst_bitmap->GetWidth()
+             ||src_bitmap->GetHeight()!=dst_bitmap->GetHeight())
+                return;
+
+            CM2D_INSTRUMENT_PIXELS(src_bitmap->GetTotalPixels());
+
+            if(src_bitmap->IsContinuous()&&dst_bitmap->IsContinuous())
+            {
+                BlendRGBA8toRGB8(dst_bitmap->GetData(),src_bitmap->GetData(),src_bitmap->GetTotalPixels(),alpha);
+                return;
+            }
+
+            const int width=src_bitmap->GetWidth();
+            const int height=src_bitmap->GetHeight();
+
+            for(int y=0;y<height;y++)
+                BlendRGBA8toRGB8(dst_bitmap->GetLine(y),src_bitmap->GetLine(y),width,alpha);
+        }
+
+        template<> void BlendBitmap<BitmapViewRGBA8,BitmapViewRGBA8>::operator()(const BitmapViewRGBA8 *src_bitmap,BitmapViewRGBA8 *dst_bitmap,const float alpha)const
+        {
+            CM2D_INSTRUMENT_SCOPE(BlendBitmap);
+
+            if(!src_bitmap||!dst_bitmap||alpha<=0)return;
+
+            if(src_bitmap->GetWidth()!=dst_bitmap->GetWidth()
+             ||src_bitmap->GetHeight()!=dst_bitmap->GetHeight())
+                return;
+
+            CM2D_INSTRUMENT_PIXELS(src_bitmap->GetTotalPixels());
+
+            if(src_bitmap->IsContinuous()&&dst_bitmap->IsContinuous())
+            {
+                BlendRGBA8toRGBA8(dst_bitmap->GetData(),src_bitmap->GetData(),src_bitmap->GetTotalPixels(),alpha);
+                return;
+            }
+
+            const int width=src_bitmap->GetWidth();
+            const int height=src_bitmap->GetHeight();
+
+            for(int y=0;y<height;y++)
+                BlendRGBA8toRGBA8(dst_bitmap->GetLine(y),src_bitmap->GetLine(y),width,alpha);
+        }
+
+        template<> void BlendBitmap<BitmapRGBA8,BitmapRGB8>::operator()(const BitmapRGBA8 *src_bitmap,BitmapRGB8 *dst_bitmap,const float alpha)const
+        {
+            BlendBitmapRGBA8toRGB8()(src_bitmap,dst_bitmap,alpha);
+        }
+
+        template<> void BlendBitmap<BitmapRGBA8,BitmapRGBA8>::operator()(const BitmapRGBA8 *src_bitmap,BitmapRGBA8 *dst_bitmap,const float alpha)const
+        {
+            BlendBitmapRGBA8toRGBA8()(src_bitmap,dst_bitmap,alpha);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,134 @@
+#include<hgl/2d/Blend.h>
+#include<hgl/2d/CPUFeature.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * U32饱和叠加
+ *
+ * alpha为1时为无符号32位饱和加法，SSE2没有无符号比较，以异或最高位后的有符号比较判断进位。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            using BlendAdditiveU32Func=void(*)(uint32 *,const uint32 *,uint);
+
+            void BlendAdditiveU32_Scalar(uint32 *dst,const uint32 *src,uint count)
+            {
+                while(count--)
+                {
+                    const uint64 result=uint64(*src)+*dst;
+
+                    *dst=(result>HGL_U32_MAX)?HGL_U32_MAX:uint32(result);
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 void BlendAdditiveU32_SSE2(uint32 *dst,const uint32 *src,uint count)
+            {
+                const __m128i sign=_mm_set1_epi32(int(0x80000000));
+
+                while(count>=4)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+                    const __m128i d=_mm_loadu_si128((const __m128i *)dst);
+                    const __m128i r=_mm_add_epi32(s,d);
+
+                    //r<d(无符号)即产生了进位
+                    const __m128i carry=_mm_cmpgt_epi32(_mm_xor_si128(d,sign),_mm_xor_si128(r,sign));
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_or_si128(r,carry));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                BlendAdditiveU32_Scalar(dst,src,count);
+            }
+
+            CM2D_TARGET_AVX2 void BlendAdditiveU32_AVX2(uint32 *dst,const uint32 *src,uint count)
+            {
+                while(count>=8)
+                {
+                    const __m256i s=_mm256_loadu_si256((const __m256i *)src);
+                    const __m256i d=_mm256_loadu_si256((const __m256i *)dst);
+                    const __m256i r=_mm256_add_epi32(s,d);
+
+                    //r>=d(无符号)时max(r,d)==r，否则产生了进位
+                    const __m256i carry=_mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(r,d),r),_mm256_set1_epi32(-1));
+
+                    _mm256_storeu_si256((__m256i *)dst,_mm256_or_si256(r,carry));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                BlendAdditiveU32_Scalar(dst,src,count);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            void BlendAdditiveU32_NEON(uint32 *dst,const uint32 *src,uint count)
+            {
+                while(count>=4)
+                {
+                    vst1q_u32(dst,vqaddq_u32(vld1q_u32(dst),vld1q_u32(src)));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                BlendAdditiveU32_Scalar(dst,src,count);
+            }
+#endif//CM2D_SIMD_NEON
+
+            BlendAdditiveU32Func SelectBlendAdditiveU32()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.avx2)return BlendAdditiveU32_AVX2;
+                if(cf.sse2)return BlendAdditiveU32_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return BlendAdditiveU32_NEON;
+#endif//
+
+                return BlendAdditiveU32_Scalar;
+            }
+        }//namespace
+
+        void BlendAdditiveU32(uint32 *dst,const uint32 *src,const uint count,const float alpha)
+        {
+            static const BlendAdditiveU32Func func=SelectBlendAdditiveU32();
+
+            if(!dst||!src||!count||alpha<=0)return;
+
+            if(alpha>=1)
+            {
+                func(dst,src,count);
+                return;
+            }
+
+            //与BlendColorU32Additive带alpha的公式相同
+            for(uint i=0;i<count;i++)
+            {
+                const uint64 result=uint64(src[i]*alpha)+dst[i];
+
+                dst[i]=(result>HGL_U32_MAX)?HGL_U32_MAX:uint32(result);
+            }
+        }
+    }//namespace bitmap
+}//namespace hgl
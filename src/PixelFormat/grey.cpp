@@ -0,0 +1,388 @@
+#include<hgl/2d/PixelFormat.h>
+#include<hgl/2d/CPUFeature.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * 灰度相关转换
+ *
+ * 亮度  Y=(77*R+150*G+29*B+128)>>8
+ *
+ * 权重之和为256，所有实现结果完全相同。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint GREY_WEIGHT_R=77;
+            constexpr uint GREY_WEIGHT_G=150;
+            constexpr uint GREY_WEIGHT_B=29;
+
+            using RGB8toGrey8Func   =void(*)(uint8 *,const Vector3u8 *,uint,const bool);
+            using RGBA8toGrey8Func  =void(*)(uint8 *,const Vector4u8 *,uint,const bool);
+            using Grey8toRGB8Func   =void(*)(Vector3u8 *,const uint8 *,uint);
+            using Grey8toRGBA8Func  =void(*)(Vector4u8 *,const uint8 *,uint,const uint8);
+
+            /**
+             * @param stride 每象素字节数(3或4)
+             */
+            void ToGrey8_Scalar(uint8 *dst,const uint8 *src,uint count,const uint stride,const bool bgr)
+            {
+                const uint wr=bgr?GREY_WEIGHT_B:GREY_WEIGHT_R;
+                const uint wb=bgr?GREY_WEIGHT_R:GREY_WEIGHT_B;
+
+                while(count--)
+                {
+                    *dst++=uint8((src[0]*wr+src[1]*GREY_WEIGHT_G+src[2]*wb+128)>>8);
+
+                    src+=stride;
+                }
+            }
+
+            void RGB8toGrey8_Scalar(uint8 *dst,const Vector3u8 *src,uint count,const bool bgr)
+            {
+                ToGrey8_Scalar(dst,(const uint8 *)src,count,3,bgr);
+            }
+
+            void RGBA8toGrey8_Scalar(uint8 *dst,const Vector4u8 *src,uint count,const bool bgr)
+            {
+                ToGrey8_Scalar(dst,(const uint8 *)src,count,4,bgr);
+            }
+
+            void Grey8toRGB8_Scalar(Vector3u8 *dst,const uint8 *src,uint count)
+            {
+                while(count--)
+                {
+                    dst->r=dst->g=dst->b=*src++;
+                    ++dst;
+                }
+            }
+
+            void Grey8toRGBA8_Scalar(Vector4u8 *dst,const uint8 *src,uint count,const uint8 alpha)
+            {
+                while(count--)
+                {
+                    dst->r=dst->g=dst->b=*src++;
+                    dst->a=alpha;
+                    ++dst;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            /**
+             * 计算4个RGBX象素的亮度，结果为4个32位整数
+             */
+            CM2D_TARGET_SSE2 inline __m128i Grey4Pixels_SSE2(const __m128i s,const __m128i weight)
+            {
+                const __m128i zero=_mm_setzero_si128();
+
+                //每个象素得到两个32位数: R*wr+G*wg, B*wb+X*0
+                const __m128i lo=_mm_madd_epi16(_mm_unpacklo_epi8(s,zero),weight);
+                const __m128i hi=_mm_madd_epi16(_mm_unpackhi_epi8(s,zero),weight);
+
+                const __m128i even=_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo),_mm_castsi128_ps(hi),_MM_SHUFFLE(2,0,2,0)));
+                const __m128i odd =_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo),_mm_castsi128_ps(hi),_MM_SHUFFLE(3,1,3,1)));
+
+                return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(even,odd),_mm_set1_epi32(128)),8);
+            }
+
+            CM2D_TARGET_SSE2 inline __m128i GreyWeight_SSE2(const bool bgr)
+            {
+                return bgr?_mm_setr_epi16(GREY_WEIGHT_B,GREY_WEIGHT_G,GREY_WEIGHT_R,0,GREY_WEIGHT_B,GREY_WEIGHT_G,GREY_WEIGHT_R,0)
+                          :_mm_setr_epi16(GREY_WEIGHT_R,GREY_WEIGHT_G,GREY_WEIGHT_B,0,GREY_WEIGHT_R,GREY_WEIGHT_G,GREY_WEIGHT_B,0);
+            }
+
+            /**
+             * 将16个32位亮度值打包为16字节
+             */
+            CM2D_TARGET_SSE2 inline __m128i PackGrey16_SSE2(const __m128i g0,const __m128i g1,const __m128i g2,const __m128i g3)
+            {
+                return _mm_packus_epi16(_mm_packs_epi32(g0,g1),_mm_packs_epi32(g2,g3));
+            }
+
+            CM2D_TARGET_SSE2 void RGBA8toGrey8_SSE2(uint8 *dst,const Vector4u8 *src,uint count,const bool bgr)
+            {
+                const __m128i weight=GreyWeight_SSE2(bgr);
+
+                while(count>=16)
+                {
+                    const __m128i g0=Grey4Pixels_SSE2(_mm_loadu_si128((const __m128i *)(src   )),weight);
+                    const __m128i g1=Grey4Pixels_SSE2(_mm_loadu_si128((const __m128i *)(src+ 4)),weight);
+                    const __m128i g2=Grey4Pixels_SSE2(_mm_loadu_si128((const __m128i *)(src+ 8)),weight);
+                    const __m128i g3=Grey4Pixels_SSE2(_mm_loadu_si128((const __m128i *)(src+12)),weight);
+
+                    _mm_storeu_si128((__m128i *)dst,PackGrey16_SSE2(g0,g1,g2,g3));
+
+                    dst+=16;
+                    src+=16;
+                    count-=16;
+                }
+
+                RGBA8toGrey8_Scalar(dst,src,count,bgr);
+            }
+
+            CM2D_TARGET_SSSE3 void RGB8toGrey8_SSSE3(uint8 *dst,const Vector3u8 *src,uint count,const bool bgr)
+            {
+                const __m128i weight=GreyWeight_SSE2(bgr);
+                const __m128i expand=_mm_setr_epi8(0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11,-1);
+
+                const uint8 *sp=(const uint8 *)src;
+
+                //16个象素共48字节，最后一次16字节读取从第36字节开始，在范围内
+                while(count>=16)
+                {
+                    const __m128i g0=Grey4Pixels_SSE2(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(sp   )),expand),weight);
+                    const __m128i g1=Grey4Pixels_SSE2(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(sp+12)),expand),weight);
+                    const __m128i g2=Grey4Pixels_SSE2(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(sp+24)),expand),weight);
+                    const __m128i g3=Grey4Pixels_SSE2(_mm_shuffle_epi8(_mm_srli_si128(_mm_loadu_si128((const __m128i *)(sp+32)),4),expand),weight);
+
+                    _mm_storeu_si128((__m128i *)dst,PackGrey16_SSE2(g0,g1,g2,g3));
+
+                    dst+=16;
+                    sp+=48;
+                    count-=16;
+                }
+
+                RGB8toGrey8_Scalar(dst,(const Vector3u8 *)sp,count,bgr);
+            }
+
+            CM2D_TARGET_SSSE3 void Grey8toRGB8_SSSE3(Vector3u8 *dst,const uint8 *src,uint count)
+            {
+                const __m128i m0=_mm_setr_epi8( 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+                const __m128i m1=_mm_setr_epi8( 5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9,10,10);
+                const __m128i m2=_mm_setr_epi8(10,11,11,11,12,12,12,13,13,13,14,14,14,15,15,15);
+
+                uint8 *dp=(uint8 *)dst;
+
+                while(count>=16)
+                {
+                    const __m128i g=_mm_loadu_si128((const __m128i *)src);
+
+                    _mm_storeu_si128((__m128i *)(dp   ),_mm_shuffle_epi8(g,m0));
+                    _mm_storeu_si128((__m128i *)(dp+16),_mm_shuffle_epi8(g,m1));
+                    _mm_storeu_si128((__m128i *)(dp+32),_mm_shuffle_epi8(g,m2));
+
+                    dp+=48;
+                    src+=16;
+                    count-=16;
+                }
+
+                Grey8toRGB8_Scalar((Vector3u8 *)dp,src,count);
+            }
+
+            CM2D_TARGET_SSE2 void Grey8toRGBA8_SSE2(Vector4u8 *dst,const uint8 *src,uint count,const uint8 alpha)
+            {
+                const __m128i rgb_mask=_mm_set1_epi32(0x00FFFFFF);
+                const __m128i va=_mm_set1_epi32(int(uint32(alpha)<<24));
+
+                while(count>=16)
+                {
+                    const __m128i g=_mm_loadu_si128((const __m128i *)src);
+
+                    const __m128i lo=_mm_unpacklo_epi8(g,g);
+                    const __m128i hi=_mm_unpackhi_epi8(g,g);
+
+                    _mm_storeu_si128((__m128i *)(dst   ),_mm_or_si128(_mm_and_si128(_mm_unpacklo_epi16(lo,lo),rgb_mask),va));
+                    _mm_storeu_si128((__m128i *)(dst+ 4),_mm_or_si128(_mm_and_si128(_mm_unpackhi_epi16(lo,lo),rgb_mask),va));
+                    _mm_storeu_si128((__m128i *)(dst+ 8),_mm_or_si128(_mm_and_si128(_mm_unpacklo_epi16(hi,hi),rgb_mask),va));
+                    _mm_storeu_si128((__m128i *)(dst+12),_mm_or_si128(_mm_and_si128(_mm_unpackhi_epi16(hi,hi),rgb_mask),va));
+
+                    dst+=16;
+                    src+=16;
+                    count-=16;
+                }
+
+                Grey8toRGBA8_Scalar(dst,src,count,alpha);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            inline uint8x8_t Grey8Pixels_NEON(const uint8x8_t r,const uint8x8_t g,const uint8x8_t b)
+            {
+                uint16x8_t y=vmull_u8(r,vdup_n_u8(GREY_WEIGHT_R));
+
+                y=vmlal_u8(y,g,vdup_n_u8(GREY_WEIGHT_G));
+                y=vmlal_u8(y,b,vdup_n_u8(GREY_WEIGHT_B));
+
+                return vrshrn_n_u16(y,8);
+            }
+
+            void RGB8toGrey8_NEON(uint8 *dst,const Vector3u8 *src,uint count,const bool bgr)
+            {
+                const uint ri=bgr?2:0;
+
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=8)
+                {
+                    const uint8x8x3_t s=vld3_u8(sp);
+
+                    vst1_u8(dst,Grey8Pixels_NEON(s.val[ri],s.val[1],s.val[2-ri]));
+
+                    dst+=8;
+                    sp+=24;
+                    count-=8;
+                }
+
+                RGB8toGrey8_Scalar(dst,(const Vector3u8 *)sp,count,bgr);
+            }
+
+            void RGBA8toGrey8_NEON(uint8 *dst,const Vector4u8 *src,uint count,const bool bgr)
+            {
+                const uint ri=bgr?2:0;
+
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=8)
+                {
+                    const uint8x8x4_t s=vld4_u8(sp);
+
+                    vst1_u8(dst,Grey8Pixels_NEON(s.val[ri],s.val[1],s.val[2-ri]));
+
+                    dst+=8;
+                    sp+=32;
+                    count-=8;
+                }
+
+                RGBA8toGrey8_Scalar(dst,(const Vector4u8 *)sp,count,bgr);
+            }
+
+            void Grey8toRGB8_NEON(Vector3u8 *dst,const uint8 *src,uint count)
+            {
+                uint8 *dp=(uint8 *)dst;
+
+                uint8x16x3_t d;
+
+                while(count>=16)
+                {
+                    d.val[0]=d.val[1]=d.val[2]=vld1q_u8(src);
+
+                    vst3q_u8(dp,d);
+
+                    dp+=48;
+                    src+=16;
+                    count-=16;
+                }
+
+                Grey8toRGB8_Scalar((Vector3u8 *)dp,src,count);
+            }
+
+            void Grey8toRGBA8_NEON(Vector4u8 *dst,const uint8 *src,uint count,const uint8 alpha)
+            {
+                uint8 *dp=(uint8 *)dst;
+
+                uint8x16x4_t d;
+
+                d.val[3]=vdupq_n_u8(alpha);
+
+                while(count>=16)
+                {
+                    d.val[0]=d.val[1]=d.val[2]=vld1q_u8(src);
+
+                    vst4q_u8(dp,d);
+
+                    dp+=64;
+                    src+=16;
+                    count-=16;
+                }
+
+                Grey8toRGBA8_Scalar((Vector4u8 *)dp,src,count,alpha);
+            }
+#endif//CM2D_SIMD_NEON
+
+            RGB8toGrey8Func SelectRGB8toGrey8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.ssse3)return RGB8toGrey8_SSSE3;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return RGB8toGrey8_NEON;
+#endif//
+
+                return RGB8toGrey8_Scalar;
+            }
+
+            RGBA8toGrey8Func SelectRGBA8toGrey8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.sse2)return RGBA8toGrey8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return RGBA8toGrey8_NEON;
+#endif//
+
+                return RGBA8toGrey8_Scalar;
+            }
+
+            Grey8toRGB8Func SelectGrey8toRGB8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.ssse3)return Grey8toRGB8_SSSE3;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return Grey8toRGB8_NEON;
+#endif//
+
+                return Grey8toRGB8_Scalar;
+            }
+
+            Grey8toRGBA8Func SelectGrey8toRGBA8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.sse2)return Grey8toRGBA8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return Grey8toRGBA8_NEON;
+#endif//
+
+                return Grey8toRGBA8_Scalar;
+            }
+        }//namespace
+
+        void RGB8toGrey8(uint8 *dst,const Vector3u8 *src,const uint count,const bool bgr)
+        {
+            static const RGB8toGrey8Func func=SelectRGB8toGrey8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count,bgr);
+        }
+
+        void RGBA8toGrey8(uint8 *dst,const Vector4u8 *src,const uint count,const bool bgr)
+        {
+            static const RGBA8toGrey8Func func=SelectRGBA8toGrey8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count,bgr);
+        }
+
+        void Grey8toRGB8(Vector3u8 *dst,const uint8 *src,const uint count)
+        {
+            static const Grey8toRGB8Func func=SelectGrey8toRGB8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void Grey8toRGBA8(Vector4u8 *dst,const uint8 *src,const uint count,const uint8 alpha)
+        {
+            static const Grey8toRGBA8Func func=SelectGrey8toRGBA8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count,alpha);
+        }
+    }//namespace bitmap
+}//namespace hgl
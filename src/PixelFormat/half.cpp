@@ -0,0 +1,328 @@
+#include<hgl/2d/PixelFormat.h>
+#include<hgl/2d/CPUFeature.h>
+#include<string.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+#if defined(CM2D_SIMD_NEON)&&(defined(__aarch64__)||defined(_M_ARM64))
+    #define CM2D_HALF_NEON
+#endif//
+
+/**
+ * 半精度浮点转换
+ *
+ * 标量版本按IEEE 754就近舍入(逢中取偶)，与F16C的vcvtps2ph结果相同(NaN的载荷除外)。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        static_assert(sizeof(half_float)==2,"half_float must be 16 bits");
+
+        namespace
+        {
+            using FloatToHalfFunc   =void(*)(half_float *,const float *,uint);
+            using HalfToFloatFunc   =void(*)(float *,const half_float *,uint);
+            using HalftoU8Func      =void(*)(uint8 *,const half_float *,uint);
+
+            inline uint16 FloatToHalfBits(const float value)
+            {
+                constexpr uint32 f32_infinity=255<<23;
+                constexpr uint32 f16_max     =(127+16)<<23;                     //2^16，超出半精度范围
+                constexpr uint32 denorm_magic=((127-15)+(23-10)+1)<<23;
+
+                uint32 f;
+                memcpy(&f,&value,4);
+
+                const uint32 sign=f&0x80000000;
+
+                f^=sign;
+
+                uint16 result;
+
+                if(f>=f16_max)
+                {
+                    result=(f>f32_infinity)?0x7E00:0x7C00;                      //NaN或无穷大
+                }
+                else
+                if(f<(113<<23))                                                 //结果为非规格化数或0
+                {
+                    //借助浮点加法完成舍入
+                    float fv,magic;
+
+                    memcpy(&fv,&f,4);
+                    memcpy(&magic,&denorm_magic,4);
+
+                    fv+=magic;
+
+                    memcpy(&f,&fv,4);
+                    result=uint16(f-denorm_magic);
+                }
+                else
+                {
+                    const uint32 mant_odd=(f>>13)&1;
+
+                    f+=(uint32(15-127)<<23)+0xFFF;
+                    f+=mant_odd;
+
+                    result=uint16(f>>13);
+                }
+
+                return result|uint16(sign>>16);
+            }
+
+            inline float HalfBitsToFloat(const uint16 h)
+            {
+                constexpr uint32 shifted_exp=0x7C00<<13;
+                constexpr uint32 magic_bits=113<<23;
+
+                uint32 o=uint32(h&0x7FFF)<<13;
+                const uint32 exp=shifted_exp&o;
+
+                o+=(127-15)<<23;
+
+                if(exp==shifted_exp)                                            //无穷大或NaN
+                {
+                    o+=(128-16)<<23;
+                }
+                else
+                if(exp==0)                                                      //非规格化数
+                {
+                    float fv,magic;
+
+                    o+=1<<23;
+
+                    memcpy(&fv,&o,4);
+                    memcpy(&magic,&magic_bits,4);
+
+                    fv-=magic;
+
+                    memcpy(&o,&fv,4);
+                }
+
+                o|=uint32(h&0x8000)<<16;
+
+                float result;
+                memcpy(&result,&o,4);
+                return result;
+            }
+
+            inline uint8 HalfUnitToU8(const float f)
+            {
+                if(!(f>0))return 0;             //同时处理NaN
+                if(f>=1)return 255;
+
+                return uint8(f*255.0f+0.5f);
+            }
+
+            void FloatToHalf_Scalar(half_float *dst,const float *src,uint count)
+            {
+                while(count--)
+                    *dst++=half_float(FloatToHalfBits(*src++));
+            }
+
+            void HalfToFloat_Scalar(float *dst,const half_float *src,uint count)
+            {
+                while(count--)
+                    *dst++=HalfBitsToFloat(uint16(*src++));
+            }
+
+            void HalftoU8_Scalar(uint8 *dst,const half_float *src,uint count)
+            {
+                while(count--)
+                    *dst++=HalfUnitToU8(HalfBitsToFloat(uint16(*src++)));
+            }
+
+            /**
+             * 0-255对应的半精度值表
+             */
+            struct U8HalfTable
+            {
+                half_float value[256];
+
+            public:
+
+                U8HalfTable()
+                {
+                    for(uint i=0;i<256;i++)
+                        value[i]=half_float(FloatToHalfBits(float(i)/255.0f));
+                }
+            };//struct U8HalfTable
+
+            const U8HalfTable &GetU8HalfTable()
+            {
+                static const U8HalfTable table;
+
+                return table;
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_F16C void FloatToHalf_F16C(half_float *dst,const float *src,uint count)
+            {
+                while(count>=8)
+                {
+                    const __m128i h=_mm256_cvtps_ph(_mm256_loadu_ps(src),_MM_FROUND_TO_NEAREST_INT);
+
+                    _mm_storeu_si128((__m128i *)dst,h);
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                FloatToHalf_Scalar(dst,src,count);
+            }
+
+            CM2D_TARGET_F16C void HalfToFloat_F16C(float *dst,const half_float *src,uint count)
+            {
+                while(count>=8)
+                {
+                    _mm256_storeu_ps(dst,_mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)src)));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                HalfToFloat_Scalar(dst,src,count);
+            }
+
+            CM2D_TARGET_F16C void HalftoU8_F16C(uint8 *dst,const half_float *src,uint count)
+            {
+                const __m256 zero=_mm256_setzero_ps();
+                const __m256 one=_mm256_set1_ps(1.0f);
+                const __m256 scale=_mm256_set1_ps(255.0f);
+                const __m256 half=_mm256_set1_ps(0.5f);
+
+                while(count>=8)
+                {
+                    __m256 f=_mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)src));
+
+                    //max/min的参数顺序保证NaN得到0
+                    f=_mm256_min_ps(_mm256_max_ps(f,zero),one);
+
+                    const __m256i i=_mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(f,scale),half));
+
+                    const __m128i w=_mm_packs_epi32(_mm256_castsi256_si128(i),_mm256_extractf128_si256(i,1));
+
+                    _mm_storel_epi64((__m128i *)dst,_mm_packus_epi16(w,w));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                HalftoU8_Scalar(dst,src,count);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_HALF_NEON)
+            void FloatToHalf_NEON(half_float *dst,const float *src,uint count)
+            {
+                while(count>=4)
+                {
+                    vst1_u16((uint16 *)dst,vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src))));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                FloatToHalf_Scalar(dst,src,count);
+            }
+
+            void HalfToFloat_NEON(float *dst,const half_float *src,uint count)
+            {
+                while(count>=4)
+                {
+                    vst1q_f32(dst,vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16((const uint16 *)src))));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                HalfToFloat_Scalar(dst,src,count);
+            }
+#endif//CM2D_HALF_NEON
+
+            FloatToHalfFunc SelectFloatToHalf()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.f16c)return FloatToHalf_F16C;
+#elif defined(CM2D_HALF_NEON)
+                if(cf.neon)return FloatToHalf_NEON;
+#endif//
+
+                return FloatToHalf_Scalar;
+            }
+
+            HalfToFloatFunc SelectHalfToFloat()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.f16c)return HalfToFloat_F16C;
+#elif defined(CM2D_HALF_NEON)
+                if(cf.neon)return HalfToFloat_NEON;
+#endif//
+
+                return HalfToFloat_Scalar;
+            }
+
+            HalftoU8Func SelectHalftoU8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.f16c)return HalftoU8_F16C;
+#endif//
+
+                return HalftoU8_Scalar;
+            }
+        }//namespace
+
+        void FloatToHalf(half_float *dst,const float *src,const uint count)
+        {
+            static const FloatToHalfFunc func=SelectFloatToHalf();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void HalfToFloat(float *dst,const half_float *src,const uint count)
+        {
+            static const HalfToFloatFunc func=SelectHalfToFloat();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void U8toHalf(half_float *dst,const uint8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            const half_float *lut=GetU8HalfTable().value;
+
+            for(uint i=0;i<count;i++)
+                dst[i]=lut[src[i]];
+        }
+
+        void HalftoU8(uint8 *dst,const half_float *src,const uint count)
+        {
+            static const HalftoU8Func func=SelectHalftoU8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,301 @@
+#include<hgl/2d/PixelFormat.h>
+#include<hgl/2d/CPUFeature.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * RGB8相关转换
+ *
+ * SSSE3版本以pshufb重排字节。RGB数据每次读写16字节，多出的字节属于后续象素，
+ * 所以循环条件保证这些字节仍在数据范围内，剩余象素由标量版本处理。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        static_assert(sizeof(Vector3u8)==3,"Vector3u8 must be tightly packed");
+        static_assert(sizeof(Vector4u8)==4,"Vector4u8 must be tightly packed");
+
+        namespace
+        {
+            using SwapRB3Func       =void(*)(Vector3u8 *,const Vector3u8 *,uint);
+            using RGB8toRGBA8Func   =void(*)(Vector4u8 *,const Vector3u8 *,uint,const bool,const uint8);
+            using RGBA8toRGB8Func   =void(*)(Vector3u8 *,const Vector4u8 *,uint,const bool);
+
+            void SwapRB3_Scalar(Vector3u8 *dst,const Vector3u8 *src,uint count)
+            {
+                uint8 r;
+
+                while(count--)
+                {
+                    r=src->r;
+
+                    dst->r=src->b;
+                    dst->g=src->g;
+                    dst->b=r;
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            void RGB8toRGBA8_Scalar(Vector4u8 *dst,const Vector3u8 *src,uint count,const bool swap_rb,const uint8 alpha)
+            {
+                const uint ri=swap_rb?2:0;
+                const uint bi=2-ri;
+
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count--)
+                {
+                    dst->r=sp[ri];
+                    dst->g=sp[1];
+                    dst->b=sp[bi];
+                    dst->a=alpha;
+
+                    ++dst;
+                    sp+=3;
+                }
+            }
+
+            void RGBA8toRGB8_Scalar(Vector3u8 *dst,const Vector4u8 *src,uint count,const bool swap_rb)
+            {
+                const uint ri=swap_rb?2:0;
+                const uint bi=2-ri;
+
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count--)
+                {
+                    dst->r=sp[ri];
+                    dst->g=sp[1];
+                    dst->b=sp[bi];
+
+                    ++dst;
+                    sp+=4;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSSE3 void SwapRB3_SSSE3(Vector3u8 *dst,const Vector3u8 *src,uint count)
+            {
+                //每次处理5个象素(15字节)，第16字节原样保留
+                const __m128i mask=_mm_setr_epi8(2,1,0,5,4,3,8,7,6,11,10,9,14,13,12,15);
+
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=6)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)sp);
+
+                    _mm_storeu_si128((__m128i *)dp,_mm_shuffle_epi8(s,mask));
+
+                    dp+=15;
+                    sp+=15;
+                    count-=5;
+                }
+
+                SwapRB3_Scalar((Vector3u8 *)dp,(const Vector3u8 *)sp,count);
+            }
+
+            CM2D_TARGET_SSSE3 void RGB8toRGBA8_SSSE3(Vector4u8 *dst,const Vector3u8 *src,uint count,const bool swap_rb,const uint8 alpha)
+            {
+                const __m128i mask=swap_rb?_mm_setr_epi8(2,1,0,-1,5,4,3,-1,8,7,6,-1,11,10,9,-1)
+                                          :_mm_setr_epi8(0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11,-1);
+                const __m128i va=_mm_set1_epi32(int(uint32(alpha)<<24));
+
+                const uint8 *sp=(const uint8 *)src;
+
+                //每次读入16字节，只使用其中4个象素(12字节)
+                while(count>=6)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)sp);
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_or_si128(_mm_shuffle_epi8(s,mask),va));
+
+                    dst+=4;
+                    sp+=12;
+                    count-=4;
+                }
+
+                RGB8toRGBA8_Scalar(dst,(const Vector3u8 *)sp,count,swap_rb,alpha);
+            }
+
+            CM2D_TARGET_SSSE3 void RGBA8toRGB8_SSSE3(Vector3u8 *dst,const Vector4u8 *src,uint count,const bool swap_rb)
+            {
+                const __m128i mask=swap_rb?_mm_setr_epi8(2,1,0,6,5,4,10,9,8,14,13,12,-1,-1,-1,-1)
+                                          :_mm_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+
+                uint8 *dp=(uint8 *)dst;
+
+                //每次写出16字节，只有前12字节有效，后4字节会被下一次写入覆盖
+                while(count>=6)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+
+                    _mm_storeu_si128((__m128i *)dp,_mm_shuffle_epi8(s,mask));
+
+                    dp+=12;
+                    src+=4;
+                    count-=4;
+                }
+
+                RGBA8toRGB8_Scalar((Vector3u8 *)dp,src,count,swap_rb);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            void SwapRB3_NEON(Vector3u8 *dst,const Vector3u8 *src,uint count)
+            {
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=16)
+                {
+                    uint8x16x3_t s=vld3q_u8(sp);
+
+                    const uint8x16_t r=s.val[0];
+
+                    s.val[0]=s.val[2];
+                    s.val[2]=r;
+
+                    vst3q_u8(dp,s);
+
+                    dp+=48;
+                    sp+=48;
+                    count-=16;
+                }
+
+                SwapRB3_Scalar((Vector3u8 *)dp,(const Vector3u8 *)sp,count);
+            }
+
+            void RGB8toRGBA8_NEON(Vector4u8 *dst,const Vector3u8 *src,uint count,const bool swap_rb,const uint8 alpha)
+            {
+                const uint ri=swap_rb?2:0;
+
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                uint8x16x4_t d;
+
+                d.val[3]=vdupq_n_u8(alpha);
+
+                while(count>=16)
+                {
+                    const uint8x16x3_t s=vld3q_u8(sp);
+
+                    d.val[0]=s.val[ri];
+                    d.val[1]=s.val[1];
+                    d.val[2]=s.val[2-ri];
+
+                    vst4q_u8(dp,d);
+
+                    dp+=64;
+                    sp+=48;
+                    count-=16;
+                }
+
+                RGB8toRGBA8_Scalar((Vector4u8 *)dp,(const Vector3u8 *)sp,count,swap_rb,alpha);
+            }
+
+            void RGBA8toRGB8_NEON(Vector3u8 *dst,const Vector4u8 *src,uint count,const bool swap_rb)
+            {
+                const uint ri=swap_rb?2:0;
+
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                uint8x16x3_t d;
+
+                while(count>=16)
+                {
+                    const uint8x16x4_t s=vld4q_u8(sp);
+
+                    d.val[0]=s.val[ri];
+                    d.val[1]=s.val[1];
+                    d.val[2]=s.val[2-ri];
+
+                    vst3q_u8(dp,d);
+
+                    dp+=48;
+                    sp+=64;
+                    count-=16;
+                }
+
+                RGBA8toRGB8_Scalar((Vector3u8 *)dp,(const Vector4u8 *)sp,count,swap_rb);
+            }
+#endif//CM2D_SIMD_NEON
+
+            SwapRB3Func SelectSwapRB3()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.ssse3)return SwapRB3_SSSE3;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return SwapRB3_NEON;
+#endif//
+
+                return SwapRB3_Scalar;
+            }
+
+            RGB8toRGBA8Func SelectRGB8toRGBA8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.ssse3)return RGB8toRGBA8_SSSE3;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return RGB8toRGBA8_NEON;
+#endif//
+
+                return RGB8toRGBA8_Scalar;
+            }
+
+            RGBA8toRGB8Func SelectRGBA8toRGB8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.ssse3)return RGBA8toRGB8_SSSE3;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return RGBA8toRGB8_NEON;
+#endif//
+
+                return RGBA8toRGB8_Scalar;
+            }
+        }//namespace
+
+        void SwapRB(Vector3u8 *dst,const Vector3u8 *src,const uint count)
+        {
+            static const SwapRB3Func func=SelectSwapRB3();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void RGB8toRGBA8(Vector4u8 *dst,const Vector3u8 *src,const uint count,const bool swap_rb,const uint8 alpha)
+        {
+            static const RGB8toRGBA8Func func=SelectRGB8toRGBA8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count,swap_rb,alpha);
+        }
+
+        void RGBA8toRGB8(Vector3u8 *dst,const Vector4u8 *src,const uint count,const bool swap_rb)
+        {
+            static const RGBA8toRGB8Func func=SelectRGBA8toRGB8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count,swap_rb);
+        }
+    }//namespace bitmap
+}//namespace hgl
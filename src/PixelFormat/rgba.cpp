@@ -0,0 +1,477 @@
+#include<hgl/2d/PixelFormat.h>
+#include<hgl/2d/CPUFeature.h>
+#include<hgl/2d/Blend.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * RGBA8相关转换
+ *
+ * 预乘     c'=(c*a+127)/255
+ * 反预乘   c =min((c'*255+a/2)/a,255)，a为0时结果为0
+ *
+ * 预乘的SIMD版本使用与Blend相同的(x+128+((x+128)>>8))>>8除法。
+ * 反预乘使用按alpha查表的定点倒数，与上面的整数除法结果完全相同。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            using SwapRB4Func       =void(*)(Vector4u8 *,const Vector4u8 *,uint);
+            using RG8toRGBA8Func    =void(*)(Vector4u8 *,const Vector2u8 *,uint);
+            using RGBA8toRG8Func    =void(*)(Vector2u8 *,const Vector4u8 *,uint);
+            using PremultiplyFunc   =void(*)(Vector4u8 *,const Vector4u8 *,uint);
+
+            void SwapRB4_Scalar(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                uint8 r;
+
+                while(count--)
+                {
+                    r=src->r;
+
+                    dst->r=src->b;
+                    dst->g=src->g;
+                    dst->b=r;
+                    dst->a=src->a;
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            void RG8toRGBA8_Scalar(Vector4u8 *dst,const Vector2u8 *src,uint count)
+            {
+                while(count--)
+                {
+                    dst->r=src->r;
+                    dst->g=src->g;
+                    dst->b=0;
+                    dst->a=255;
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            void RGBA8toRG8_Scalar(Vector2u8 *dst,const Vector4u8 *src,uint count)
+            {
+                while(count--)
+                {
+                    dst->r=src->r;
+                    dst->g=src->g;
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            void Premultiply_Scalar(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                uint a;
+
+                while(count--)
+                {
+                    a=src->a;
+
+                    dst->r=DivideBy255(src->r*a);
+                    dst->g=DivideBy255(src->g*a);
+                    dst->b=DivideBy255(src->b*a);
+                    dst->a=a;
+
+                    ++dst;
+                    ++src;
+                }
+            }
+
+            /**
+             * 反预乘倒数表，recip[a]=ceil(255*2^24/a)<br>
+             * (c*recip[a]+2^23)>>24 在c<=255时等于(c*255+a/2)/a
+             */
+            struct UnpremultiplyTable
+            {
+                uint32 recip[256];
+
+            public:
+
+                UnpremultiplyTable()
+                {
+                    recip[0]=0;
+
+                    for(uint a=1;a<256;a++)
+                        recip[a]=uint32(((uint64(255)<<24)+a-1)/a);
+                }
+
+                const uint8 operator()(const uint c,const uint a)const
+                {
+                    const uint32 v=uint32((uint64(c)*recip[a]+(1<<23))>>24);
+
+                    return uint8(v>255?255:v);
+                }
+            };//struct UnpremultiplyTable
+
+            const UnpremultiplyTable &GetUnpremultiplyTable()
+            {
+                static const UnpremultiplyTable table;
+
+                return table;
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 void SwapRB4_SSE2(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                const __m128i ga_mask=_mm_set1_epi32(int(0xFF00FF00));
+                const __m128i c_mask =_mm_set1_epi32(0x000000FF);
+
+                while(count>=4)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+
+                    const __m128i ga=_mm_and_si128(s,ga_mask);
+                    const __m128i r =_mm_slli_epi32(_mm_and_si128(s,c_mask),16);
+                    const __m128i b =_mm_and_si128(_mm_srli_epi32(s,16),c_mask);
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_or_si128(ga,_mm_or_si128(r,b)));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                SwapRB4_Scalar(dst,src,count);
+            }
+
+            CM2D_TARGET_SSSE3 void SwapRB4_SSSE3(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                const __m128i mask=_mm_setr_epi8(2,1,0,3,6,5,4,7,10,9,8,11,14,13,12,15);
+
+                while(count>=8)
+                {
+                    const __m128i s0=_mm_loadu_si128((const __m128i *)(src  ));
+                    const __m128i s1=_mm_loadu_si128((const __m128i *)(src+4));
+
+                    _mm_storeu_si128((__m128i *)(dst  ),_mm_shuffle_epi8(s0,mask));
+                    _mm_storeu_si128((__m128i *)(dst+4),_mm_shuffle_epi8(s1,mask));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                SwapRB4_SSE2(dst,src,count);
+            }
+
+            CM2D_TARGET_SSE2 void RG8toRGBA8_SSE2(Vector4u8 *dst,const Vector2u8 *src,uint count)
+            {
+                //小端序下每个BA对为0x00,0xFF
+                const __m128i ba=_mm_set1_epi16(short(0xFF00));
+
+                while(count>=8)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+
+                    _mm_storeu_si128((__m128i *)(dst  ),_mm_unpacklo_epi16(s,ba));
+                    _mm_storeu_si128((__m128i *)(dst+4),_mm_unpackhi_epi16(s,ba));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                RG8toRGBA8_Scalar(dst,src,count);
+            }
+
+            CM2D_TARGET_SSE2 void RGBA8toRG8_SSE2(Vector2u8 *dst,const Vector4u8 *src,uint count)
+            {
+                while(count>=8)
+                {
+                    //保留低16位并符号扩展，packs_epi32不会改变其位模式
+                    const __m128i s0=_mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(src  )),16),16);
+                    const __m128i s1=_mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(src+4)),16),16);
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_packs_epi32(s0,s1));
+
+                    dst+=8;
+                    src+=8;
+                    count-=8;
+                }
+
+                RGBA8toRG8_Scalar(dst,src,count);
+            }
+
+            CM2D_TARGET_SSE2 inline __m128i DivideBy255_SSE2(__m128i x)
+            {
+                x=_mm_add_epi16(x,_mm_set1_epi16(128));
+
+                return _mm_srli_epi16(_mm_add_epi16(x,_mm_srli_epi16(x,8)),8);
+            }
+
+            /**
+             * 预乘2个象素(每通道16位)，alpha通道乘以255，结果不变
+             */
+            CM2D_TARGET_SSE2 inline __m128i Premultiply2Pixels_SSE2(const __m128i s)
+            {
+                const __m128i alpha_lane=_mm_set_epi16(255,0,0,0,255,0,0,0);
+                const __m128i rgb_mask  =_mm_set_epi16(0,-1,-1,-1,0,-1,-1,-1);
+
+                __m128i a=_mm_shufflehi_epi16(_mm_shufflelo_epi16(s,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+
+                a=_mm_or_si128(_mm_and_si128(a,rgb_mask),alpha_lane);
+
+                return DivideBy255_SSE2(_mm_mullo_epi16(s,a));
+            }
+
+            CM2D_TARGET_SSE2 void Premultiply_SSE2(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                const __m128i zero=_mm_setzero_si128();
+
+                while(count>=4)
+                {
+                    const __m128i s=_mm_loadu_si128((const __m128i *)src);
+
+                    const __m128i lo=Premultiply2Pixels_SSE2(_mm_unpacklo_epi8(s,zero));
+                    const __m128i hi=Premultiply2Pixels_SSE2(_mm_unpackhi_epi8(s,zero));
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_packus_epi16(lo,hi));
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                Premultiply_Scalar(dst,src,count);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            void SwapRB4_NEON(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=16)
+                {
+                    uint8x16x4_t s=vld4q_u8(sp);
+
+                    const uint8x16_t r=s.val[0];
+
+                    s.val[0]=s.val[2];
+                    s.val[2]=r;
+
+                    vst4q_u8(dp,s);
+
+                    dp+=64;
+                    sp+=64;
+                    count-=16;
+                }
+
+                SwapRB4_Scalar((Vector4u8 *)dp,(const Vector4u8 *)sp,count);
+            }
+
+            void RG8toRGBA8_NEON(Vector4u8 *dst,const Vector2u8 *src,uint count)
+            {
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                uint8x16x4_t d;
+
+                d.val[2]=vdupq_n_u8(0);
+                d.val[3]=vdupq_n_u8(255);
+
+                while(count>=16)
+                {
+                    const uint8x16x2_t s=vld2q_u8(sp);
+
+                    d.val[0]=s.val[0];
+                    d.val[1]=s.val[1];
+
+                    vst4q_u8(dp,d);
+
+                    dp+=64;
+                    sp+=32;
+                    count-=16;
+                }
+
+                RG8toRGBA8_Scalar((Vector4u8 *)dp,(const Vector2u8 *)sp,count);
+            }
+
+            void RGBA8toRG8_NEON(Vector2u8 *dst,const Vector4u8 *src,uint count)
+            {
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                uint8x16x2_t d;
+
+                while(count>=16)
+                {
+                    const uint8x16x4_t s=vld4q_u8(sp);
+
+                    d.val[0]=s.val[0];
+                    d.val[1]=s.val[1];
+
+                    vst2q_u8(dp,d);
+
+                    dp+=32;
+                    sp+=64;
+                    count-=16;
+                }
+
+                RGBA8toRG8_Scalar((Vector2u8 *)dp,(const Vector4u8 *)sp,count);
+            }
+
+            inline uint8x8_t DivideBy255_NEON(const uint16x8_t x)
+            {
+                //(x+((x+128)>>8)+128)>>8
+                return vrshrn_n_u16(vrsraq_n_u16(x,x,8),8);
+            }
+
+            void Premultiply_NEON(Vector4u8 *dst,const Vector4u8 *src,uint count)
+            {
+                uint8 *dp=(uint8 *)dst;
+                const uint8 *sp=(const uint8 *)src;
+
+                while(count>=8)
+                {
+                    uint8x8x4_t s=vld4_u8(sp);
+
+                    s.val[0]=DivideBy255_NEON(vmull_u8(s.val[0],s.val[3]));
+                    s.val[1]=DivideBy255_NEON(vmull_u8(s.val[1],s.val[3]));
+                    s.val[2]=DivideBy255_NEON(vmull_u8(s.val[2],s.val[3]));
+
+                    vst4_u8(dp,s);
+
+                    dp+=32;
+                    sp+=32;
+                    count-=8;
+                }
+
+                Premultiply_Scalar((Vector4u8 *)dp,(const Vector4u8 *)sp,count);
+            }
+#endif//CM2D_SIMD_NEON
+
+            SwapRB4Func SelectSwapRB4()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.ssse3)return SwapRB4_SSSE3;
+                if(cf.sse2)return SwapRB4_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return SwapRB4_NEON;
+#endif//
+
+                return SwapRB4_Scalar;
+            }
+
+            RG8toRGBA8Func SelectRG8toRGBA8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.sse2)return RG8toRGBA8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return RG8toRGBA8_NEON;
+#endif//
+
+                return RG8toRGBA8_Scalar;
+            }
+
+            RGBA8toRG8Func SelectRGBA8toRG8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.sse2)return RGBA8toRG8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return RGBA8toRG8_NEON;
+#endif//
+
+                return RGBA8toRG8_Scalar;
+            }
+
+            PremultiplyFunc SelectPremultiply()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.sse2)return Premultiply_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return Premultiply_NEON;
+#endif//
+
+                return Premultiply_Scalar;
+            }
+        }//namespace
+
+        void SwapRB(Vector4u8 *dst,const Vector4u8 *src,const uint count)
+        {
+            static const SwapRB4Func func=SelectSwapRB4();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void RG8toRGBA8(Vector4u8 *dst,const Vector2u8 *src,const uint count)
+        {
+            static const RG8toRGBA8Func func=SelectRG8toRGBA8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void RGBA8toRG8(Vector2u8 *dst,const Vector4u8 *src,const uint count)
+        {
+            static const RGBA8toRG8Func func=SelectRGBA8toRG8();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void PremultiplyRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count)
+        {
+            static const PremultiplyFunc func=SelectPremultiply();
+
+            if(!dst||!src||!count)return;
+
+            func(dst,src,count);
+        }
+
+        void UnpremultiplyRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            const UnpremultiplyTable &table=GetUnpremultiplyTable();
+
+            uint a;
+
+            for(uint i=0;i<count;i++)
+            {
+                a=src->a;
+
+                if(a==255)
+                {
+                    *dst=*src;
+                }
+                else
+                {
+                    dst->r=table(src->r,a);
+                    dst->g=table(src->g,a);
+                    dst->b=table(src->b,a);
+                    dst->a=a;
+                }
+
+                ++dst;
+                ++src;
+            }
+        }
+    }//namespace bitmap
+}//namespace hgl
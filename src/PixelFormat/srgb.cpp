@@ -0,0 +1,160 @@
+#include<hgl/2d/PixelFormat.h>
+#include<math.h>
+
+/**
+ * sRGB与线性空间转换
+ *
+ * 全部使用首次调用时生成的查找表，每个数值只需一次查表。
+ * 浮点到sRGB按4096级量化查表，相邻级之间的误差小于8位精度的一半。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint LINEAR_F32_LUT_SIZE=4096;
+
+            inline float SRGBToLinearFloat(const float c)
+            {
+                return c<=0.04045f?c/12.92f:powf((c+0.055f)/1.055f,2.4f);
+            }
+
+            inline float LinearToSRGBFloat(const float c)
+            {
+                return c<=0.0031308f?c*12.92f:1.055f*powf(c,1.0f/2.4f)-0.055f;
+            }
+
+            inline uint8 UnitToU8(const float f)
+            {
+                if(f<=0)return 0;
+                if(f>=1)return 255;
+
+                return uint8(f*255.0f+0.5f);
+            }
+
+            struct SRGBTable
+            {
+                uint8 to_linear[256];
+                uint8 to_srgb[256];
+                float to_linear_f32[256];
+                uint8 f32_to_srgb[LINEAR_F32_LUT_SIZE];
+
+            public:
+
+                SRGBTable()
+                {
+                    for(uint i=0;i<256;i++)
+                    {
+                        const float f=float(i)/255.0f;
+
+                        to_linear_f32[i]=SRGBToLinearFloat(f);
+                        to_linear[i]=UnitToU8(to_linear_f32[i]);
+                        to_srgb[i]=UnitToU8(LinearToSRGBFloat(f));
+                    }
+
+                    for(uint i=0;i<LINEAR_F32_LUT_SIZE;i++)
+                        f32_to_srgb[i]=UnitToU8(LinearToSRGBFloat(float(i)/float(LINEAR_F32_LUT_SIZE-1)));
+                }
+            };//struct SRGBTable
+
+            const SRGBTable &GetSRGBTable()
+            {
+                static const SRGBTable table;
+
+                return table;
+            }
+
+            void LookupBytes(uint8 *dst,const uint8 *src,uint count,const uint8 *lut)
+            {
+                while(count>=4)
+                {
+                    dst[0]=lut[src[0]];
+                    dst[1]=lut[src[1]];
+                    dst[2]=lut[src[2]];
+                    dst[3]=lut[src[3]];
+
+                    dst+=4;
+                    src+=4;
+                    count-=4;
+                }
+
+                while(count--)
+                    *dst++=lut[*src++];
+            }
+
+            void LookupRGBA(Vector4u8 *dst,const Vector4u8 *src,uint count,const uint8 *lut)
+            {
+                while(count--)
+                {
+                    dst->r=lut[src->r];
+                    dst->g=lut[src->g];
+                    dst->b=lut[src->b];
+                    dst->a=src->a;
+
+                    ++dst;
+                    ++src;
+                }
+            }
+        }//namespace
+
+        void SRGBtoLinear(uint8 *dst,const uint8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            LookupBytes(dst,src,count,GetSRGBTable().to_linear);
+        }
+
+        void LinearToSRGB(uint8 *dst,const uint8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            LookupBytes(dst,src,count,GetSRGBTable().to_srgb);
+        }
+
+        void SRGBtoLinearRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            LookupRGBA(dst,src,count,GetSRGBTable().to_linear);
+        }
+
+        void LinearToSRGBRGBA8(Vector4u8 *dst,const Vector4u8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            LookupRGBA(dst,src,count,GetSRGBTable().to_srgb);
+        }
+
+        void SRGB8toLinearF32(float *dst,const uint8 *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            const float *lut=GetSRGBTable().to_linear_f32;
+
+            for(uint i=0;i<count;i++)
+                dst[i]=lut[src[i]];
+        }
+
+        void LinearF32toSRGB8(uint8 *dst,const float *src,const uint count)
+        {
+            if(!dst||!src||!count)return;
+
+            const uint8 *lut=GetSRGBTable().f32_to_srgb;
+
+            constexpr float scale=float(LINEAR_F32_LUT_SIZE-1);
+
+            float f;
+
+            for(uint i=0;i<count;i++)
+            {
+                f=src[i];
+
+                if(!(f>0))f=0;                  //同时处理NaN
+                else if(f>1)f=1;
+
+                dst[i]=lut[uint(f*scale+0.5f)];
+            }
+        }
+    }//namespace bitmap
+}//namespace hgl
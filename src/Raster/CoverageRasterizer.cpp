@@ -0,0 +1,420 @@
+#include<hgl/2d/CoverageRasterizer.h>
+#include<hgl/math/FastTriangle.h>
+#include<algorithm>
+#include<cmath>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr float CIRCLE_TOLERANCE=0.1f;                              ///<圆转为多边形时允许的最大误差(象素)
+            constexpr int   CIRCLE_MIN_SEGMENTS=8;
+            constexpr int   CIRCLE_MAX_SEGMENTS=2048;
+
+            int GetCircleSegments(const float radius)
+            {
+                if(radius<=CIRCLE_TOLERANCE)
+                    return CIRCLE_MIN_SEGMENTS;
+
+                const int n=int(ceil(HGL_PI/acos(1.0-CIRCLE_TOLERANCE/radius)));
+
+                if(n<CIRCLE_MIN_SEGMENTS)return CIRCLE_MIN_SEGMENTS;
+                if(n>CIRCLE_MAX_SEGMENTS)return CIRCLE_MAX_SEGMENTS;
+
+                return n;
+            }
+        }//namespace
+
+        CoverageRasterizer::CoverageRasterizer()
+        {
+            width=height=0;
+            start_x=start_y=0;
+            last_x=last_y=0;
+            next_edge=0;
+            cur_y=end_y=0;
+        }
+
+        void CoverageRasterizer::Reset(const int w,const int h)
+        {
+            width=(w>0?w:0);
+            height=(h>0?h:0);
+
+            edge_list.clear();
+            active.clear();
+
+            start_x=start_y=0;
+            last_x=last_y=0;
+            next_edge=0;
+            cur_y=end_y=0;
+        }
+
+        void CoverageRasterizer::AddEdge(float x0,float y0,float x1,float y1)
+        {
+            if(y0==y1)return;
+
+            Edge e;
+
+            if(y0<y1)
+            {
+                e.x0=x0;e.y0=y0;
+                e.x1=x1;e.y1=y1;
+                e.dir=1;
+            }
+            else
+            {
+                e.x0=x1;e.y0=y1;
+                e.x1=x0;e.y1=y0;
+                e.dir=-1;
+            }
+
+            edge_list.push_back(e);
+        }
+
+        /**
+         * 将边裁剪到[0,width]x[0,height]内。<br>
+         * 上下超出部分直接丢弃；左右超出部分投影为x=0或x=width上的竖直边，这样其右侧象素的累加结果不变。
+         */
+        void CoverageRasterizer::AddClipEdge(float x0,float y0,float x1,float y1)
+        {
+            if(y0==y1)return;
+
+            const float top=0;
+            const float bottom=float(height);
+
+            if(y0<top&&y1<top)return;
+            if(y0>bottom&&y1>bottom)return;
+
+            //上下裁剪
+            {
+                const float dxdy=(x1-x0)/(y1-y0);
+
+                if(y0<top){x0+=(top-y0)*dxdy;y0=top;}
+                else if(y0>bottom){x0+=(bottom-y0)*dxdy;y0=bottom;}
+
+                if(y1<top){x1+=(top-y1)*dxdy;y1=top;}
+                else if(y1>bottom){x1+=(bottom-y1)*dxdy;y1=bottom;}
+
+                if(y0==y1)return;
+            }
+
+            //左右裁剪，按与x=0、x=width的交点最多分为三段
+            const float left=0;
+            const float right=float(width);
+
+            float xs[4]={x0,0,0,0};
+            float ys[4]={y0,0,0,0};
+            int n=1;
+
+            const float dydx=(x1!=x0)?(y1-y0)/(x1-x0):0;
+
+            if((x0<left&&x1>left)||(x0>left&&x1<left))
+            {
+                xs[n]=left;
+                ys[n]=y0+(left-x0)*dydx;
+                ++n;
+            }
+
+            if((x0<right&&x1>right)||(x0>right&&x1<right))
+            {
+                xs[n]=right;
+                ys[n]=y0+(right-x0)*dydx;
+                ++n;
+            }
+
+            //两个交点要按从起点出发的顺序排列
+            if(n==3&&fabs(xs[2]-x0)<fabs(xs[1]-x0))
+            {
+                std::swap(xs[1],xs[2]);
+                std::swap(ys[1],ys[2]);
+            }
+
+            xs[n]=x1;
+            ys[n]=y1;
+
+            for(int i=0;i<n;i++)
+            {
+                float ax=xs[i],bx=xs[i+1];
+
+                if(ax<left)ax=left;else if(ax>right)ax=right;
+                if(bx<left)bx=left;else if(bx>right)bx=right;
+
+                //两端都在外侧时为竖直边
+                if((xs[i]<=left&&xs[i+1]<=left)
+                 ||(xs[i]>=right&&xs[i+1]>=right))
+                    bx=ax;
+
+                AddEdge(ax,ys[i],bx,ys[i+1]);
+            }
+        }
+
+        void CoverageRasterizer::MoveTo(const float x,const float y)
+        {
+            ClosePath();
+
+            start_x=last_x=x;
+            start_y=last_y=y;
+        }
+
+        void CoverageRasterizer::LineTo(const float x,const float y)
+        {
+            AddClipEdge(last_x,last_y,x,y);
+
+            last_x=x;
+            last_y=y;
+        }
+
+        void CoverageRasterizer::ClosePath()
+        {
+            if(last_x!=start_x||last_y!=start_y)
+                AddClipEdge(last_x,last_y,start_x,start_y);
+
+            last_x=start_x;
+            last_y=start_y;
+        }
+
+        void CoverageRasterizer::AddLine(const float x0,const float y0,const float x1,const float y1)
+        {
+            AddClipEdge(x0,y0,x1,y1);
+        }
+
+        void CoverageRasterizer::AddPolygon(const Vector2f *points,const int count)
+        {
+            if(!points||count<3)return;
+
+            MoveTo(points[0].x,points[0].y);
+
+            for(int i=1;i<count;i++)
+                LineTo(points[i].x,points[i].y);
+
+            ClosePath();
+        }
+
+        void CoverageRasterizer::AddThickLine(const float x0,const float y0,const float x1,const float y1,const float line_width)
+        {
+            const float dx=x1-x0;
+            const float dy=y1-y0;
+            const float len=sqrt(dx*dx+dy*dy);
+
+            if(len<=0||line_width<=0)return;
+
+            const float nx=-dy/len*line_width*0.5f;
+            const float ny= dx/len*line_width*0.5f;
+
+            MoveTo(x0+nx,y0+ny);
+            LineTo(x1+nx,y1+ny);
+            LineTo(x1-nx,y1-ny);
+            LineTo(x0-nx,y0-ny);
+            ClosePath();
+        }
+
+        void CoverageRasterizer::AddCircle(const float cx,const float cy,const float radius,const bool clockwise)
+        {
+            if(radius<=0)return;
+
+            const int n=GetCircleSegments(radius);
+            const double step=(clockwise?2:-2)*HGL_PI/n;
+
+            //内接多边形面积偏小，放大顶点半径使两者面积相等
+            const float r=radius*float(sqrt(fabs(step)/sin(fabs(step))));
+
+            MoveTo(cx+r,cy);
+
+            for(int i=1;i<n;i++)
+                LineTo(cx+r*float(cos(step*i)),
+                       cy+r*float(sin(step*i)));
+
+            ClosePath();
+        }
+
+        void CoverageRasterizer::AddRing(const float cx,const float cy,const float radius,const float line_width)
+        {
+            if(radius<=0||line_width<=0)return;
+
+            const float half=line_width*0.5f;
+
+            AddCircle(cx,cy,radius+half,true);
+
+            if(radius>half)
+                AddCircle(cx,cy,radius-half,false);          //反向环绕抵消，形成中空
+        }
+
+        /**
+         * 将一条边在第y行内的有向面积累加到cells中
+         */
+        void CoverageRasterizer::AccumulateEdge(const Edge &e,const int y)
+        {
+            const float ys=(e.y0>y?e.y0:float(y));
+            const float ye=(e.y1<y+1?e.y1:float(y+1));
+
+            if(ye<=ys)return;
+
+            const float dxdy=(e.x1-e.x0)/(e.y1-e.y0);
+            const float right=float(width);
+
+            //边已裁剪到[0,width]内，这里只处理插值的舍入误差
+            float xs=e.x0+(ys-e.y0)*dxdy;
+            float xe=e.x0+(ye-e.y0)*dxdy;
+
+            if(xs<0)xs=0;else if(xs>right)xs=right;
+            if(xe<0)xe=0;else if(xe>right)xe=right;
+
+            const float d=(ye-ys)*e.dir;
+
+            const float x0=(xs<xe?xs:xe);
+            const float x1=(xs<xe?xe:xs);
+
+            const float x0floor=floor(x0);
+            const int   x0i=int(x0floor);
+            const float x1ceil=ceil(x1);
+            const int   x1i=int(x1ceil);
+
+            float *a=cells.data();
+
+            if(x1i<=x0i+1)
+            {
+                //在同一个象素内
+                const float xmf=0.5f*(xs+xe)-x0floor;
+
+                a[x0i  ]+=d-d*xmf;
+                a[x0i+1]+=d*xmf;
+            }
+            else
+            {
+                const float s=1.0f/(x1-x0);
+                const float x0f=x0-x0floor;
+                const float a0=0.5f*s*(1.0f-x0f)*(1.0f-x0f);
+                const float x1f=x1-x1ceil+1.0f;
+                const float am=0.5f*s*x1f*x1f;
+
+                a[x0i]+=d*a0;
+
+                if(x1i==x0i+2)
+                {
+                    a[x0i+1]+=d*(1.0f-a0-am);
+                }
+                else
+                {
+                    const float a1=s*(1.5f-x0f);
+
+                    a[x0i+1]+=d*(a1-a0);
+
+                    for(int xi=x0i+2;xi<x1i-1;xi++)
+                        a[xi]+=d*s;
+
+                    const float a2=a1+(x1i-x0i-3)*s;
+
+                    a[x1i-1]+=d*(1.0f-a2-am);
+                }
+
+                a[x1i]+=d*am;
+            }
+        }
+
+        bool CoverageRasterizer::BeginSweep()
+        {
+            ClosePath();
+
+            active.clear();
+            next_edge=0;
+
+            if(edge_list.empty()||width<=0||height<=0)
+                return(false);
+
+            std::sort(edge_list.begin(),edge_list.end(),[](const Edge &a,const Edge &b){return a.y0<b.y0;});
+
+            float max_y=0;
+
+            for(const Edge &e:edge_list)
+                if(e.y1>max_y)max_y=e.y1;
+
+            cur_y=int(floor(edge_list[0].y0));
+            end_y=int(ceil(max_y));
+
+            if(cur_y<0)cur_y=0;
+            if(end_y>height)end_y=height;
+
+            cells.assign(width+2,0);
+            coverage.resize(width);
+
+            return(cur_y<end_y);
+        }
+
+        bool CoverageRasterizer::SweepScanline(CoverageSpan &span)
+        {
+            const uint edge_count=uint(edge_list.size());
+
+            while(cur_y<end_y)
+            {
+                const int y=cur_y++;
+
+                while(next_edge<edge_count&&edge_list[next_edge].y0<y+1)
+                    active.push_back(next_edge++);
+
+                int min_x=width+1;
+                int max_x=-1;
+
+                uint keep=0;
+
+                for(uint i=0;i<active.size();i++)
+                {
+                    const Edge &e=edge_list[active[i]];
+
+                    if(e.y1<=y)continue;                                        //已结束的边
+
+                    active[keep++]=active[i];
+
+                    AccumulateEdge(e,y);
+
+                    const int l=int(e.x0<e.x1?e.x0:e.x1);
+                    const int r=int(ceil(e.x0<e.x1?e.x1:e.x0))+1;
+
+                    if(l<min_x)min_x=l;
+                    if(r>max_x)max_x=r;
+                }
+
+                active.resize(keep);
+
+                if(max_x<0)continue;
+
+                if(min_x<0)min_x=0;
+                if(max_x>width+1)max_x=width+1;
+
+                //前缀和即为覆盖率
+                const int last=(max_x<width?max_x:width);
+
+                float acc=0;
+                bool has_coverage=false;
+
+                for(int x=min_x;x<last;x++)
+                {
+                    acc+=cells[x];
+                    cells[x]=0;
+
+                    float c=fabs(acc);
+
+                    if(c>1)c=1;
+
+                    coverage[x-min_x]=uint8(c*255.0f+0.5f);
+
+                    if(coverage[x-min_x])has_coverage=true;
+                }
+
+                for(int x=last;x<=max_x;x++)
+                    cells[x]=0;
+
+                if(!has_coverage||last<=min_x)continue;
+
+                span.y=y;
+                span.x=min_x;
+                span.count=last-min_x;
+                span.coverage=coverage.data();
+
+                return(true);
+            }
+
+            return(false);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,152 @@
+#include<hgl/2d/DirtyRegion.h>
+#include<cstdint>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint64 DIRTY_MERGE_SLACK=4096;                            ///<合并时总是允许多出的面积，使相邻的小矩形(如文字)合成一个
+
+            ClipRect Union(const ClipRect &a,const ClipRect &b)
+            {
+                return ClipRect{a.left  <b.left  ?a.left  :b.left,
+                                a.top   <b.top   ?a.top   :b.top,
+                                a.right >b.right ?a.right :b.right,
+                                a.bottom>b.bottom?a.bottom:b.bottom};
+            }
+
+            /**
+             * 合并后的面积不超过两者面积之和的5/4时认为值得合并
+             */
+            bool ShouldMerge(const ClipRect &a,const ClipRect &b)
+            {
+                const uint64 sum=a.GetArea()+b.GetArea();
+
+                return Union(a,b).GetArea()<=sum+(sum>>2)+DIRTY_MERGE_SLACK;
+            }
+        }//namespace
+
+        void DirtyRegion::SetBounds(const int width,const int height)
+        {
+            bounds=ClipRect{0,0,width,height};
+            use_bounds=true;
+
+            std::vector<ClipRect> old_list;
+
+            old_list.swap(rect_list);
+
+            for(const ClipRect &cr:old_list)
+                Add(cr);
+        }
+
+        const uint64 DirtyRegion::GetArea()const
+        {
+            uint64 area=0;
+
+            for(const ClipRect &cr:rect_list)
+                area+=cr.GetArea();
+
+            return area;
+        }
+
+        const ClipRect DirtyRegion::GetBoundingRect()const
+        {
+            if(rect_list.empty())
+                return ClipRect{0,0,0,0};
+
+            ClipRect result=rect_list[0];
+
+            for(const ClipRect &cr:rect_list)
+                result=Union(result,cr);
+
+            return result;
+        }
+
+        const bool DirtyRegion::Intersects(const ClipRect &cr)const
+        {
+            for(const ClipRect &r:rect_list)
+                if(r.Intersects(cr))
+                    return(true);
+
+            return(false);
+        }
+
+        void DirtyRegion::Add(ClipRect cr)
+        {
+            if(use_bounds)
+            {
+                if(cr.left  <bounds.left  )cr.left  =bounds.left;
+                if(cr.top   <bounds.top   )cr.top   =bounds.top;
+                if(cr.right >bounds.right )cr.right =bounds.right;
+                if(cr.bottom>bounds.bottom)cr.bottom=bounds.bottom;
+            }
+
+            if(cr.IsEmpty())return;
+
+            for(const ClipRect &r:rect_list)
+                if(r.Contains(cr))
+                    return;
+
+            //合并后的矩形变大，可能又可以与之前检查过的矩形合并，所以重复到没有可合并的为止
+            bool merged;
+
+            do
+            {
+                merged=false;
+
+                for(size_t i=0;i<rect_list.size();)
+                {
+                    if(ShouldMerge(rect_list[i],cr))
+                    {
+                        cr=Union(rect_list[i],cr);
+
+                        rect_list[i]=rect_list.back();
+                        rect_list.pop_back();
+                        merged=true;
+                    }
+                    else
+                        ++i;
+                }
+            }while(merged);
+
+            rect_list.push_back(cr);
+
+            while(rect_list.size()>max_rects)
+                MergeCheapestPair();
+        }
+
+        /**
+         * 合并多出面积最小的两个矩形
+         */
+        void DirtyRegion::MergeCheapestPair()
+        {
+            const size_t count=rect_list.size();
+
+            if(count<2)return;
+
+            size_t best_i=0,best_j=1;
+            int64 best_cost=INT64_MAX;
+
+            for(size_t i=0;i<count;i++)
+                for(size_t j=i+1;j<count;j++)
+                {
+                    const int64 cost=int64(Union(rect_list[i],rect_list[j]).GetArea())
+                                    -int64(rect_list[i].GetArea())
+                                    -int64(rect_list[j].GetArea());
+
+                    if(cost<best_cost)
+                    {
+                        best_cost=cost;
+                        best_i=i;
+                        best_j=j;
+                    }
+                }
+
+            rect_list[best_i]=Union(rect_list[best_i],rect_list[best_j]);
+            rect_list[best_j]=rect_list.back();
+            rect_list.pop_back();
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,54 @@
+#include<hgl/2d/GlyphBitmap.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            struct MonoByteRunsTable
+            {
+                MonoByteRuns runs[256];
+
+            public:
+
+                MonoByteRunsTable()
+                {
+                    for(uint v=0;v<256;v++)
+                    {
+                        MonoByteRuns &r=runs[v];
+
+                        r.count=0;
+
+                        uint bit=0;
+
+                        while(bit<8)
+                        {
+                            if(!(v&(0x80>>bit)))
+                            {
+                                ++bit;
+                                continue;
+                            }
+
+                            const uint start=bit;
+
+                            while(bit<8&&(v&(0x80>>bit)))
+                                ++bit;
+
+                            r.start[r.count]=uint8(start);
+                            r.length[r.count]=uint8(bit-start);
+                            ++r.count;
+                        }
+                    }
+                }
+            };//struct MonoByteRunsTable
+        }//namespace
+
+        const MonoByteRuns *GetMonoByteRuns()
+        {
+            static const MonoByteRunsTable table;
+
+            return table.runs;
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,168 @@
+#include<hgl/2d/PolygonRasterizer.h>
+#include<algorithm>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        PolygonRasterizer::PolygonRasterizer()
+        {
+            width=height=0;
+            rule=FillRule::NonZero;
+            next_edge=0;
+            next_span=0;
+            cur_y=end_y=0;
+        }
+
+        void PolygonRasterizer::Reset(const int w,const int h)
+        {
+            width=(w>0?w:0);
+            height=(h>0?h:0);
+
+            edge_list.clear();
+            active.clear();
+            span_list.clear();
+
+            next_edge=0;
+            next_span=0;
+            cur_y=end_y=0;
+        }
+
+        void PolygonRasterizer::AddEdge(const Vector2f &p0,const Vector2f &p1)
+        {
+            if(p0.y==p1.y)return;                                               //水平边不与任何象素中心所在的行相交
+
+            Edge e;
+
+            if(p0.y<p1.y)
+            {
+                e.Set(p0,p1);
+                e.dir=1;
+            }
+            else
+            {
+                e.Set(p1,p0);
+                e.dir=-1;
+            }
+
+            if(e.y_begin>=e.y_end)return;                                       //两端之间没有象素中心
+            if(e.y_end<=0||e.y_begin>=height)return;
+
+            edge_list.push_back(e);
+        }
+
+        void PolygonRasterizer::AddPolygon(const Vector2f *points,const int count)
+        {
+            if(!points||count<3)return;
+
+            for(int i=0;i<count;i++)
+                AddEdge(points[i],points[(i+1)%count]);
+        }
+
+        bool PolygonRasterizer::BeginSweep()
+        {
+            active.clear();
+            span_list.clear();
+            next_edge=0;
+            next_span=0;
+
+            if(edge_list.empty()||width<=0||height<=0)
+                return(false);
+
+            std::sort(edge_list.begin(),edge_list.end(),[](const Edge &a,const Edge &b){return a.y_begin<b.y_begin;});
+
+            int max_y=0;
+
+            for(const Edge &e:edge_list)
+                if(e.y_end>max_y)max_y=e.y_end;
+
+            cur_y=(edge_list[0].y_begin>0?edge_list[0].y_begin:0);
+            end_y=(max_y<height?max_y:height);
+
+            return cur_y<end_y;
+        }
+
+        /**
+         * 计算当前行的象素段，并前进到下一行
+         */
+        bool PolygonRasterizer::ScanRow()
+        {
+            const int y=cur_y;
+
+            //加入从本行开始的边，移除已经结束的边
+            while(next_edge<edge_list.size()&&edge_list[next_edge].y_begin<=y)
+            {
+                if(edge_list[next_edge].y_end>y)
+                    active.push_back(next_edge);
+
+                ++next_edge;
+            }
+
+            size_t n=0;
+
+            for(size_t i=0;i<active.size();i++)
+                if(edge_list[active[i]].y_end>y)
+                    active[n++]=active[i];
+
+            active.resize(n);
+
+            crossings.clear();
+
+            for(const uint index:active)
+            {
+                const Edge &e=edge_list[index];
+
+                crossings.push_back(Crossing{e.GetX(y),e.dir});
+            }
+
+            std::sort(crossings.begin(),crossings.end(),[](const Crossing &a,const Crossing &b){return a.x<b.x;});
+
+            span_list.clear();
+            next_span=0;
+
+            int winding=0;
+            int l,r;
+
+            for(size_t i=0;i+1<crossings.size();i++)
+            {
+                winding+=(rule==FillRule::EvenOdd?1:crossings[i].dir);
+
+                const bool inside=(rule==FillRule::EvenOdd)?(winding&1):(winding!=0);
+
+                if(!inside)continue;
+
+                if(!ScanSpanRange(crossings[i].x,crossings[i+1].x,0,width,&l,&r))
+                    continue;
+
+                //与上一段相接时合并(同一区域被内部的边分开)
+                if(!span_list.empty()&&span_list.back().right==l)
+                    span_list.back().right=r;
+                else
+                    span_list.push_back(ScanSpan{y,l,r});
+            }
+
+            ++cur_y;
+
+            return !span_list.empty();
+        }
+
+        bool PolygonRasterizer::SweepSpan(ScanSpan &span)
+        {
+            while(next_span>=span_list.size())
+            {
+                if(cur_y>=end_y)
+                    return(false);
+
+                if(ScanRow())
+                    break;
+
+                //本行没有象素时跳过没有任何活动边的行
+                if(active.empty()&&next_edge<edge_list.size()&&edge_list[next_edge].y_begin>cur_y)
+                    cur_y=edge_list[next_edge].y_begin;
+            }
+
+            span=span_list[next_span++];
+            return(true);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,270 @@
+#include<hgl/2d/Resample.h>
+#include<hgl/2d/TaskPool.h>
+#include<hgl/2d/CPUFeature.h>
+#include<algorithm>
+#include<type_traits>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * 2x2平均缩小
+ *
+ * 每个目标通道为(a+b+c+d+2)>>2，SIMD实现在16位精度下计算，与标量结果逐位一致。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint BOX2X_MIN_BAND_ROWS=16;
+
+            /**
+             * 由两行源数据生成一行目标数据
+             * @param count 目标象素数量
+             */
+            using Box2xRowFunc=void(*)(uint8 *dst,const uint8 *s0,const uint8 *s1,const uint count,const uint channels);
+
+            template<typename E>
+            void Box2xRow_Scalar(uint8 *dst_data,const uint8 *s0_data,const uint8 *s1_data,const uint count,const uint channels)
+            {
+                using A=typename std::conditional<sizeof(E)==4,uint64,uint32>::type;
+
+                E *dst=(E *)dst_data;
+                const E *s0=(const E *)s0_data;
+                const E *s1=(const E *)s1_data;
+
+                for(uint i=0;i<count;i++)
+                {
+                    for(uint c=0;c<channels;c++)
+                        dst[c]=E((A(s0[c])+s0[c+channels]+s1[c]+s1[c+channels]+2)>>2);
+
+                    dst+=channels;
+                    s0+=channels*2;
+                    s1+=channels*2;
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            /**
+             * 4通道:两行相加后，每个128位中前后两个象素再相加
+             */
+            CM2D_TARGET_SSE2 void Box2xRowRGBA8_SSE2(uint8 *dst,const uint8 *s0,const uint8 *s1,const uint count,const uint channels)
+            {
+                const __m128i zero=_mm_setzero_si128();
+                const __m128i two=_mm_set1_epi16(2);
+
+                uint i=0;
+
+                for(;i+4<=count;i+=4)
+                {
+                    __m128i sum[2];
+
+                    for(uint j=0;j<2;j++)
+                    {
+                        const __m128i a=_mm_loadu_si128((const __m128i *)(s0+j*16));
+                        const __m128i b=_mm_loadu_si128((const __m128i *)(s1+j*16));
+
+                        const __m128i lo=_mm_add_epi16(_mm_unpacklo_epi8(a,zero),_mm_unpacklo_epi8(b,zero));    //p0,p1
+                        const __m128i hi=_mm_add_epi16(_mm_unpackhi_epi8(a,zero),_mm_unpackhi_epi8(b,zero));    //p2,p3
+
+                        const __m128i pl=_mm_add_epi16(lo,_mm_srli_si128(lo,8));
+                        const __m128i ph=_mm_add_epi16(hi,_mm_srli_si128(hi,8));
+
+                        sum[j]=_mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(pl,ph),two),2);
+                    }
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_packus_epi16(sum[0],sum[1]));
+
+                    dst+=16;
+                    s0+=32;
+                    s1+=32;
+                }
+
+                if(i<count)
+                    Box2xRow_Scalar<uint8>(dst,s0,s1,count-i,4);
+            }
+
+            /**
+             * 单通道:偶数字节与奇数字节分别取出后相加
+             */
+            CM2D_TARGET_SSE2 void Box2xRowGrey8_SSE2(uint8 *dst,const uint8 *s0,const uint8 *s1,const uint count,const uint channels)
+            {
+                const __m128i mask=_mm_set1_epi16(0x00FF);
+                const __m128i two=_mm_set1_epi16(2);
+
+                uint i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    __m128i sum[2];
+
+                    for(uint j=0;j<2;j++)
+                    {
+                        const __m128i a=_mm_loadu_si128((const __m128i *)(s0+j*16));
+                        const __m128i b=_mm_loadu_si128((const __m128i *)(s1+j*16));
+
+                        const __m128i even=_mm_add_epi16(_mm_and_si128(a,mask),_mm_and_si128(b,mask));
+                        const __m128i odd =_mm_add_epi16(_mm_srli_epi16(a,8),_mm_srli_epi16(b,8));
+
+                        sum[j]=_mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(even,odd),two),2);
+                    }
+
+                    _mm_storeu_si128((__m128i *)dst,_mm_packus_epi16(sum[0],sum[1]));
+
+                    dst+=16;
+                    s0+=32;
+                    s1+=32;
+                }
+
+                if(i<count)
+                    Box2xRow_Scalar<uint8>(dst,s0,s1,count-i,1);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            void Box2xRowRGBA8_NEON(uint8 *dst,const uint8 *s0,const uint8 *s1,const uint count,const uint channels)
+            {
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const uint8x16x4_t a=vld4q_u8(s0);
+                    const uint8x16x4_t b=vld4q_u8(s1);
+
+                    uint8x8x4_t r;
+
+                    for(uint c=0;c<4;c++)
+                        r.val[c]=vrshrn_n_u16(vpadalq_u8(vpaddlq_u8(a.val[c]),b.val[c]),2);
+
+                    vst4_u8(dst,r);
+
+                    dst+=32;
+                    s0+=64;
+                    s1+=64;
+                }
+
+                if(i<count)
+                    Box2xRow_Scalar<uint8>(dst,s0,s1,count-i,4);
+            }
+
+            void Box2xRowGrey8_NEON(uint8 *dst,const uint8 *s0,const uint8 *s1,const uint count,const uint channels)
+            {
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    vst1_u8(dst,vrshrn_n_u16(vpadalq_u8(vpaddlq_u8(vld1q_u8(s0)),vld1q_u8(s1)),2));
+
+                    dst+=8;
+                    s0+=16;
+                    s1+=16;
+                }
+
+                if(i<count)
+                    Box2xRow_Scalar<uint8>(dst,s0,s1,count-i,1);
+            }
+#endif//CM2D_SIMD_NEON
+
+            Box2xRowFunc SelectBox2xRowRGBA8()
+            {
+#if defined(CM2D_SIMD_X86)
+                if(GetCPUFeature().sse2)return Box2xRowRGBA8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(GetCPUFeature().neon)return Box2xRowRGBA8_NEON;
+#endif//
+
+                return Box2xRow_Scalar<uint8>;
+            }
+
+            Box2xRowFunc SelectBox2xRowGrey8()
+            {
+#if defined(CM2D_SIMD_X86)
+                if(GetCPUFeature().sse2)return Box2xRowGrey8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(GetCPUFeature().neon)return Box2xRowGrey8_NEON;
+#endif//
+
+                return Box2xRow_Scalar<uint8>;
+            }
+
+            Box2xRowFunc GetBox2xRowFunc(const uint channels,const uint channel_bits)
+            {
+                if(channel_bits==16)return Box2xRow_Scalar<uint16>;
+                if(channel_bits==32)return Box2xRow_Scalar<uint32>;
+                if(channel_bits!=8)return(nullptr);
+
+                if(channels==4)
+                {
+                    static const Box2xRowFunc func=SelectBox2xRowRGBA8();
+
+                    return func;
+                }
+
+                if(channels==1)
+                {
+                    static const Box2xRowFunc func=SelectBox2xRowGrey8();
+
+                    return func;
+                }
+
+                return Box2xRow_Scalar<uint8>;
+            }
+        }//namespace
+
+        void DownsampleBox2x(void *dst,uint dst_line_bytes,const void *src,uint src_line_bytes,
+                             const uint dst_width,const uint dst_height,const uint channels,const uint channel_bits,TaskPool *pool)
+        {
+            if(!dst||!src||!dst_width||!dst_height||!channels)
+                return;
+
+            const Box2xRowFunc func=GetBox2xRowFunc(channels,channel_bits);
+
+            if(!func)return;
+
+            const uint pixel_bytes=channels*(channel_bits>>3);
+
+            if(dst_line_bytes<dst_width*pixel_bytes)dst_line_bytes=dst_width*pixel_bytes;
+            if(src_line_bytes<dst_width*2*pixel_bytes)src_line_bytes=dst_width*2*pixel_bytes;
+
+            uint8 *dp=(uint8 *)dst;
+            const uint8 *sp=(const uint8 *)src;
+
+            const auto process=[=](const uint y0,const uint y1)
+            {
+                for(uint y=y0;y<y1;y++)
+                {
+                    const uint8 *s0=sp+size_t(src_line_bytes)*(y*2);
+
+                    func(dp+size_t(dst_line_bytes)*y,s0,s0+src_line_bytes,dst_width,channels);
+                }
+            };
+
+            const uint thread_count=pool?pool->GetThreadCount():1;
+
+            uint band_rows=(dst_height+thread_count*4-1)/(thread_count*4);
+
+            if(band_rows<BOX2X_MIN_BAND_ROWS)
+                band_rows=BOX2X_MIN_BAND_ROWS;
+
+            const uint band_count=(dst_height+band_rows-1)/band_rows;
+
+            if(!pool||band_count<=1)
+            {
+                process(0,dst_height);
+                return;
+            }
+
+            pool->Run(band_count,[&process,band_rows,dst_height](const uint index)
+            {
+                const uint y=index*band_rows;
+
+                process(y,std::min(y+band_rows,dst_height));
+            });
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,699 @@
+#include<hgl/2d/Resample.h>
+#include<hgl/2d/TaskPool.h>
+#include<hgl/2d/CPUFeature.h>
+#include<algorithm>
+#include<limits>
+#include<math.h>
+#include<stdlib.h>
+#include<string.h>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+/**
+ * 可分离滤波缩放
+ *
+ * 权重计算方式与Pillow相同:缩小时滤波器范围按比例扩大，每个目标象素的权重归一化后转为定点数，
+ * 并把舍入误差加到绝对值最大的权重上，保证每组权重之和精确为1<<RESAMPLE_WEIGHT_BITS。
+ *
+ * 每个通道的计算为 clamp((1<<(BITS-1))+Σw*p)>>BITS，先水平后垂直，中间结果与源数据同样精度。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            constexpr uint RESAMPLE_MIN_BAND_ROWS   =16;                        ///<自动分带时每带最少行数
+            constexpr uint RESAMPLE_BANDS_PER_THREAD=4;                         ///<自动分带时每个线程平均分到的行带数
+
+            constexpr int RESAMPLE_ONE  =1<<RESAMPLE_WEIGHT_BITS;
+            constexpr int RESAMPLE_HALF =1<<(RESAMPLE_WEIGHT_BITS-1);
+
+            double BoxFilter(const double x)
+            {
+                return (x>-0.5&&x<=0.5)?1.0:0.0;
+            }
+
+            double TriangleFilter(double x)
+            {
+                if(x<0)x=-x;
+
+                return x<1.0?1.0-x:0.0;
+            }
+
+            double Sinc(double x)
+            {
+                if(x==0.0)return 1.0;
+
+                x*=HGL_PI;
+                return sin(x)/x;
+            }
+
+            double Lanczos3Filter(const double x)
+            {
+                return (x>-3.0&&x<3.0)?Sinc(x)*Sinc(x/3.0):0.0;
+            }
+
+            template<typename E>
+            inline E ClampChannel(int64 v)
+            {
+                if(v<0)return 0;
+
+                v>>=RESAMPLE_WEIGHT_BITS;
+
+                return v>int64(std::numeric_limits<E>::max())?std::numeric_limits<E>::max():E(v);
+            }
+
+            inline uint8 ClampU8(const int v)
+            {
+                if(v<0)return 0;
+
+                const int r=v>>RESAMPLE_WEIGHT_BITS;
+
+                return r>255?255:uint8(r);
+            }
+        }//namespace
+
+        bool ResampleWeights::Compute(const uint src,const uint dst,const ResampleFilter filter)
+        {
+            if(!src||!dst)return(false);
+
+            double (*func)(const double);
+            double support;
+
+            switch(filter)
+            {
+                case ResampleFilter::Box:       func=BoxFilter;     support=0.5;break;
+                case ResampleFilter::Bilinear:  func=TriangleFilter;support=1.0;break;
+                case ResampleFilter::Lanczos3:  func=Lanczos3Filter;support=3.0;break;
+                default:return(false);
+            }
+
+            const double scale=double(src)/double(dst);
+            const double filter_scale=(scale>1.0?scale:1.0);
+
+            support*=filter_scale;
+
+            src_size=src;
+            dst_size=dst;
+            taps=std::min(uint(ceil(support))*2+1,src);
+
+            start.resize(dst);
+            weights.assign(size_t(dst)*taps,0);
+
+            std::vector<double> fw(taps);
+
+            for(uint i=0;i<dst;i++)
+            {
+                const double center=(i+0.5)*scale;
+
+                int first=int(center-support+0.5);
+                int last =int(center+support+0.5);
+
+                if(first<0)first=0;
+                if(last>int(src))last=src;
+
+                int count=last-first;
+
+                if(count>int(taps))count=taps;
+                if(count<1)                                                     //极端比例下保证至少使用一个源象素
+                {
+                    first=std::min(int(center),int(src)-1);
+                    count=1;
+                }
+
+                double total=0;
+
+                for(int k=0;k<count;k++)
+                {
+                    fw[k]=func((first+k-center+0.5)/filter_scale);
+                    total+=fw[k];
+                }
+
+                if(total==0.0)
+                {
+                    fw[0]=1.0;
+                    total=1.0;
+                    count=1;
+                }
+
+                //保证所有目标象素都使用taps个源象素，越过右边界时整体左移
+                int offset=0;
+
+                if(first+int(taps)>int(src))
+                {
+                    offset=first+int(taps)-int(src);
+                    first-=offset;
+                }
+
+                start[i]=first;
+
+                int16 *w=weights.data()+size_t(i)*taps+offset;
+                int sum=0;
+                int max_index=0;
+
+                for(int k=0;k<count;k++)
+                {
+                    w[k]=int16(lround(fw[k]/total*RESAMPLE_ONE));
+                    sum+=w[k];
+
+                    if(abs(w[k])>abs(w[max_index]))
+                        max_index=k;
+                }
+
+                w[max_index]+=int16(RESAMPLE_ONE-sum);
+            }
+
+            return(true);
+        }
+
+        namespace
+        {
+            /**
+             * 水平滤波一行，dst有dst_size个象素
+             */
+            using HorizontalFunc=void(*)(uint8 *dst,const uint8 *src,const ResampleWeights &rw,const uint channels);
+
+            /**
+             * 垂直滤波一行，rows为taps个源行，count为通道值数量
+             */
+            using VerticalFunc=void(*)(uint8 *dst,const uint8 *const *rows,const int16 *w,const uint taps,const uint count);
+
+            template<uint C>
+            void HorizontalU8_Scalar(uint8 *dst,const uint8 *src,const ResampleWeights &rw,const uint)
+            {
+                const int16 *w=rw.weights.data();
+
+                for(uint i=0;i<rw.dst_size;i++)
+                {
+                    const uint8 *s=src+rw.start[i]*C;
+
+                    int acc[C];
+
+                    for(uint c=0;c<C;c++)
+                        acc[c]=RESAMPLE_HALF;
+
+                    for(uint k=0;k<rw.taps;k++)
+                    {
+                        for(uint c=0;c<C;c++)
+                            acc[c]+=w[k]*s[c];
+
+                        s+=C;
+                    }
+
+                    for(uint c=0;c<C;c++)
+                        dst[c]=ClampU8(acc[c]);
+
+                    dst+=C;
+                    w+=rw.taps;
+                }
+            }
+
+            template<typename E>
+            void Horizontal_Generic(uint8 *dst_data,const uint8 *src_data,const ResampleWeights &rw,const uint channels)
+            {
+                E *dst=(E *)dst_data;
+                const E *src=(const E *)src_data;
+                const int16 *w=rw.weights.data();
+
+                for(uint i=0;i<rw.dst_size;i++)
+                {
+                    for(uint c=0;c<channels;c++)
+                    {
+                        const E *s=src+rw.start[i]*channels+c;
+                        int64 acc=RESAMPLE_HALF;
+
+                        for(uint k=0;k<rw.taps;k++)
+                        {
+                            acc+=int64(w[k])*(*s);
+                            s+=channels;
+                        }
+
+                        *dst++=ClampChannel<E>(acc);
+                    }
+
+                    w+=rw.taps;
+                }
+            }
+
+            /**
+             * 垂直滤波一行中[begin,count)范围内的通道值
+             */
+            void VerticalU8_Range(uint8 *dst,const uint8 *const *rows,const int16 *w,const uint taps,const uint begin,const uint count)
+            {
+                for(uint i=begin;i<count;i++)
+                {
+                    int acc=RESAMPLE_HALF;
+
+                    for(uint k=0;k<taps;k++)
+                        acc+=w[k]*rows[k][i];
+
+                    dst[i]=ClampU8(acc);
+                }
+            }
+
+            void VerticalU8_Scalar(uint8 *dst,const uint8 *const *rows,const int16 *w,const uint taps,const uint count)
+            {
+                VerticalU8_Range(dst,rows,w,taps,0,count);
+            }
+
+            template<typename E>
+            void Vertical_Generic(uint8 *dst_data,const uint8 *const *rows,const int16 *w,const uint taps,const uint count)
+            {
+                E *dst=(E *)dst_data;
+
+                for(uint i=0;i<count;i++)
+                {
+                    int64 acc=RESAMPLE_HALF;
+
+                    for(uint k=0;k<taps;k++)
+                        acc+=int64(w[k])*((const E *)rows[k])[i];
+
+                    dst[i]=ClampChannel<E>(acc);
+                }
+            }
+
+#if defined(CM2D_SIMD_X86)
+            /**
+             * 两个int16权重组成madd使用的32位值
+             */
+            CM2D_TARGET_SSE2 inline __m128i WeightPair_SSE2(const int16 w0,const int16 w1)
+            {
+                return _mm_set1_epi32(int(uint32(uint16(w0))|(uint32(uint16(w1))<<16)));
+            }
+
+            /**
+             * RGBA8水平滤波，每次处理两个源象素:[p0c0,p1c0,p0c1,p1c1...]与[w0,w1]*4做madd，得到4个通道的累加值
+             */
+            CM2D_TARGET_SSE2 void HorizontalRGBA8_SSE2(uint8 *dst,const uint8 *src,const ResampleWeights &rw,const uint)
+            {
+                const __m128i zero=_mm_setzero_si128();
+                const int16 *w=rw.weights.data();
+                const uint taps=rw.taps;
+
+                for(uint i=0;i<rw.dst_size;i++)
+                {
+                    const uint8 *s=src+rw.start[i]*4;
+
+                    __m128i acc=_mm_set1_epi32(RESAMPLE_HALF);
+                    uint k=0;
+
+                    for(;k+1<taps;k+=2)
+                    {
+                        const __m128i p=_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(s+k*4)),zero);
+                        const __m128i pp=_mm_unpacklo_epi16(p,_mm_srli_si128(p,8));
+
+                        acc=_mm_add_epi32(acc,_mm_madd_epi16(pp,WeightPair_SSE2(w[k],w[k+1])));
+                    }
+
+                    if(k<taps)
+                    {
+                        int32 last;
+
+                        memcpy(&last,s+k*4,4);
+
+                        const __m128i p=_mm_unpacklo_epi8(_mm_cvtsi32_si128(last),zero);
+
+                        acc=_mm_add_epi32(acc,_mm_madd_epi16(_mm_unpacklo_epi16(p,zero),WeightPair_SSE2(w[k],0)));
+                    }
+
+                    acc=_mm_srai_epi32(acc,RESAMPLE_WEIGHT_BITS);
+                    acc=_mm_packs_epi32(acc,acc);
+                    acc=_mm_packus_epi16(acc,acc);
+
+                    const int32 result=_mm_cvtsi128_si32(acc);
+
+                    memcpy(dst,&result,4);
+
+                    dst+=4;
+                    w+=taps;
+                }
+            }
+
+            /**
+             * 垂直滤波，每次处理16个字节，两行一组与权重对做madd
+             */
+            CM2D_TARGET_SSE2 void VerticalU8_SSE2(uint8 *dst,const uint8 *const *rows,const int16 *w,const uint taps,const uint count)
+            {
+                const __m128i zero=_mm_setzero_si128();
+                const __m128i half=_mm_set1_epi32(RESAMPLE_HALF);
+
+                uint i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    __m128i acc0=half,acc1=half,acc2=half,acc3=half;
+
+                    for(uint k=0;k<taps;k+=2)
+                    {
+                        const __m128i a=_mm_loadu_si128((const __m128i *)(rows[k]+i));
+                        const __m128i b=(k+1<taps)?_mm_loadu_si128((const __m128i *)(rows[k+1]+i)):zero;
+                        const __m128i wp=WeightPair_SSE2(w[k],(k+1<taps)?w[k+1]:0);
+
+                        const __m128i al=_mm_unpacklo_epi8(a,zero);
+                        const __m128i ah=_mm_unpackhi_epi8(a,zero);
+                        const __m128i bl=_mm_unpacklo_epi8(b,zero);
+                        const __m128i bh=_mm_unpackhi_epi8(b,zero);
+
+                        acc0=_mm_add_epi32(acc0,_mm_madd_epi16(_mm_unpacklo_epi16(al,bl),wp));
+                        acc1=_mm_add_epi32(acc1,_mm_madd_epi16(_mm_unpackhi_epi16(al,bl),wp));
+                        acc2=_mm_add_epi32(acc2,_mm_madd_epi16(_mm_unpacklo_epi16(ah,bh),wp));
+                        acc3=_mm_add_epi32(acc3,_mm_madd_epi16(_mm_unpackhi_epi16(ah,bh),wp));
+                    }
+
+                    acc0=_mm_srai_epi32(acc0,RESAMPLE_WEIGHT_BITS);
+                    acc1=_mm_srai_epi32(acc1,RESAMPLE_WEIGHT_BITS);
+                    acc2=_mm_srai_epi32(acc2,RESAMPLE_WEIGHT_BITS);
+                    acc3=_mm_srai_epi32(acc3,RESAMPLE_WEIGHT_BITS);
+
+                    _mm_storeu_si128((__m128i *)(dst+i),_mm_packus_epi16(_mm_packs_epi32(acc0,acc1),_mm_packs_epi32(acc2,acc3)));
+                }
+
+                VerticalU8_Range(dst,rows,w,taps,i,count);
+            }
+
+            CM2D_TARGET_AVX2 inline __m256i WeightPair_AVX2(const int16 w0,const int16 w1)
+            {
+                return _mm256_set1_epi32(int(uint32(uint16(w0))|(uint32(uint16(w1))<<16)));
+            }
+
+            /**
+             * 垂直滤波，每次处理32个字节
+             */
+            CM2D_TARGET_AVX2 void VerticalU8_AVX2(uint8 *dst,const uint8 *const *rows,const int16 *w,const uint taps,const uint count)
+            {
+                const __m256i zero=_mm256_setzero_si256();
+                const __m256i half=_mm256_set1_epi32(RESAMPLE_HALF);
+
+                uint i=0;
+
+                for(;i+32<=count;i+=32)
+                {
+                    __m256i acc0=half,acc1=half,acc2=half,acc3=half;
+
+                    for(uint k=0;k<taps;k+=2)
+                    {
+                        const __m256i a=_mm256_loadu_si256((const __m256i *)(rows[k]+i));
+                        const __m256i b=(k+1<taps)?_mm256_loadu_si256((const __m256i *)(rows[k+1]+i)):zero;
+                        const __m256i wp=WeightPair_AVX2(w[k],(k+1<taps)?w[k+1]:0);
+
+                        //unpack在每个128位通道内进行，pack时也按通道还原，所以顺序自然正确
+                        const __m256i al=_mm256_unpacklo_epi8(a,zero);
+                        const __m256i ah=_mm256_unpackhi_epi8(a,zero);
+                        const __m256i bl=_mm256_unpacklo_epi8(b,zero);
+                        const __m256i bh=_mm256_unpackhi_epi8(b,zero);
+
+                        acc0=_mm256_add_epi32(acc0,_mm256_madd_epi16(_mm256_unpacklo_epi16(al,bl),wp));
+                        acc1=_mm256_add_epi32(acc1,_mm256_madd_epi16(_mm256_unpackhi_epi16(al,bl),wp));
+                        acc2=_mm256_add_epi32(acc2,_mm256_madd_epi16(_mm256_unpacklo_epi16(ah,bh),wp));
+                        acc3=_mm256_add_epi32(acc3,_mm256_madd_epi16(_mm256_unpackhi_epi16(ah,bh),wp));
+                    }
+
+                    acc0=_mm256_srai_epi32(acc0,RESAMPLE_WEIGHT_BITS);
+                    acc1=_mm256_srai_epi32(acc1,RESAMPLE_WEIGHT_BITS);
+                    acc2=_mm256_srai_epi32(acc2,RESAMPLE_WEIGHT_BITS);
+                    acc3=_mm256_srai_epi32(acc3,RESAMPLE_WEIGHT_BITS);
+
+                    _mm256_storeu_si256((__m256i *)(dst+i),_mm256_packus_epi16(_mm256_packs_epi32(acc0,acc1),_mm256_packs_epi32(acc2,acc3)));
+                }
+
+                VerticalU8_Range(dst,rows,w,taps,i,count);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_SIMD_NEON)
+            /**
+             * 垂直滤波，每次处理16个字节
+             */
+            void VerticalU8_NEON(uint8 *dst,const uint8 *const *rows,const int16 *w,const uint taps,const uint count)
+            {
+                const int32x4_t half=vdupq_n_s32(RESAMPLE_HALF);
+
+                uint i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    int32x4_t acc0=half,acc1=half,acc2=half,acc3=half;
+
+                    for(uint k=0;k<taps;k++)
+                    {
+                        const uint8x16_t a=vld1q_u8(rows[k]+i);
+                        const int16x8_t lo=vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(a)));
+                        const int16x8_t hi=vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(a)));
+
+                        acc0=vmlal_n_s16(acc0,vget_low_s16(lo),w[k]);
+                        acc1=vmlal_n_s16(acc1,vget_high_s16(lo),w[k]);
+                        acc2=vmlal_n_s16(acc2,vget_low_s16(hi),w[k]);
+                        acc3=vmlal_n_s16(acc3,vget_high_s16(hi),w[k]);
+                    }
+
+                    const int16x8_t r0=vcombine_s16(vqshrn_n_s32(acc0,RESAMPLE_WEIGHT_BITS),vqshrn_n_s32(acc1,RESAMPLE_WEIGHT_BITS));
+                    const int16x8_t r1=vcombine_s16(vqshrn_n_s32(acc2,RESAMPLE_WEIGHT_BITS),vqshrn_n_s32(acc3,RESAMPLE_WEIGHT_BITS));
+
+                    vst1q_u8(dst+i,vcombine_u8(vqmovun_s16(r0),vqmovun_s16(r1)));
+                }
+
+                VerticalU8_Range(dst,rows,w,taps,i,count);
+            }
+#endif//CM2D_SIMD_NEON
+
+            HorizontalFunc SelectHorizontalRGBA8()
+            {
+#if defined(CM2D_SIMD_X86)
+                if(GetCPUFeature().sse2)return HorizontalRGBA8_SSE2;
+#endif//CM2D_SIMD_X86
+
+                return HorizontalU8_Scalar<4>;
+            }
+
+            VerticalFunc SelectVerticalU8()
+            {
+                const CPUFeature &cf=GetCPUFeature();
+
+#if defined(CM2D_SIMD_X86)
+                if(cf.avx2)return VerticalU8_AVX2;
+                if(cf.sse2)return VerticalU8_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(cf.neon)return VerticalU8_NEON;
+#endif//
+
+                return VerticalU8_Scalar;
+            }
+
+            HorizontalFunc GetHorizontalFunc(const uint channels,const uint channel_bits)
+            {
+                if(channel_bits==16)return Horizontal_Generic<uint16>;
+                if(channel_bits==32)return Horizontal_Generic<uint32>;
+
+                switch(channels)
+                {
+                    case 1:return HorizontalU8_Scalar<1>;
+                    case 2:return HorizontalU8_Scalar<2>;
+                    case 3:return HorizontalU8_Scalar<3>;
+                    case 4:
+                    {
+                        static const HorizontalFunc func=SelectHorizontalRGBA8();
+
+                        return func;
+                    }
+                    default:return nullptr;
+                }
+            }
+
+            VerticalFunc GetVerticalFunc(const uint channel_bits)
+            {
+                if(channel_bits==16)return Vertical_Generic<uint16>;
+                if(channel_bits==32)return Vertical_Generic<uint32>;
+
+                static const VerticalFunc func=SelectVerticalU8();
+
+                return func;
+            }
+
+            struct ResampleJob
+            {
+                const uint8 *src;
+                uint src_line_bytes;
+                uint src_width,src_height;
+
+                uint8 *dst;
+                uint dst_line_bytes;
+                uint dst_width,dst_height;
+
+                uint channels;
+                uint pixel_bytes;
+
+                ResampleWeights hw,vw;
+                bool h_identity,v_identity;                                     ///<该方向尺寸不变，直接使用源数据
+
+                HorizontalFunc horizontal;
+                VerticalFunc vertical;
+
+            public:
+
+                /**
+                 * 处理目标行[y0,y1)，各行带互不依赖
+                 */
+                void Process(const uint y0,const uint y1)const
+                {
+                    if(v_identity)
+                    {
+                        for(uint y=y0;y<y1;y++)
+                        {
+                            if(h_identity)
+                                memcpy(dst+size_t(dst_line_bytes)*y,src+size_t(src_line_bytes)*y,size_t(dst_width)*pixel_bytes);
+                            else
+                                horizontal(dst+size_t(dst_line_bytes)*y,src+size_t(src_line_bytes)*y,hw,channels);
+                        }
+
+                        return;
+                    }
+
+                    //本行带用到的源行
+                    const uint r0=vw.start[y0];
+                    const uint r1=vw.start[y1-1]+vw.taps;
+
+                    const uint8 *rows_base;
+                    size_t rows_pitch;
+                    std::vector<uint8> temp;
+
+                    if(h_identity)
+                    {
+                        rows_base=src+size_t(src_line_bytes)*r0;
+                        rows_pitch=src_line_bytes;
+                    }
+                    else
+                    {
+                        rows_pitch=size_t(dst_width)*pixel_bytes;
+                        temp.resize(rows_pitch*(r1-r0));
+
+                        for(uint r=r0;r<r1;r++)
+                            horizontal(temp.data()+rows_pitch*(r-r0),src+size_t(src_line_bytes)*r,hw,channels);
+
+                        rows_base=temp.data();
+                    }
+
+                    std::vector<const uint8 *> rows(vw.taps);
+
+                    for(uint y=y0;y<y1;y++)
+                    {
+                        const uint first=vw.start[y]-r0;
+
+                        for(uint k=0;k<vw.taps;k++)
+                            rows[k]=rows_base+rows_pitch*(first+k);
+
+                        vertical(dst+size_t(dst_line_bytes)*y,rows.data(),vw.weights.data()+size_t(y)*vw.taps,vw.taps,dst_width*channels);
+                    }
+                }
+            };//struct ResampleJob
+        }//namespace
+
+        bool ResampleBitmap(void *dst,uint dst_width,uint dst_height,uint dst_line_bytes,
+                            const void *src,uint src_width,uint src_height,uint src_line_bytes,
+                            const uint channels,const uint channel_bits,const ResampleOption &option)
+        {
+            if(!dst||!src||!dst_width||!dst_height||!src_width||!src_height)
+                return(false);
+
+            if(channels<1||channels>4)
+                return(false);
+
+            if(channel_bits!=8&&channel_bits!=16&&channel_bits!=32)
+                return(false);
+
+            const uint pixel_bytes=channels*(channel_bits>>3);
+
+            if(dst_line_bytes<dst_width*pixel_bytes)dst_line_bytes=dst_width*pixel_bytes;
+            if(src_line_bytes<src_width*pixel_bytes)src_line_bytes=src_width*pixel_bytes;
+
+            //大比例缩小时先反复缩小一半，之后的滤波只需很少的源象素
+            std::vector<uint8> reduce[2];
+
+            if(option.box_prereduce)
+            {
+                uint cur=0;
+
+                while((src_width>>1)>=dst_width*2&&(src_height>>1)>=dst_height*2)
+                {
+                    const uint w=src_width>>1;
+                    const uint h=src_height>>1;
+
+                    reduce[cur].resize(size_t(w)*h*pixel_bytes);
+
+                    DownsampleBox2x(reduce[cur].data(),w*pixel_bytes,src,src_line_bytes,w,h,channels,channel_bits,option.task_pool);
+
+                    src=reduce[cur].data();
+                    src_width=w;
+                    src_height=h;
+                    src_line_bytes=w*pixel_bytes;
+
+                    cur^=1;
+                }
+            }
+
+            ResampleJob job;
+
+            job.src=(const uint8 *)src;
+            job.src_line_bytes=src_line_bytes;
+            job.src_width=src_width;
+            job.src_height=src_height;
+            job.dst=(uint8 *)dst;
+            job.dst_line_bytes=dst_line_bytes;
+            job.dst_width=dst_width;
+            job.dst_height=dst_height;
+            job.channels=channels;
+            job.pixel_bytes=pixel_bytes;
+            job.h_identity=(src_width==dst_width);
+            job.v_identity=(src_height==dst_height);
+
+            if(!job.h_identity&&!job.hw.Compute(src_width,dst_width,option.filter))return(false);
+            if(!job.v_identity&&!job.vw.Compute(src_height,dst_height,option.filter))return(false);
+
+            job.horizontal=GetHorizontalFunc(channels,channel_bits);
+            job.vertical=GetVerticalFunc(channel_bits);
+
+            if(!job.horizontal||!job.vertical)
+                return(false);
+
+            TaskPool *pool=option.task_pool;
+            const uint thread_count=pool?pool->GetThreadCount():1;
+
+            uint band_rows=option.band_rows;
+
+            if(!band_rows)
+            {
+                const uint band_target=thread_count*RESAMPLE_BANDS_PER_THREAD;
+
+                band_rows=(dst_height+band_target-1)/band_target;
+
+                if(band_rows<RESAMPLE_MIN_BAND_ROWS)
+                    band_rows=RESAMPLE_MIN_BAND_ROWS;
+            }
+
+            if(band_rows>dst_height)
+                band_rows=dst_height;
+
+            const uint band_count=(dst_height+band_rows-1)/band_rows;
+
+            if(pool&&band_count>1)
+            {
+                pool->Run(band_count,[&job,band_rows,dst_height](const uint index)
+                {
+                    const uint y=index*band_rows;
+
+                    job.Process(y,std::min(y+band_rows,dst_height));
+                });
+            }
+            else
+            {
+                job.Process(0,dst_height);
+            }
+
+            return(true);
+        }
+    }//namespace bitmap
+}//namespace hgl
@@ -0,0 +1,67 @@
+#include<hgl/2d/CPUFeature.h>
+
+#if defined(CM2D_SIMD_X86)&&defined(_MSC_VER)
+#include<intrin.h>
+#endif//
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            CPUFeature DetectCPUFeature()
+            {
+                CPUFeature cf;
+
+#if defined(CM2D_SIMD_X86)
+    #if defined(_MSC_VER)
+                int info[4];
+
+                __cpuid(info,0);
+                const int max_id=info[0];
+
+                __cpuid(info,1);
+                cf.sse2=(info[3]&(1<<26))!=0;
+                cf.ssse3=(info[2]&(1<<9))!=0;
+
+                const bool os_xsave=(info[2]&(1<<27))!=0;
+                const bool cpu_avx =(info[2]&(1<<28))!=0;
+                const bool cpu_f16c=(info[2]&(1<<29))!=0;
+
+                if(os_xsave&&cpu_avx)
+                {
+                    const bool os_ymm=(_xgetbv(0)&0x6)==0x6;          //OS保存XMM/YMM寄存器
+
+                    cf.f16c=os_ymm&&cpu_f16c;
+
+                    if(max_id>=7)
+                    {
+                        __cpuidex(info,7,0);
+                        cf.avx2=os_ymm&&(info[1]&(1<<5))!=0;
+                    }
+                }
+    #else
+                __builtin_cpu_init();
+
+                cf.sse2=__builtin_cpu_supports("sse2");
+                cf.ssse3=__builtin_cpu_supports("ssse3");
+                cf.avx2=__builtin_cpu_supports("avx2");
+                cf.f16c=__builtin_cpu_supports("avx")&&__builtin_cpu_supports("f16c");
+    #endif//_MSC_VER
+#elif defined(CM2D_SIMD_NEON)
+                cf.neon=true;                                           //编译器开启NEON即表示目标CPU必然支持
+#endif//
+
+                return cf;
+            }
+        }//namespace
+
+        const CPUFeature &GetCPUFeature()
+        {
+            static const CPUFeature cpu_feature=DetectCPUFeature();
+
+            return cpu_feature;
+        }
+    }//namespace bitmap
+}//namespace hgl
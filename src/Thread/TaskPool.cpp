@@ -0,0 +1,206 @@
+#include<hgl/2d/TaskPool.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace
+        {
+            thread_local bool in_task_pool=false;                              ///<当前线程是否正在执行任务
+
+            std::mutex global_pool_lock;
+            TaskPool *global_pool=nullptr;
+        }//namespace
+
+        TaskPool::TaskPool(uint thread_count)
+        {
+            job=nullptr;
+            remaining=0;
+            generation=0;
+            quit=false;
+
+            if(thread_count==0)
+            {
+                const uint hc=std::thread::hardware_concurrency();
+
+                thread_count=(hc>1)?hc-1:0;
+            }
+
+            for(uint i=0;i<=thread_count;i++)
+                queues.push_back(new WorkQueue);
+
+            for(uint i=1;i<=thread_count;i++)
+                workers.emplace_back(&TaskPool::WorkerProc,this,i);
+        }
+
+        TaskPool::~TaskPool()
+        {
+            {
+                std::lock_guard<std::mutex> lg(state_lock);
+                quit=true;
+            }
+
+            start_cv.notify_all();
+
+            for(std::thread &t:workers)
+                t.join();
+
+            for(WorkQueue *wq:queues)
+                delete wq;
+        }
+
+        /**
+         * 优先从自己队列尾部取任务，否则从其它队列头部窃取
+         */
+        bool TaskPool::PopTask(const uint self,uint &task)
+        {
+            {
+                WorkQueue *wq=queues[self];
+                std::lock_guard<std::mutex> lg(wq->lock);
+
+                if(!wq->tasks.empty())
+                {
+                    task=wq->tasks.back();
+                    wq->tasks.pop_back();
+                    return(true);
+                }
+            }
+
+            const uint count=uint(queues.size());
+
+            for(uint i=1;i<count;i++)
+            {
+                WorkQueue *wq=queues[(self+i)%count];
+                std::lock_guard<std::mutex> lg(wq->lock);
+
+                if(!wq->tasks.empty())
+                {
+                    task=wq->tasks.front();
+                    wq->tasks.pop_front();
+                    return(true);
+                }
+            }
+
+            return(false);
+        }
+
+        void TaskPool::Execute(const uint self)
+        {
+            uint task;
+
+            in_task_pool=true;
+
+            while(PopTask(self,task))
+            {
+                (*job)(task);
+
+                if(--remaining==0)
+                {
+                    std::lock_guard<std::mutex> lg(state_lock);         //保证Run在等待前后都能看到通知
+                    done_cv.notify_all();
+                }
+            }
+
+            in_task_pool=false;
+        }
+
+        void TaskPool::WorkerProc(const uint self)
+        {
+            uint64 seen=0;
+
+            for(;;)
+            {
+                {
+                    std::unique_lock<std::mutex> ul(state_lock);
+
+                    start_cv.wait(ul,[&]{return quit||generation!=seen;});
+
+                    if(quit)return;
+
+                    seen=generation;
+                }
+
+                Execute(self);
+            }
+        }
+
+        void TaskPool::Run(const uint count,const std::function<void(uint)> &func)
+        {
+            if(!count||!func)return;
+
+            if(workers.empty()||count==1||in_task_pool)
+            {
+                for(uint i=0;i<count;i++)
+                    func(i);
+
+                return;
+            }
+
+            std::lock_guard<std::mutex> run_guard(run_lock);
+
+            job=&func;
+            remaining=count;
+
+            //按轮流方式分配到各队列，连续的任务尽量由各线程分别执行
+            const uint queue_count=uint(queues.size());
+
+            for(uint q=0;q<queue_count;q++)
+            {
+                std::lock_guard<std::mutex> lg(queues[q]->lock);
+
+                for(uint i=q;i<count;i+=queue_count)
+                    queues[q]->tasks.push_front(i);
+            }
+
+            {
+                std::lock_guard<std::mutex> lg(state_lock);
+                ++generation;
+            }
+
+            start_cv.notify_all();
+
+            Execute(0);
+
+            std::unique_lock<std::mutex> ul(state_lock);
+
+            done_cv.wait(ul,[&]{return remaining==0;});
+        }
+
+        void InitGlobalTaskPool(const uint thread_count)
+        {
+            CloseGlobalTaskPool();
+
+            if(thread_count==1)return;
+
+            TaskPool *pool=new TaskPool(thread_count?thread_count-1:0);
+
+            if(pool->GetThreadCount()<=1)                                       //单核时不需要任务池
+            {
+                delete pool;
+                return;
+            }
+
+            std::lock_guard<std::mutex> lg(global_pool_lock);
+            global_pool=pool;
+        }
+
+        void CloseGlobalTaskPool()
+        {
+            TaskPool *pool;
+
+            {
+                std::lock_guard<std::mutex> lg(global_pool_lock);
+                pool=global_pool;
+                global_pool=nullptr;
+            }
+
+            delete pool;
+        }
+
+        TaskPool *GetGlobalTaskPool()
+        {
+            std::lock_guard<std::mutex> lg(global_pool_lock);
+            return global_pool;
+        }
+    }//namespace bitmap
+}//namespace hgl
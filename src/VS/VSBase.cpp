@@ -0,0 +1,205 @@
+#include<hgl/2d/VSBase.h>
+#include<cstring>
+
+namespace hgl
+{
+    namespace vs
+    {
+        namespace
+        {
+            /**
+             * 复制一块每行bytes字节的数据
+             */
+            void CopyLines(uint8 *dp,const uint dst_line_bytes,const uint8 *sp,const uint src_line_bytes,const size_t bytes,const int lines)
+            {
+                //整行且两者都没有行尾填充时一次复制
+                if(bytes==src_line_bytes&&bytes==dst_line_bytes)
+                {
+                    memcpy(dp,sp,bytes*lines);
+                    return;
+                }
+
+                for(int y=0;y<lines;y++)
+                {
+                    memcpy(dp,sp,bytes);
+
+                    sp+=src_line_bytes;
+                    dp+=dst_line_bytes;
+                }
+            }
+        }//namespace
+
+        bool CopyRegion(VSData *dst,const VSData *src,const ClipRect &rect)
+        {
+            if(!dst||!src||dst==src)return(false);
+            if(!dst->IsSameFormat(src))return(false);
+
+            ClipRect cr=rect;
+
+            if(cr.left<0)cr.left=0;
+            if(cr.top<0)cr.top=0;
+            if(cr.right>int(src->GetWidth()))cr.right=src->GetWidth();
+            if(cr.bottom>int(src->GetHeight()))cr.bottom=src->GetHeight();
+
+            if(cr.IsEmpty())return(false);
+
+            if(!src->IsPlanar())
+            {
+                CopyLines((uint8 *)dst->GetPointer(cr.left,cr.top),dst->GetLineBytes(),
+                          (const uint8 *)src->GetPointer(cr.left,cr.top),src->GetLineBytes(),
+                          size_t(cr.GetWidth())*src->GetPixelBytes(),cr.GetHeight());
+                return(true);
+            }
+
+            //平面布局逐个平面复制
+            for(uint i=0;i<src->GetColorComponent();i++)
+            {
+                const VSChannel sc=src->GetChannel(i);
+                const VSChannel dc=dst->GetChannel(i);
+
+                CopyLines(dc.GetLine(cr.top)+size_t(cr.left)*dc.pixel_stride,dc.line_bytes,
+                          sc.GetLine(cr.top)+size_t(cr.left)*sc.pixel_stride,sc.line_bytes,
+                          size_t(cr.GetWidth())*sc.pixel_stride,cr.GetHeight());
+            }
+
+            return(true);
+        }
+
+        uint CopyDirtyRegion(VSData *dst,const VSData *src,const DirtyRegion &dirty)
+        {
+            uint count=0;
+
+            const ClipRect *rect=dirty.GetRects();
+
+            for(uint i=0;i<dirty.GetCount();i++)
+                if(CopyRegion(dst,src,rect[i]))
+                    ++count;
+
+            return count;
+        }
+
+        VSBase::VSBase()
+        {
+            width=height=0;
+            history_count=0;
+            frame_count=0;
+        }
+
+        VSBase::~VSBase()
+        {
+            ClearSurface();
+        }
+
+        void VSBase::ClearSurface()
+        {
+            for(VSData *vd:surface_list)
+                delete vd;
+
+            surface_list.clear();
+        }
+
+        bool VSBase::Create(const uint w,const uint h)
+        {
+            if(!w||!h)return(false);
+
+            ClearSurface();
+
+            width=w;
+            height=h;
+
+            dirty.Clear();
+            dirty.SetBounds(w,h);
+            dirty.AddAll();
+
+            for(uint i=0;i<VS_MAX_BUFFER_AGE;i++)
+            {
+                history[i].Clear();
+                history[i].SetBounds(w,h);
+            }
+
+            history_count=0;
+            frame_count=0;
+
+            return(true);
+        }
+
+        int VSBase::AddSurface(const uint cc,const DataFormat *df,const VSLayout layout)
+        {
+            if(!width||!height)
+                return(-1);
+
+            VSData *vd=new VSData;
+
+            if(!vd->Create(width,height,cc,df,layout))
+            {
+                delete vd;
+                return(-1);
+            }
+
+            surface_list.push_back(vd);
+            return int(surface_list.size()-1);
+        }
+
+        int VSBase::AddSurface(VSDataSource *src,const uint cc,const DataFormat df,const VSLayout layout)
+        {
+            if(!src)return(-1);
+
+            VSData *vd=new VSData;
+
+            if(!width||!height||!vd->SetSource(src,width,height,cc,df,layout))
+            {
+                delete vd;
+                delete src;
+                return(-1);
+            }
+
+            surface_list.push_back(vd);
+            return int(surface_list.size()-1);
+        }
+
+        void VSBase::GetDamage(DirtyRegion *damage,const uint age)const
+        {
+            if(!damage)return;
+
+            damage->Clear();
+            damage->SetBounds(width,height);
+
+            if(age==0||age>history_count+1)
+            {
+                damage->AddAll();
+                return;
+            }
+
+            damage->Add(dirty);
+
+            for(uint i=0;i+1<age;i++)
+                damage->Add(history[i]);
+        }
+
+        bool VSBase::Present()
+        {
+            if(dirty.IsEmpty())
+                return(true);
+
+            if(!OnPresent(dirty))
+                return(false);
+
+            EndFrame();
+            return(true);
+        }
+
+        void VSBase::EndFrame()
+        {
+            for(uint i=VS_MAX_BUFFER_AGE-1;i>0;i--)
+                history[i]=history[i-1];
+
+            history[0]=dirty;
+
+            if(history_count<VS_MAX_BUFFER_AGE)
+                ++history_count;
+
+            dirty.Clear();
+            ++frame_count;
+        }
+    }//namespace vs
+}//namespace hgl
@@ -0,0 +1,732 @@
+#include<hgl/2d/VSChannelOp.h>
+#include<hgl/2d/TaskPool.h>
+#include<hgl/2d/CPUFeature.h>
+#include<algorithm>
+#include<cmath>
+#include<cstring>
+#include<limits>
+#include<type_traits>
+
+#if defined(CM2D_SIMD_X86)
+#include<immintrin.h>
+#elif defined(CM2D_SIMD_NEON)
+#include<arm_neon.h>
+#endif//
+
+#if defined(CM2D_SIMD_NEON)&&(defined(__aarch64__)||defined(_M_ARM64))
+    #define CM2D_VS_NEON                                                        //需要vcvtnq/vmaxnmq等AArch64指令
+#endif//
+
+namespace hgl
+{
+    namespace vs
+    {
+        using bitmap::TaskPool;
+        using bitmap::GetCPUFeature;
+
+        namespace
+        {
+            constexpr uint VS_MIN_BAND_ROWS=16;
+
+            /**
+             * 将[0,height)分为若干行带，有任务池时并行处理
+             */
+            template<typename F> void ForEachBand(const uint height,TaskPool *pool,const F &func)
+            {
+                const uint thread_count=pool?pool->GetThreadCount():1;
+
+                uint band_rows=(height+thread_count*4-1)/(thread_count*4);
+
+                if(band_rows<VS_MIN_BAND_ROWS)
+                    band_rows=VS_MIN_BAND_ROWS;
+
+                const uint band_count=(height+band_rows-1)/band_rows;
+
+                if(!pool||band_count<=1)
+                {
+                    func(0,height);
+                    return;
+                }
+
+                pool->Run(band_count,[&func,band_rows,height](const uint index)
+                {
+                    const uint y=index*band_rows;
+
+                    func(y,std::min(y+band_rows,height));
+                });
+            }
+
+            /**
+             * 计算所用的类型，涉及32位整数或F64时使用double，否则使用float
+             */
+            template<typename E> struct IsWide
+            {
+                static constexpr bool value=(sizeof(E)>=4&&!std::is_same<E,float>::value);
+            };
+
+            template<typename D,typename S> using CalcType=typename std::conditional<IsWide<D>::value||IsWide<S>::value,double,float>::type;
+
+            /**
+             * 转换为成份格式，整数格式四舍五入(偶数优先)并饱和，NaN转为最小值
+             */
+            template<typename E,typename F> inline E ToElement(F v)
+            {
+                if constexpr(std::is_floating_point<E>::value)
+                {
+                    return E(v);
+                }
+                else
+                {
+                    const F lo=F(std::numeric_limits<E>::lowest());
+                    const F hi=F(std::numeric_limits<E>::max());
+
+                    v=(v>lo?v:lo);
+                    v=(v<hi?v:hi);
+
+                    return E(std::nearbyint(v));
+                }
+            }
+
+            /**
+             * 转换一行
+             * @param dst_stride,src_stride 相邻象素的字节数
+             */
+            using ConvertRowFunc=void(*)(uint8 *dst,const uint dst_stride,const uint8 *src,const uint src_stride,const uint count,const double scale,const double bias);
+
+            template<typename D,typename S>
+            void ConvertRow_Scalar(uint8 *dst,const uint dst_stride,const uint8 *src,const uint src_stride,const uint count,const double scale,const double bias)
+            {
+                using C=CalcType<D,S>;
+
+                const C s=C(scale);
+                const C b=C(bias);
+
+                for(uint i=0;i<count;i++)
+                {
+                    S v;
+
+                    memcpy(&v,src,sizeof(S));
+
+                    const C r=C(v)*s+b;
+                    const D d=ToElement<D,C>(r);
+
+                    memcpy(dst,&d,sizeof(D));
+
+                    dst+=dst_stride;
+                    src+=src_stride;
+                }
+            }
+
+            template<typename D> ConvertRowFunc GetScalarConvertRow(const DataFormat src)
+            {
+                switch(src)
+                {
+                    case DataFormat::U8:    return ConvertRow_Scalar<D,uint8>;
+                    case DataFormat::U16:   return ConvertRow_Scalar<D,uint16>;
+                    case DataFormat::U32:   return ConvertRow_Scalar<D,uint32>;
+                    case DataFormat::S8:    return ConvertRow_Scalar<D,int8>;
+                    case DataFormat::S16:   return ConvertRow_Scalar<D,int16>;
+                    case DataFormat::S32:   return ConvertRow_Scalar<D,int32>;
+                    case DataFormat::F32:   return ConvertRow_Scalar<D,float>;
+                    case DataFormat::F64:   return ConvertRow_Scalar<D,double>;
+                    default:                return(nullptr);
+                }
+            }
+
+            ConvertRowFunc GetScalarConvertRow(const DataFormat dst,const DataFormat src)
+            {
+                switch(dst)
+                {
+                    case DataFormat::U8:    return GetScalarConvertRow<uint8>(src);
+                    case DataFormat::U16:   return GetScalarConvertRow<uint16>(src);
+                    case DataFormat::U32:   return GetScalarConvertRow<uint32>(src);
+                    case DataFormat::S8:    return GetScalarConvertRow<int8>(src);
+                    case DataFormat::S16:   return GetScalarConvertRow<int16>(src);
+                    case DataFormat::S32:   return GetScalarConvertRow<int32>(src);
+                    case DataFormat::F32:   return GetScalarConvertRow<float>(src);
+                    case DataFormat::F64:   return GetScalarConvertRow<double>(src);
+                    default:                return(nullptr);
+                }
+            }
+
+            /**
+             * 以下SIMD实现只用于连续存放的数据，运算顺序与标量实现相同(先乘后加，先钳位再取整)
+             */
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 inline __m128i FloatToU8Clamp_SSE2(__m128 f)   //结果在[0,255]内的int32
+            {
+                f=_mm_max_ps(f,_mm_setzero_ps());                               //f为NaN时取第二个参数
+                f=_mm_min_ps(f,_mm_set1_ps(255.0f));
+
+                return _mm_cvtps_epi32(f);
+            }
+
+            CM2D_TARGET_SSE2 void ConvertRowF32F32_SSE2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+                const float *sp=(const float *)src;
+
+                const __m128 s=_mm_set1_ps(float(scale));
+                const __m128 b=_mm_set1_ps(float(bias));
+
+                uint i=0;
+
+                for(;i+4<=count;i+=4)
+                    _mm_storeu_ps(dp+i,_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sp+i),s),b));
+
+                if(i<count)
+                    ConvertRow_Scalar<float,float>((uint8 *)(dp+i),4,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+
+            CM2D_TARGET_AVX2 void ConvertRowF32F32_AVX2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+                const float *sp=(const float *)src;
+
+                const __m256 s=_mm256_set1_ps(float(scale));
+                const __m256 b=_mm256_set1_ps(float(bias));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                    _mm256_storeu_ps(dp+i,_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(sp+i),s),b));
+
+                if(i<count)
+                    ConvertRow_Scalar<float,float>((uint8 *)(dp+i),4,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+
+            CM2D_TARGET_SSE2 void ConvertRowU8F32_SSE2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+
+                const __m128i zero=_mm_setzero_si128();
+                const __m128 s=_mm_set1_ps(float(scale));
+                const __m128 b=_mm_set1_ps(float(bias));
+
+                uint i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    const __m128i v=_mm_loadu_si128((const __m128i *)(src+i));
+                    const __m128i lo=_mm_unpacklo_epi8(v,zero);
+                    const __m128i hi=_mm_unpackhi_epi8(v,zero);
+
+                    _mm_storeu_ps(dp+i   ,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo,zero)),s),b));
+                    _mm_storeu_ps(dp+i+ 4,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo,zero)),s),b));
+                    _mm_storeu_ps(dp+i+ 8,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi,zero)),s),b));
+                    _mm_storeu_ps(dp+i+12,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi,zero)),s),b));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<float,uint8>((uint8 *)(dp+i),4,src+i,1,count-i,scale,bias);
+            }
+
+            CM2D_TARGET_SSE2 void ConvertRowF32U8_SSE2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                const float *sp=(const float *)src;
+
+                const __m128 s=_mm_set1_ps(float(scale));
+                const __m128 b=_mm_set1_ps(float(bias));
+
+                uint i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    __m128i r[4];
+
+                    for(uint j=0;j<4;j++)
+                        r[j]=FloatToU8Clamp_SSE2(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sp+i+j*4),s),b));
+
+                    _mm_storeu_si128((__m128i *)(dst+i),_mm_packus_epi16(_mm_packs_epi32(r[0],r[1]),_mm_packs_epi32(r[2],r[3])));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<uint8,float>(dst+i,1,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+
+            CM2D_TARGET_SSE2 void ConvertRowU8U8_SSE2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                const __m128i zero=_mm_setzero_si128();
+                const __m128 s=_mm_set1_ps(float(scale));
+                const __m128 b=_mm_set1_ps(float(bias));
+
+                uint i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    const __m128i v=_mm_loadu_si128((const __m128i *)(src+i));
+                    const __m128i lo=_mm_unpacklo_epi8(v,zero);
+                    const __m128i hi=_mm_unpackhi_epi8(v,zero);
+
+                    const __m128i r0=FloatToU8Clamp_SSE2(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo,zero)),s),b));
+                    const __m128i r1=FloatToU8Clamp_SSE2(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo,zero)),s),b));
+                    const __m128i r2=FloatToU8Clamp_SSE2(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi,zero)),s),b));
+                    const __m128i r3=FloatToU8Clamp_SSE2(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi,zero)),s),b));
+
+                    _mm_storeu_si128((__m128i *)(dst+i),_mm_packus_epi16(_mm_packs_epi32(r0,r1),_mm_packs_epi32(r2,r3)));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<uint8,uint8>(dst+i,1,src+i,1,count-i,scale,bias);
+            }
+
+            CM2D_TARGET_SSE2 void ConvertRowU16F32_SSE2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+                const uint16 *sp=(const uint16 *)src;
+
+                const __m128i zero=_mm_setzero_si128();
+                const __m128 s=_mm_set1_ps(float(scale));
+                const __m128 b=_mm_set1_ps(float(bias));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const __m128i v=_mm_loadu_si128((const __m128i *)(sp+i));
+
+                    _mm_storeu_ps(dp+i  ,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v,zero)),s),b));
+                    _mm_storeu_ps(dp+i+4,_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v,zero)),s),b));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<float,uint16>((uint8 *)(dp+i),4,(const uint8 *)(sp+i),2,count-i,scale,bias);
+            }
+
+            /**
+             * SSE2没有无符号的32位到16位饱和打包，先减去32768按有符号打包，再翻转最高位
+             */
+            CM2D_TARGET_SSE2 void ConvertRowF32U16_SSE2(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                uint16 *dp=(uint16 *)dst;
+                const float *sp=(const float *)src;
+
+                const __m128 s=_mm_set1_ps(float(scale));
+                const __m128 b=_mm_set1_ps(float(bias));
+                const __m128 hi=_mm_set1_ps(65535.0f);
+                const __m128i offset=_mm_set1_epi32(32768);
+                const __m128i sign=_mm_set1_epi16(short(0x8000));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    __m128i r[2];
+
+                    for(uint j=0;j<2;j++)
+                    {
+                        __m128 f=_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sp+i+j*4),s),b);
+
+                        f=_mm_max_ps(f,_mm_setzero_ps());
+                        f=_mm_min_ps(f,hi);
+
+                        r[j]=_mm_sub_epi32(_mm_cvtps_epi32(f),offset);
+                    }
+
+                    _mm_storeu_si128((__m128i *)(dp+i),_mm_xor_si128(_mm_packs_epi32(r[0],r[1]),sign));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<uint16,float>((uint8 *)(dp+i),2,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+#endif//CM2D_SIMD_X86
+
+#if defined(CM2D_VS_NEON)
+            inline uint32x4_t FloatToU8Clamp_NEON(float32x4_t f)               //结果在[0,255]内的uint32
+            {
+                f=vmaxnmq_f32(f,vdupq_n_f32(0));                                //f为NaN时取另一个参数，与标量一致
+                f=vminnmq_f32(f,vdupq_n_f32(255.0f));
+
+                return vcvtnq_u32_f32(f);
+            }
+
+            void ConvertRowF32F32_NEON(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+                const float *sp=(const float *)src;
+
+                const float32x4_t s=vdupq_n_f32(float(scale));
+                const float32x4_t b=vdupq_n_f32(float(bias));
+
+                uint i=0;
+
+                for(;i+4<=count;i+=4)
+                    vst1q_f32(dp+i,vaddq_f32(vmulq_f32(vld1q_f32(sp+i),s),b));
+
+                if(i<count)
+                    ConvertRow_Scalar<float,float>((uint8 *)(dp+i),4,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+
+            void ConvertRowU8F32_NEON(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+
+                const float32x4_t s=vdupq_n_f32(float(scale));
+                const float32x4_t b=vdupq_n_f32(float(bias));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const uint16x8_t v=vmovl_u8(vld1_u8(src+i));
+
+                    vst1q_f32(dp+i  ,vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))),s),b));
+                    vst1q_f32(dp+i+4,vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))),s),b));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<float,uint8>((uint8 *)(dp+i),4,src+i,1,count-i,scale,bias);
+            }
+
+            void ConvertRowF32U8_NEON(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                const float *sp=(const float *)src;
+
+                const float32x4_t s=vdupq_n_f32(float(scale));
+                const float32x4_t b=vdupq_n_f32(float(bias));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const uint32x4_t r0=FloatToU8Clamp_NEON(vaddq_f32(vmulq_f32(vld1q_f32(sp+i  ),s),b));
+                    const uint32x4_t r1=FloatToU8Clamp_NEON(vaddq_f32(vmulq_f32(vld1q_f32(sp+i+4),s),b));
+
+                    vst1_u8(dst+i,vmovn_u16(vcombine_u16(vmovn_u32(r0),vmovn_u32(r1))));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<uint8,float>(dst+i,1,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+
+            void ConvertRowU8U8_NEON(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                const float32x4_t s=vdupq_n_f32(float(scale));
+                const float32x4_t b=vdupq_n_f32(float(bias));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const uint16x8_t v=vmovl_u8(vld1_u8(src+i));
+
+                    const uint32x4_t r0=FloatToU8Clamp_NEON(vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))),s),b));
+                    const uint32x4_t r1=FloatToU8Clamp_NEON(vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))),s),b));
+
+                    vst1_u8(dst+i,vmovn_u16(vcombine_u16(vmovn_u32(r0),vmovn_u32(r1))));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<uint8,uint8>(dst+i,1,src+i,1,count-i,scale,bias);
+            }
+
+            void ConvertRowU16F32_NEON(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                float *dp=(float *)dst;
+                const uint16 *sp=(const uint16 *)src;
+
+                const float32x4_t s=vdupq_n_f32(float(scale));
+                const float32x4_t b=vdupq_n_f32(float(bias));
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const uint16x8_t v=vld1q_u16(sp+i);
+
+                    vst1q_f32(dp+i  ,vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))),s),b));
+                    vst1q_f32(dp+i+4,vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))),s),b));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<float,uint16>((uint8 *)(dp+i),4,(const uint8 *)(sp+i),2,count-i,scale,bias);
+            }
+
+            void ConvertRowF32U16_NEON(uint8 *dst,const uint,const uint8 *src,const uint,const uint count,const double scale,const double bias)
+            {
+                uint16 *dp=(uint16 *)dst;
+                const float *sp=(const float *)src;
+
+                const float32x4_t s=vdupq_n_f32(float(scale));
+                const float32x4_t b=vdupq_n_f32(float(bias));
+                const float32x4_t zero=vdupq_n_f32(0);
+                const float32x4_t hi=vdupq_n_f32(65535.0f);
+
+                uint i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    const float32x4_t f0=vminnmq_f32(vmaxnmq_f32(vaddq_f32(vmulq_f32(vld1q_f32(sp+i  ),s),b),zero),hi);
+                    const float32x4_t f1=vminnmq_f32(vmaxnmq_f32(vaddq_f32(vmulq_f32(vld1q_f32(sp+i+4),s),b),zero),hi);
+
+                    vst1q_u16(dp+i,vcombine_u16(vmovn_u32(vcvtnq_u32_f32(f0)),vmovn_u32(vcvtnq_u32_f32(f1))));
+                }
+
+                if(i<count)
+                    ConvertRow_Scalar<uint16,float>((uint8 *)(dp+i),2,(const uint8 *)(sp+i),4,count-i,scale,bias);
+            }
+#endif//CM2D_VS_NEON
+
+            struct ConvertRowSIMD
+            {
+                ConvertRowFunc f32_f32=nullptr;
+                ConvertRowFunc u8_f32=nullptr;
+                ConvertRowFunc f32_u8=nullptr;
+                ConvertRowFunc u8_u8=nullptr;
+                ConvertRowFunc u16_f32=nullptr;
+                ConvertRowFunc f32_u16=nullptr;
+            };
+
+            ConvertRowSIMD SelectConvertRowSIMD()
+            {
+                ConvertRowSIMD result;
+
+#if defined(CM2D_SIMD_X86)
+                const bitmap::CPUFeature &cf=GetCPUFeature();
+
+                if(cf.sse2)
+                {
+                    result.f32_f32  =ConvertRowF32F32_SSE2;
+                    result.u8_f32   =ConvertRowU8F32_SSE2;
+                    result.f32_u8   =ConvertRowF32U8_SSE2;
+                    result.u8_u8    =ConvertRowU8U8_SSE2;
+                    result.u16_f32  =ConvertRowU16F32_SSE2;
+                    result.f32_u16  =ConvertRowF32U16_SSE2;
+                }
+
+                if(cf.avx2)
+                    result.f32_f32  =ConvertRowF32F32_AVX2;
+#elif defined(CM2D_VS_NEON)
+                if(GetCPUFeature().neon)
+                {
+                    result.f32_f32  =ConvertRowF32F32_NEON;
+                    result.u8_f32   =ConvertRowU8F32_NEON;
+                    result.f32_u8   =ConvertRowF32U8_NEON;
+                    result.u8_u8    =ConvertRowU8U8_NEON;
+                    result.u16_f32  =ConvertRowU16F32_NEON;
+                    result.f32_u16  =ConvertRowF32U16_NEON;
+                }
+#endif//
+
+                return result;
+            }
+
+            /**
+             * 两者都连续存放时优先使用SIMD实现
+             */
+            ConvertRowFunc GetConvertRowFunc(const DataFormat dst,const DataFormat src,const bool continuous)
+            {
+                if(continuous)
+                {
+                    static const ConvertRowSIMD simd=SelectConvertRowSIMD();
+
+                    ConvertRowFunc func=nullptr;
+
+                    if(dst==DataFormat::F32)
+                    {
+                        if(src==DataFormat::F32)func=simd.f32_f32;else
+                        if(src==DataFormat::U8 )func=simd.u8_f32;else
+                        if(src==DataFormat::U16)func=simd.u16_f32;
+                    }
+                    else if(src==DataFormat::F32)
+                    {
+                        if(dst==DataFormat::U8 )func=simd.f32_u8;else
+                        if(dst==DataFormat::U16)func=simd.f32_u16;
+                    }
+                    else if(dst==DataFormat::U8&&src==DataFormat::U8)
+                        func=simd.u8_u8;
+
+                    if(func)
+                        return func;
+                }
+
+                return GetScalarConvertRow(dst,src);
+            }
+
+            /**
+             * 以16字节的重复图案填充，bytes可以不是16的倍数
+             */
+            using FillRowFunc=void(*)(uint8 *dst,const size_t bytes,const uint8 *pattern);
+
+            void FillRow_Scalar(uint8 *dst,const size_t bytes,const uint8 *pattern)
+            {
+                size_t i=0;
+
+                for(;i+16<=bytes;i+=16)
+                    memcpy(dst+i,pattern,16);
+
+                if(i<bytes)
+                    memcpy(dst+i,pattern,bytes-i);
+            }
+
+#if defined(CM2D_SIMD_X86)
+            CM2D_TARGET_SSE2 void FillRow_SSE2(uint8 *dst,const size_t bytes,const uint8 *pattern)
+            {
+                const __m128i v=_mm_loadu_si128((const __m128i *)pattern);
+
+                size_t i=0;
+
+                for(;i+64<=bytes;i+=64)
+                {
+                    _mm_storeu_si128((__m128i *)(dst+i   ),v);
+                    _mm_storeu_si128((__m128i *)(dst+i+16),v);
+                    _mm_storeu_si128((__m128i *)(dst+i+32),v);
+                    _mm_storeu_si128((__m128i *)(dst+i+48),v);
+                }
+
+                for(;i+16<=bytes;i+=16)
+                    _mm_storeu_si128((__m128i *)(dst+i),v);
+
+                if(i<bytes)
+                    memcpy(dst+i,pattern,bytes-i);
+            }
+#elif defined(CM2D_SIMD_NEON)
+            void FillRow_NEON(uint8 *dst,const size_t bytes,const uint8 *pattern)
+            {
+                const uint8x16_t v=vld1q_u8(pattern);
+
+                size_t i=0;
+
+                for(;i+16<=bytes;i+=16)
+                    vst1q_u8(dst+i,v);
+
+                if(i<bytes)
+                    memcpy(dst+i,pattern,bytes-i);
+            }
+#endif//
+
+            FillRowFunc SelectFillRow()
+            {
+#if defined(CM2D_SIMD_X86)
+                if(GetCPUFeature().sse2)return FillRow_SSE2;
+#elif defined(CM2D_SIMD_NEON)
+                if(GetCPUFeature().neon)return FillRow_NEON;
+#endif//
+
+                return FillRow_Scalar;
+            }
+
+            /**
+             * 将填充值转换为成份格式的字节
+             * @return 成份字节数，格式无效时返回0
+             */
+            template<typename E> uint MakeElement(uint8 *out,const double value)
+            {
+                const E e=ToElement<E,double>(value);
+
+                memcpy(out,&e,sizeof(E));
+                return sizeof(E);
+            }
+
+            uint MakeElement(uint8 *out,const DataFormat df,const double value)
+            {
+                switch(df)
+                {
+                    case DataFormat::U8:    return MakeElement<uint8 >(out,value);
+                    case DataFormat::U16:   return MakeElement<uint16>(out,value);
+                    case DataFormat::U32:   return MakeElement<uint32>(out,value);
+                    case DataFormat::S8:    return MakeElement<int8  >(out,value);
+                    case DataFormat::S16:   return MakeElement<int16 >(out,value);
+                    case DataFormat::S32:   return MakeElement<int32 >(out,value);
+                    case DataFormat::F32:   return MakeElement<float >(out,value);
+                    case DataFormat::F64:   return MakeElement<double>(out,value);
+                    default:                return(0);
+                }
+            }
+        }//namespace
+
+        bool FillChannel(const VSChannel &ch,const double value,TaskPool *pool)
+        {
+            if(ch.IsEmpty()||!ch.width||!ch.height)
+                return(false);
+
+            uint8 pattern[16];
+
+            const uint bytes=MakeElement(pattern,ch.format,value);
+
+            if(!bytes)return(false);
+
+            for(uint i=bytes;i<16;i+=bytes)                                     //各格式字节数都能整除16
+                memcpy(pattern+i,pattern,bytes);
+
+            if(ch.IsContinuous())
+            {
+                static const FillRowFunc func=SelectFillRow();
+
+                const size_t row_bytes=size_t(ch.width)*bytes;
+
+                ForEachBand(ch.height,pool,[&](const uint y0,const uint y1)
+                {
+                    for(uint y=y0;y<y1;y++)
+                        func(ch.GetLine(y),row_bytes,pattern);
+                });
+            }
+            else
+            {
+                ForEachBand(ch.height,pool,[&](const uint y0,const uint y1)
+                {
+                    for(uint y=y0;y<y1;y++)
+                    {
+                        uint8 *p=ch.GetLine(y);
+
+                        for(uint x=0;x<ch.width;x++)
+                        {
+                            memcpy(p,pattern,bytes);
+                            p+=ch.pixel_stride;
+                        }
+                    }
+                });
+            }
+
+            return(true);
+        }
+
+        bool ConvertChannel(const VSChannel &dst,const VSChannel &src,const double scale,const double bias,TaskPool *pool)
+        {
+            if(dst.IsEmpty()||src.IsEmpty())
+                return(false);
+
+            if(dst.width!=src.width||dst.height!=src.height||!dst.width||!dst.height)
+                return(false);
+
+            const ConvertRowFunc func=GetConvertRowFunc(dst.format,src.format,dst.IsContinuous()&&src.IsContinuous());
+
+            if(!func)return(false);
+
+            ForEachBand(dst.height,pool,[&](const uint y0,const uint y1)
+            {
+                for(uint y=y0;y<y1;y++)
+                    func(dst.GetLine(y),dst.pixel_stride,src.GetLine(y),src.pixel_stride,dst.width,scale,bias);
+            });
+
+            return(true);
+        }
+
+        bool FillSurface(VSData *vd,const double *value,TaskPool *pool)
+        {
+            if(!vd||!value||!vd->GetColorComponent())
+                return(false);
+
+            for(uint i=0;i<vd->GetColorComponent();i++)
+                if(!FillChannel(vd->GetChannel(i),value[i],pool))
+                    return(false);
+
+            return(true);
+        }
+
+        bool ConvertSurface(VSData *dst,const VSData *src,const double scale,const double bias,TaskPool *pool)
+        {
+            if(!dst||!src||!src->GetColorComponent())
+                return(false);
+
+            if(dst->GetColorComponent()!=src->GetColorComponent())
+                return(false);
+
+            for(uint i=0;i<src->GetColorComponent();i++)
+                if(!ConvertChannel(dst->GetChannel(i),src->GetChannel(i),scale,bias,pool))
+                    return(false);
+
+            return(true);
+        }
+    }//namespace vs
+}//namespace hgl
@@ -0,0 +1,126 @@
+#include<hgl/2d/VSBase.h>
+#include<cstring>
+#include<numeric>
+
+namespace hgl
+{
+    namespace vs
+    {
+        namespace
+        {
+            /**
+             * 将每行字节数对齐到VS_LINE_ALIGN与象素字节数的最小公倍数，使行跨度总是整数个象素
+             * @param bytes 每行实际使用的字节数
+             * @param pixel_bytes 每象素(平面布局时为每个成份)字节数
+             */
+            uint AlignLineBytes(const uint bytes,const uint pixel_bytes)
+            {
+                const uint align=std::lcm(VS_LINE_ALIGN,pixel_bytes);
+
+                return (bytes+align-1)/align*align;
+            }
+        }//namespace
+
+        uint VSData::ComputeLineBytes(const uint w,const uint cc,const DataFormat *df,const VSLayout layout)
+        {
+            if(!w||!df||cc<1||cc>4)
+                return(0);
+
+            uint pb=0;
+            uint total=0;
+
+            for(uint i=0;i<cc;i++)
+            {
+                const uint bytes=GetDataFormatBytes(df[i]);
+
+                if(!bytes)return(0);
+
+                pb+=bytes;
+                total+=AlignLineBytes(w*bytes,bytes);
+            }
+
+            return layout==VSLayout::Planar?total:AlignLineBytes(w*pb,pb);
+        }
+
+        bool VSData::SetSource(VSDataSource *src,const uint w,const uint h,const uint cc,const DataFormat *df,const VSLayout lo)
+        {
+            if(!src||!src->pixel_data||!w||!h||!df||cc<1||cc>4)
+                return(false);
+
+            uint pb=0;
+            uint offset[4];
+            uint plane_lb[4];
+            uint plane_total=0;
+
+            for(uint i=0;i<cc;i++)
+            {
+                const uint bytes=GetDataFormatBytes(df[i]);
+
+                if(!bytes)return(false);
+
+                if(lo==VSLayout::Planar)
+                {
+                    plane_lb[i]=AlignLineBytes(w*bytes,bytes);
+                    offset[i]=plane_total*h;                                    //之前的平面共占plane_total*h字节
+                    plane_total+=plane_lb[i];
+                }
+                else
+                {
+                    offset[i]=pb;
+                }
+
+                pb+=bytes;
+            }
+
+            if(src->line_bytes<(lo==VSLayout::Planar?plane_total:w*pb))
+                return(false);
+
+            if(source!=src)
+                delete source;
+
+            source=src;
+            pixel_data=src->pixel_data;
+            line_bytes=src->line_bytes;
+
+            width=w;
+            height=h;
+            color_component=cc;
+            layout=lo;
+            pixel_bytes=pb;
+
+            for(uint i=0;i<4;i++)
+            {
+                data_format[i]=df[i<cc?i:0];
+                component_offset[i]=(i<cc?offset[i]:0);
+                plane_line_bytes[i]=(i<cc&&lo==VSLayout::Planar)?plane_lb[i]:line_bytes;
+            }
+
+            return(true);
+        }
+
+        bool VSData::Create(const uint w,const uint h,const uint cc,const DataFormat *df,const VSLayout lo)
+        {
+            const uint lb=ComputeLineBytes(w,cc,df,lo);
+
+            if(!lb||!h)return(false);
+
+            VSDataSourceCreate *src=new VSDataSourceCreate(lb,h);
+
+            if(!src->pixel_data)
+            {
+                delete src;
+                return(false);
+            }
+
+            memset(src->pixel_data,0,size_t(lb)*h);
+
+            if(!SetSource(src,w,h,cc,df,lo))
+            {
+                delete src;
+                return(false);
+            }
+
+            return(true);
+        }
+    }//namespace vs
+}//namespace hgl
@@ -0,0 +1,76 @@
+#include"TestCommon.h"
+#include<hgl/2d/AtlasCache.h>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+
+namespace
+{
+    constexpr int PAGE_SIZE=64;
+
+    /**
+     * 可以检查页内ID列表的图集
+     */
+    class TestAtlas:public AtlasCache<uint32,1>
+    {
+    public:
+
+        const size_t GetIDListSize(const uint page)const{return page_list[page]->id_list.size();}
+        const uint GetLiveCount(const uint page)const{return page_list[page]->live_count;}
+    };
+
+    /**
+     * 替换一项时放不下，原有的项必须保留
+     */
+    void TestFailedReplaceKeepsEntry()
+    {
+        TestAtlas atlas;
+
+        CM2D_CHECK(atlas.Init(PAGE_SIZE,PAGE_SIZE,PAGE_SIZE*PAGE_SIZE*sizeof(uint32),0,0));
+        CM2D_CHECK(atlas.Allocate(1,32,32)!=nullptr);
+        CM2D_CHECK(atlas.Allocate(2,32,32)!=nullptr);
+
+        atlas.NewFrame();
+
+        CM2D_CHECK(atlas.Find(1)!=nullptr);                             //唯一的一页在本帧内使用过，不能淘汰
+
+        CM2D_CHECK(atlas.Allocate(1,PAGE_SIZE,PAGE_SIZE)==nullptr);
+        CM2D_CHECK(atlas.Contains(1));
+        CM2D_CHECK(atlas.Contains(2));
+
+        const AtlasEntry *entry=atlas.Find(1);
+
+        CM2D_CHECK(entry&&entry->width==32&&entry->height==32);
+    }
+
+    /**
+     * 在同一页中反复替换，ID列表不能留下过期的重复项
+     */
+    void TestReplaceKeepsIDListExact()
+    {
+        TestAtlas atlas;
+
+        CM2D_CHECK(atlas.Init(PAGE_SIZE,PAGE_SIZE,PAGE_SIZE*PAGE_SIZE*sizeof(uint32),0,0));
+        CM2D_CHECK(atlas.Allocate(1,4,4)!=nullptr);
+
+        for(int i=0;i<16;i++)
+            CM2D_CHECK(atlas.Allocate(2,4,4)!=nullptr);
+
+        CM2D_CHECK(atlas.GetPageCount()==1);
+        CM2D_CHECK(atlas.GetEntryCount()==2);
+        CM2D_CHECK(atlas.GetLiveCount(0)==2);
+        CM2D_CHECK(atlas.GetIDListSize(0)==2);
+
+        CM2D_CHECK(atlas.Remove(2));
+        CM2D_CHECK(atlas.GetIDListSize(0)==1);
+        CM2D_CHECK(atlas.Contains(1));
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestFailedReplaceKeepsEntry();
+    TestReplaceKeepsIDListExact();
+
+    return CM2D_TEST_RESULT();
+}
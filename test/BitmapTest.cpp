@@ -0,0 +1,46 @@
+#include"TestCommon.h"
+#include<hgl/2d/Bitmap.h>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+
+namespace
+{
+    /**
+     * 从下往上存放的位图以新尺寸重新创建，旧内存必须以分配所得的地址释放，新位图从上往下存放
+     */
+    void TestRecreateBottomUp()
+    {
+        BitmapU32 bmp;
+
+        CM2D_CHECK(bmp.Create(16,16));
+
+        bmp.SetBottomUp(true);
+        CM2D_CHECK(bmp.IsBottomUp());
+
+        CM2D_CHECK(bmp.Create(32,32));
+        CM2D_CHECK(!bmp.IsBottomUp());
+        CM2D_CHECK(bmp.GetWidth()==32&&bmp.GetHeight()==32);
+        CM2D_CHECK(bmp.GetLinePixels()==32);
+        CM2D_CHECK(bmp.GetData(0,0)==bmp.GetMemory());
+
+        bmp.ClearColor(0x12345678);
+        CM2D_CHECK(*bmp.GetData(31,31)==0x12345678);
+
+        bmp.SetBottomUp(true);
+        CM2D_CHECK(bmp.Create(32,32));                                  //同尺寸重新创建只改回从上往下
+        CM2D_CHECK(!bmp.IsBottomUp());
+        CM2D_CHECK(bmp.GetData(0,0)==bmp.GetMemory());
+
+        bmp.SetBottomUp(true);
+        bmp.Clear();
+        CM2D_CHECK(bmp.GetMemory()==nullptr);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestRecreateBottomUp();
+
+    return CM2D_TEST_RESULT();
+}
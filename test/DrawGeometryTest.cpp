@@ -0,0 +1,134 @@
+#include"TestCommon.h"
+#include<hgl/math/FastTriangle.h>
+
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace test
+        {
+            int bad_angle_count=0;                                              ///<传给查表三角函数的越界角度次数
+        }//namespace test
+
+        /**
+         * 在DrawGeometry之前声明，绘制代码中的Lcos/Lsin会先找到这里，检查角度后再转到查表函数
+         */
+        inline double Lcos(const int angle)
+        {
+            if(angle<0||angle>=360)++test::bad_angle_count;
+
+            return hgl::Lcos(angle);
+        }
+
+        inline double Lsin(const int angle)
+        {
+            if(angle<0||angle>=360)++test::bad_angle_count;
+
+            return hgl::Lsin(angle);
+        }
+    }//namespace bitmap
+}//namespace hgl
+
+#include<hgl/2d/DrawGeometry.h>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+
+namespace
+{
+    using DrawU32=DrawGeometry<uint32,BitmapU32,BlendPolicyOpaque<uint32>>;
+
+    constexpr int SECTOR_SIZE   =64;
+    constexpr int SECTOR_RADIUS =28;
+
+    bool SameBitmap(const BitmapU32 &a,const BitmapU32 &b)
+    {
+        for(int y=0;y<SECTOR_SIZE;y++)
+            for(int x=0;x<SECTOR_SIZE;x++)
+                if(*a.GetData(x,y)!=*b.GetData(x,y))
+                    return(false);
+
+        return(true);
+    }
+
+    /**
+     * 绘制一个扇形到新建的位图
+     * @param full 为true时绘制整圆
+     */
+    void DrawSector(BitmapU32 &bmp,const uint stangle,const uint endangle,const bool full=false)
+    {
+        bmp.Create(SECTOR_SIZE,SECTOR_SIZE);
+        bmp.ClearColor(0);
+
+        DrawU32 dg(&bmp);
+
+        dg.SetDrawColor(0xFFFFFFFF);
+
+        if(full)
+            dg.DrawSolidCircle(SECTOR_SIZE/2,SECTOR_SIZE/2,SECTOR_RADIUS);
+        else
+            dg.DrawSolidSector(SECTOR_SIZE/2,SECTOR_SIZE/2,SECTOR_RADIUS,stangle,endangle);
+    }
+
+    /**
+     * 角度超过360时扫过的角度应由化简前的起止角度求得
+     */
+    void TestSolidSectorAbove360()
+    {
+        BitmapU32 reduced,unreduced,circle;
+
+        DrawSector(circle,0,0,true);
+
+        DrawSector(reduced,66,265);
+        DrawSector(unreduced,426,625);                                  //199度，而不是整圆
+
+        CM2D_CHECK(SameBitmap(reduced,unreduced));
+        CM2D_CHECK(!SameBitmap(unreduced,circle));
+
+        DrawSector(reduced,340,390);                                    //跨过0度
+        DrawSector(unreduced,700,30);
+
+        CM2D_CHECK(SameBitmap(reduced,unreduced));
+
+        DrawSector(unreduced,400,800);                                  //超过360度时为整圆
+
+        CM2D_CHECK(SameBitmap(unreduced,circle));
+
+        for(uint st=0;st<720;st+=7)                                     //任何起止角度都不能让越界角度进入查表
+            for(uint ed=0;ed<1080;ed+=11)
+                DrawSector(unreduced,st,ed);
+
+        CM2D_CHECK(test::bad_angle_count==0);
+    }
+
+    /**
+     * 半径为0的扇形不能写到记入脏区域的包围盒之外
+     */
+    void TestSectorZeroRadius()
+    {
+        BitmapU32 bmp;
+
+        bmp.Create(SECTOR_SIZE,SECTOR_SIZE);
+        bmp.ClearColor(0);
+
+        DrawU32 dg(&bmp);
+
+        dg.SetDrawColor(0xFFFFFFFF);
+
+        for(uint st=0;st<360;st+=45)
+            dg.DrawSector(SECTOR_SIZE/2,SECTOR_SIZE/2,0,st,(st+90)%360);
+
+        for(int y=0;y<SECTOR_SIZE;y++)
+            for(int x=0;x<SECTOR_SIZE;x++)
+                if(x!=SECTOR_SIZE/2||y!=SECTOR_SIZE/2)
+                    CM2D_CHECK(*bmp.GetData(x,y)==0);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestSolidSectorAbove360();
+    TestSectorZeroRadius();
+
+    return CM2D_TEST_RESULT();
+}
@@ -0,0 +1,55 @@
+#include"TestCommon.h"
+#include<hgl/2d/ImageCodec.h>
+#include<hgl/2d/QOI.h>
+#include<hgl/io/MemoryInputStream.h>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+using namespace hgl::imgfmt;
+
+namespace
+{
+    /**
+     * 不能Peek且每次最多只返回一个字节的流，模拟管道、网络等读取方式
+     */
+    class ShortReadInputStream:public io::MemoryInputStream
+    {
+    public:
+
+        int64 Read(void *buf,int64 size) override
+        {
+            return io::MemoryInputStream::Read(buf,size>1?1:size);
+        }
+
+        bool CanPeek()const override{return false;}
+    };//class ShortReadInputStream
+
+    /**
+     * 流每次只返回一部分数据时，识别格式也必须读到完整的文件头
+     */
+    void TestDetectWithShortReads()
+    {
+        const uint8 qoi[QOI_HEADER_SIZE]={'q','o','i','f', 0,0,0,2, 0,0,0,3, 4,QOI_SRGB};
+
+        ShortReadInputStream is;
+
+        is.Link(qoi,sizeof(qoi));
+
+        const ImageCodec *codec=DetectImageCodec(&is);
+
+        CM2D_CHECK(codec!=nullptr);
+        CM2D_CHECK(codec&&codec==GetImageCodec("qoi"));
+
+        ImageInfo info;
+
+        CM2D_CHECK(ProbeImage(&is,&info));                              //识别后读取位置不变，可以再次读取
+        CM2D_CHECK(info.width==2&&info.height==3&&info.channels==4);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestDetectWithShortReads();
+
+    return CM2D_TEST_RESULT();
+}
@@ -0,0 +1,171 @@
+#include"TestCommon.h"
+#include<hgl/2d/MappedBitmap.h>
+#include<hgl/2d/BitmapLoad.h>
+#include<hgl/2d/TGA.h>
+#include<filesystem>
+#include<stdio.h>
+#include<string.h>
+#include<vector>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+using namespace hgl::imgfmt;
+
+namespace
+{
+    constexpr uint FIXTURE_WIDTH        =2;
+    constexpr uint FIXTURE_HEIGHT       =2;
+    constexpr uint FIXTURE_PALETTE_SIZE =8;                             ///<15位调色板按(8*15+7)/8计为15字节，实际为16字节
+
+    /**
+     * 生成带15/16位调色板的TGA文件数据，从上往下存放，调色板各项的最高位都为0
+     * @param image_type 图片类型
+     * @param bit 每象素位数
+     * @param pixels 象素数据
+     * @param color_map_size 调色板每项位数(15/16)
+     * @param alpha_depth 文件头描述的alpha位数
+     */
+    std::vector<uint8> MakeTGAWithColorMap(const uint8 image_type,const uint8 bit,const std::vector<uint8> &pixels,const uint8 color_map_size=15,const uint alpha_depth=0)
+    {
+        TGAHeader header;
+
+        memset(&header,0,sizeof(TGAHeader));
+
+        header.color_map_type   =1;
+        header.image_type       =image_type;
+        header.color_map_length =FIXTURE_PALETTE_SIZE;
+        header.color_map_size   =color_map_size;
+        header.width            =FIXTURE_WIDTH;
+        header.height           =FIXTURE_HEIGHT;
+        header.bit              =bit;
+
+        TGAImageDesc desc;
+
+        desc.image_desc=0;
+        desc.direction=TGA_DIRECTION_UPPER_LEFT;
+        desc.alpha_depth=alpha_depth;
+        header.image_desc=desc.image_desc;
+
+        std::vector<uint8> tga((const uint8 *)&header,(const uint8 *)&header+TGAHeaderSize);
+
+        for(uint i=0;i<FIXTURE_PALETTE_SIZE;i++)                        //第i项为(r,g,b)=(i,0,31-i)，每项2字节
+        {
+            const uint16 c=uint16((i<<10)|(31-i));
+
+            tga.push_back(uint8(c));
+            tga.push_back(uint8(c>>8));
+        }
+
+        tga.insert(tga.end(),pixels.begin(),pixels.end());
+        return tga;
+    }
+
+    /**
+     * 将TGA文件数据写入临时文件后以流方式载入
+     */
+    template<typename T>
+    bool LoadTGAFixture(const std::vector<uint8> &tga,T *bmp)
+    {
+        const std::filesystem::path path=std::filesystem::temp_directory_path()/"cm2d_test_colormap.tga";
+
+        FILE *fp=fopen(path.string().c_str(),"wb");
+
+        if(!fp)return(false);
+
+        const bool written=(fwrite(tga.data(),1,tga.size(),fp)==tga.size());
+
+        fclose(fp);
+
+        const bool result=written&&LoadBitmapFromTGA(OSString(path.c_str()),bmp);
+
+        std::filesystem::remove(path);
+        return result;
+    }
+
+    /**
+     * 带15位调色板的真彩色文件，映射得到的象素数据必须从调色板之后开始
+     */
+    void TestMappedSkips15BitColorMap()
+    {
+        const std::vector<uint8> pixels={ 1, 2, 3,   4, 5, 6,
+                                          7, 8, 9,  10,11,12};
+
+        const std::vector<uint8> tga=MakeTGAWithColorMap(TGA_IMAGE_TYPE_TRUE_COLOR,24,pixels);
+
+        CM2D_CHECK(GetTGAColorMapBytes((const TGAHeader *)tga.data())==FIXTURE_PALETTE_SIZE*2);
+
+        uint w=0,h=0;
+        bool bottom_up=true;
+
+        const uint8 *p=(const uint8 *)GetTGAPixelData(tga.data(),tga.size(),24,w,h,&bottom_up);
+
+        CM2D_CHECK(p!=nullptr);
+        CM2D_CHECK(w==FIXTURE_WIDTH&&h==FIXTURE_HEIGHT);
+        CM2D_CHECK(!bottom_up);
+
+        if(p)
+            CM2D_CHECK(memcmp(p,pixels.data(),pixels.size())==0);
+    }
+
+    /**
+     * 使用15位调色板的索引图片，经流方式载入后每个象素都应展开为对应的调色板项
+     */
+    void TestStreamLoad15BitColorMap()
+    {
+        const std::vector<uint8> index={0,3,
+                                        5,7};
+
+        const std::vector<uint8> tga=MakeTGAWithColorMap(TGA_IMAGE_TYPE_COLOR_MAP,8,index);
+
+        BitmapRGB8 bmp;
+
+        CM2D_CHECK(LoadTGAFixture(tga,&bmp));
+
+        CM2D_CHECK(bmp.GetWidth()==FIXTURE_WIDTH&&bmp.GetHeight()==FIXTURE_HEIGHT);
+
+        if(bmp.IsEmpty())return;
+
+        for(uint y=0;y<FIXTURE_HEIGHT;y++)
+            for(uint x=0;x<FIXTURE_WIDTH;x++)
+            {
+                const uint i=index[y*FIXTURE_WIDTH+x];
+                const Vector3u8 &p=*bmp.GetData(x,y);                   //TGA的BGR字节顺序
+
+                CM2D_CHECK(p[0]==uint8((31-i)*255/31));
+                CM2D_CHECK(p[1]==0);
+                CM2D_CHECK(p[2]==uint8(i*255/31));
+            }
+    }
+
+    /**
+     * 16位调色板项的最高位只在文件头描述了alpha位数时才作为alpha
+     */
+    void TestStreamLoad16BitColorMapAlpha()
+    {
+        const std::vector<uint8> index={0,1,
+                                        2,3};
+
+        BitmapRGBA8 opaque,transparent;
+
+        CM2D_CHECK(LoadTGAFixture(MakeTGAWithColorMap(TGA_IMAGE_TYPE_COLOR_MAP,8,index,16,0),&opaque));
+        CM2D_CHECK(LoadTGAFixture(MakeTGAWithColorMap(TGA_IMAGE_TYPE_COLOR_MAP,8,index,16,1),&transparent));
+
+        if(opaque.IsEmpty()||transparent.IsEmpty())return;
+
+        for(uint y=0;y<FIXTURE_HEIGHT;y++)
+            for(uint x=0;x<FIXTURE_WIDTH;x++)
+            {
+                CM2D_CHECK((*opaque.GetData(x,y))[3]==255);
+                CM2D_CHECK((*transparent.GetData(x,y))[3]==0);
+            }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestMappedSkips15BitColorMap();
+    TestStreamLoad15BitColorMap();
+    TestStreamLoad16BitColorMapAlpha();
+
+    return CM2D_TEST_RESULT();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include<stdio.h>
+
+/**
+ * CM2D单元测试公用定义
+ *
+ * 每个测试程序都是独立的可执行文件，检查失败时打印位置并计数，main返回失败数，为0即通过。
+ */
+namespace hgl
+{
+    namespace bitmap
+    {
+        namespace test
+        {
+            inline int &FailCount()
+            {
+                static int count=0;
+
+                return count;
+            }
+        }//namespace test
+    }//namespace bitmap
+}//namespace hgl
+
+#define CM2D_CHECK(expr)    do{if(!(expr)){fprintf(stderr,"%s:%d: CHECK failed: %s\n",__FILE__,__LINE__,#expr);++hgl::bitmap::test::FailCount();}}while(0)
+
+#define CM2D_TEST_RESULT()  (hgl::bitmap::test::FailCount()?(fprintf(stderr,"%d check(s) failed\n",hgl::bitmap::test::FailCount()),1):0)
@@ -0,0 +1,68 @@
+#include"TestCommon.h"
+#include<hgl/2d/TiledBitmap.h>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+
+namespace
+{
+    constexpr int TS=TILED_BITMAP_TILE_SIZE;
+
+    /**
+     * 在每个分块写入不同的值再读回，各种形状下分块编号都不能重叠
+     */
+    void TestTileIndexUnique(const int cols,const int rows)
+    {
+        TiledBitmapU32 tb;
+
+        CM2D_CHECK(tb.Create(cols*TS,rows*TS,0,true));
+        CM2D_CHECK(tb.GetTileCols()==cols&&tb.GetTileRows()==rows);
+
+        for(int ty=0;ty<rows;ty++)
+            for(int tx=0;tx<cols;tx++)
+                *tb.GetData(tx*TS,ty*TS)=uint32(ty*cols+tx+1);
+
+        CM2D_CHECK(tb.GetResidentTileCount()==uint(cols*rows));
+
+        for(int ty=0;ty<rows;ty++)
+            for(int tx=0;tx<cols;tx++)
+                CM2D_CHECK(tb.GetPixel(tx*TS,ty*TS)==uint32(ty*cols+tx+1));
+
+        for(uint level=1;level<tb.GetLevelCount();level++)              //各级mipmap都能生成，且不越界
+            tb.GetMipPixel(level,0,0);
+    }
+
+    /**
+     * 细长的图片不能按整个Morton正方形分配分块表
+     */
+    void TestStripTiles()
+    {
+        constexpr int STRIP_COLS=65536;
+
+        TiledBitmapU32 tb;
+
+        CM2D_CHECK(tb.Create(STRIP_COLS*TS,1,0));
+
+        *tb.GetData(0,0)=1;
+        *tb.GetData((STRIP_COLS-1)*TS,0)=2;
+
+        CM2D_CHECK(tb.GetPixel(0,0)==1);
+        CM2D_CHECK(tb.GetPixel((STRIP_COLS-1)*TS,0)==2);
+        CM2D_CHECK(tb.GetPixel(TS,0)==0);
+        CM2D_CHECK(tb.GetResidentTileCount()==2);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestTileIndexUnique(1,1);
+    TestTileIndexUnique(5,3);
+    TestTileIndexUnique(3,5);
+    TestTileIndexUnique(8,8);
+    TestTileIndexUnique(37,2);
+    TestTileIndexUnique(1,29);
+
+    TestStripTiles();
+
+    return CM2D_TEST_RESULT();
+}
@@ -0,0 +1,54 @@
+#include"TestCommon.h"
+#include<hgl/2d/VSBase.h>
+#include<hgl/2d/DrawGeometry.h>
+
+using namespace hgl;
+using namespace hgl::bitmap;
+using namespace hgl::vs;
+
+namespace
+{
+    constexpr uint SURFACE_HEIGHT   =3;
+    constexpr uint MAX_WIDTH        =256;
+
+    /**
+     * 以指定格式创建各种宽度的交错布局数据，行跨度须为整数个象素，才能以位图视图访问并绘制
+     */
+    template<typename T,uint C>
+    void TestInterleavedBitmapView(const DataFormat df,const T &color)
+    {
+        for(uint w=1;w<=MAX_WIDTH;w++)
+        {
+            VSData vd;
+
+            CM2D_CHECK(vd.Create(w,SURFACE_HEIGHT,C,df));
+            CM2D_CHECK(vd.GetLineBytes()%VS_LINE_ALIGN==0);
+            CM2D_CHECK(vd.GetLineBytes()%sizeof(T)==0);
+
+            BitmapView<T,C> bv=vd.GetBitmapView<T,C>();
+
+            CM2D_CHECK(!bv.IsEmpty());
+
+            if(bv.IsEmpty())continue;
+
+            DrawGeometry<T,BitmapView<T,C>,BlendPolicyOpaque<T>> dg(&bv);
+
+            dg.SetDrawColor(color);
+            CM2D_CHECK(dg.DrawBar(0,0,w,SURFACE_HEIGHT));
+
+            for(uint y=0;y<SURFACE_HEIGHT;y++)
+            {
+                CM2D_CHECK(*(const T *)vd.GetPointer(0,y)==color);
+                CM2D_CHECK(*(const T *)vd.GetPointer(w-1,y)==color);
+            }
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestInterleavedBitmapView<Vector3u8,3>(DataFormat::U8,Vector3u8(1,2,3));
+    TestInterleavedBitmapView<Vector3u16,3>(DataFormat::U16,Vector3u16(1000,2000,3000));
+
+    return CM2D_TEST_RESULT();
+}